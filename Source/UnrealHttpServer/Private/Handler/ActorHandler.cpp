@@ -0,0 +1,447 @@
+#include "Handler/ActorHandler.h"
+#include "Log.h"
+#include "Service/ActorIndexService.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "GameFramework/Actor.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		/**
+		 * Projectable actor fields
+		 */
+		enum EActorField : uint32
+		{
+			Field_Name = 1 << 0,
+			Field_Class = 1 << 1,
+			Field_Location = 1 << 2,
+			Field_Rotation = 1 << 3,
+			Field_Scale = 1 << 4,
+			Field_Tags = 1 << 5,
+			Field_Id = 1 << 6,
+		};
+
+		const uint32 DEFAULT_ACTOR_FIELDS = Field_Name | Field_Class | Field_Location;
+
+		/**
+		 * Actor fields copied on game thread, serialized on worker thread
+		 */
+		struct FActorRecord
+		{
+			uint32 Id;
+			FString Name;
+			FString Class;
+			FVector Location;
+			FRotator Rotation;
+			FVector Scale;
+			TArray<FString> Tags;
+		};
+
+		/**
+		 * Actor query parsed on worker thread, class is resolved on game thread
+		 */
+		struct FParsedActorQuery
+		{
+			FActorQuery Query;
+			FString ClassName;
+			uint32 Fields = DEFAULT_ACTOR_FIELDS;
+		};
+
+		bool ReadVector(const TSharedPtr<FJsonObject>& Object, FVector& OutVector)
+		{
+			double X, Y, Z;
+			if (!Object.IsValid() || !Object->TryGetNumberField(TEXT("x"), X) || !Object->TryGetNumberField(TEXT("y"), Y) || !Object->TryGetNumberField(TEXT("z"), Z))
+			{
+				return false;
+			}
+			OutVector = FVector(X, Y, Z);
+			return true;
+		}
+
+		void WriteVector(FBodyWriter& Writer, const TCHAR* Name, const FVector& Vector)
+		{
+			Writer.WriteIdentifier(Name);
+			Writer.WriteObjectStart(3);
+			Writer.WriteIdentifier(TEXT("x"));
+			Writer.WriteValue((double)Vector.X);
+			Writer.WriteIdentifier(TEXT("y"));
+			Writer.WriteValue((double)Vector.Y);
+			Writer.WriteIdentifier(TEXT("z"));
+			Writer.WriteValue((double)Vector.Z);
+			Writer.WriteObjectEnd();
+		}
+
+		void WriteRotator(FBodyWriter& Writer, const TCHAR* Name, const FRotator& Rotator)
+		{
+			Writer.WriteIdentifier(Name);
+			Writer.WriteObjectStart(3);
+			Writer.WriteIdentifier(TEXT("pitch"));
+			Writer.WriteValue((double)Rotator.Pitch);
+			Writer.WriteIdentifier(TEXT("yaw"));
+			Writer.WriteValue((double)Rotator.Yaw);
+			Writer.WriteIdentifier(TEXT("roll"));
+			Writer.WriteValue((double)Rotator.Roll);
+			Writer.WriteObjectEnd();
+		}
+
+		bool ReadRotator(const TSharedPtr<FJsonObject>& Object, FRotator& OutRotator)
+		{
+			double Pitch, Yaw, Roll;
+			if (!Object.IsValid() || !Object->TryGetNumberField(TEXT("pitch"), Pitch) || !Object->TryGetNumberField(TEXT("yaw"), Yaw) || !Object->TryGetNumberField(TEXT("roll"), Roll))
+			{
+				return false;
+			}
+			OutRotator = FRotator(Pitch, Yaw, Roll);
+			return true;
+		}
+
+		/**
+		 * Read actor id from path, outputs error message on failure
+		 */
+		bool GetActorId(const FPathParams& Params, uint32& OutId, FString& OutMessage)
+		{
+			int64 Id;
+			if (!Params.GetInt(TEXT("id"), Id) || Id < 0 || Id > MAX_uint32)
+			{
+				OutMessage = TEXT("Invalid actor id!");
+				return false;
+			}
+			OutId = (uint32)Id;
+			return true;
+		}
+
+		/**
+		 * Parse query body, outputs error message on failure
+		 */
+		bool ParseActorQuery(const TSharedPtr<FJsonObject>& Body, int32 DefaultLimit, int32 MaxLimit, FParsedActorQuery& OutParsed, FString& OutMessage)
+		{
+			FActorQuery& Query = OutParsed.Query;
+			Body->TryGetStringField(TEXT("class"), OutParsed.ClassName);
+			FString Tag;
+			if (Body->TryGetStringField(TEXT("tag"), Tag) && !Tag.IsEmpty())
+			{
+				Query.Tag = FName(*Tag);
+			}
+
+			const TSharedPtr<FJsonObject>* Sphere;
+			if (Body->TryGetObjectField(TEXT("sphere"), Sphere))
+			{
+				double Radius;
+				if (!ReadVector(*Sphere, Query.SphereCenter) || !(*Sphere)->TryGetNumberField(TEXT("radius"), Radius) || Radius < 0)
+				{
+					OutMessage = TEXT("Invalid sphere, requires x, y, z & non-negative radius!");
+					return false;
+				}
+				Query.bHasSphere = true;
+				Query.SphereRadius = Radius;
+			}
+
+			const TSharedPtr<FJsonObject>* Box;
+			if (Body->TryGetObjectField(TEXT("box"), Box))
+			{
+				const TSharedPtr<FJsonObject>* Min;
+				const TSharedPtr<FJsonObject>* Max;
+				FVector MinVector, MaxVector;
+				if (!(*Box)->TryGetObjectField(TEXT("min"), Min) || !(*Box)->TryGetObjectField(TEXT("max"), Max)
+					|| !ReadVector(*Min, MinVector) || !ReadVector(*Max, MaxVector))
+				{
+					OutMessage = TEXT("Invalid box, requires min & max vectors!");
+					return false;
+				}
+				Query.bHasBox = true;
+				Query.Box = FBox(MinVector.ComponentMin(MaxVector), MinVector.ComponentMax(MaxVector));
+			}
+
+			const TArray<TSharedPtr<FJsonValue>>* FieldValues;
+			if (Body->TryGetArrayField(TEXT("fields"), FieldValues))
+			{
+				static const TMap<FString, uint32> FieldNames = {
+					{ TEXT("id"), Field_Id },
+					{ TEXT("name"), Field_Name },
+					{ TEXT("class"), Field_Class },
+					{ TEXT("location"), Field_Location },
+					{ TEXT("rotation"), Field_Rotation },
+					{ TEXT("scale"), Field_Scale },
+					{ TEXT("tags"), Field_Tags },
+				};
+				OutParsed.Fields = 0;
+				for (const TSharedPtr<FJsonValue>& FieldValue : *FieldValues)
+				{
+					FString FieldName;
+					const uint32* Field = FieldValue->TryGetString(FieldName) ? FieldNames.Find(FieldName) : nullptr;
+					if (Field == nullptr)
+					{
+						OutMessage = FString::Printf(TEXT("Unknown actor field: %s"), *FieldName);
+						return false;
+					}
+					OutParsed.Fields |= *Field;
+				}
+			}
+
+			int32 Offset = 0;
+			int32 Limit = DefaultLimit;
+			Body->TryGetNumberField(TEXT("offset"), Offset);
+			Body->TryGetNumberField(TEXT("limit"), Limit);
+			Query.Offset = FMath::Max(0, Offset);
+			Query.Limit = FMath::Clamp(Limit, 0, MaxLimit);
+			return true;
+		}
+	}
+
+	const TCHAR* const FActorHandler::ROUTE = TEXT("/actors");
+
+	const TCHAR* const FActorHandler::TRANSFORM_ROUTE = TEXT("/actors/{id:int}/transform");
+
+	void FActorHandler::QueryActors(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+	{
+		FWebUtil::RunOnWorkerThread([Request, Respond]()
+		{
+			// parse query on worker thread
+			TSharedPtr<FJsonObject> RequestBody = FWebUtil::GetRequestJsonBody(*Request);
+			if (RequestBody == nullptr)
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Failed to parse request body to json!")));
+				return;
+			}
+			FParsedActorQuery Parsed;
+			FString Message;
+			if (!ParseActorQuery(RequestBody, DEFAULT_QUERY_LIMIT, MAX_QUERY_LIMIT, Parsed, Message))
+			{
+				Respond(FWebUtil::ErrorResponse(Message));
+				return;
+			}
+			RequestBody.Reset();
+
+			// query index & copy projected fields on game thread
+			FWebUtil::RunOnGameThread([Parsed = MoveTemp(Parsed), Respond]() mutable
+			{
+				if (!Parsed.ClassName.IsEmpty())
+				{
+					Parsed.Query.Class = FindObject<UClass>(ANY_PACKAGE, *Parsed.ClassName);
+					if (Parsed.Query.Class == nullptr || !Parsed.Query.Class->IsChildOf(AActor::StaticClass()))
+					{
+						Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Unknown actor class: %s"), *Parsed.ClassName)));
+						return;
+					}
+				}
+				TArray<AActor*> Actors;
+				int32 Total = FActorIndexService::Query(Parsed.Query, Actors);
+
+				uint32 Fields = Parsed.Fields;
+				TArray<FActorRecord> Records;
+				Records.SetNum(Actors.Num());
+				for (int32 Index = 0; Index < Actors.Num(); ++Index)
+				{
+					AActor* Actor = Actors[Index];
+					FActorRecord& Record = Records[Index];
+					Record.Id = FActorIndexService::GetActorId(Actor);
+					if (Fields & Field_Name)
+					{
+						Record.Name = Actor->GetName();
+					}
+					if (Fields & Field_Class)
+					{
+						Record.Class = Actor->GetClass()->GetName();
+					}
+					if (Fields & (Field_Location | Field_Rotation | Field_Scale))
+					{
+						const FTransform& Transform = Actor->GetActorTransform();
+						Record.Location = Transform.GetLocation();
+						Record.Rotation = Transform.Rotator();
+						Record.Scale = Transform.GetScale3D();
+					}
+					if (Fields & Field_Tags)
+					{
+						for (const FName& Tag : Actor->Tags)
+						{
+							Record.Tags.Add(Tag.ToString());
+						}
+					}
+				}
+
+				// serialize on worker thread
+				int32 Offset = Parsed.Query.Offset;
+				FWebUtil::RunOnWorkerThread([Records = MoveTemp(Records), Total, Offset, Fields, Respond]()
+				{
+					const int32 NumFields = FMath::CountBits(Fields);
+					Respond(FWebUtil::SuccessResponse([&Records, Total, Offset, Fields, NumFields](FBodyWriter& Writer)
+					{
+						Writer.WriteObjectStart(4);
+						Writer.WriteIdentifier(TEXT("total"));
+						Writer.WriteValue((double)Total);
+						Writer.WriteIdentifier(TEXT("offset"));
+						Writer.WriteValue((double)Offset);
+						Writer.WriteIdentifier(TEXT("count"));
+						Writer.WriteValue((double)Records.Num());
+						Writer.WriteIdentifier(TEXT("actors"));
+						Writer.WriteArrayStart(Records.Num());
+						for (const FActorRecord& Record : Records)
+						{
+							Writer.WriteObjectStart(NumFields);
+							if (Fields & Field_Id)
+							{
+								Writer.WriteIdentifier(TEXT("id"));
+								Writer.WriteValue((double)Record.Id);
+							}
+							if (Fields & Field_Name)
+							{
+								Writer.WriteIdentifier(TEXT("name"));
+								Writer.WriteValue(Record.Name);
+							}
+							if (Fields & Field_Class)
+							{
+								Writer.WriteIdentifier(TEXT("class"));
+								Writer.WriteValue(Record.Class);
+							}
+							if (Fields & Field_Location)
+							{
+								WriteVector(Writer, TEXT("location"), Record.Location);
+							}
+							if (Fields & Field_Rotation)
+							{
+								WriteRotator(Writer, TEXT("rotation"), Record.Rotation);
+							}
+							if (Fields & Field_Scale)
+							{
+								WriteVector(Writer, TEXT("scale"), Record.Scale);
+							}
+							if (Fields & Field_Tags)
+							{
+								Writer.WriteIdentifier(TEXT("tags"));
+								Writer.WriteArrayStart(Record.Tags.Num());
+								for (const FString& Tag : Record.Tags)
+								{
+									Writer.WriteValue(Tag);
+								}
+								Writer.WriteArrayEnd();
+							}
+							Writer.WriteObjectEnd();
+						}
+						Writer.WriteArrayEnd();
+						Writer.WriteObjectEnd();
+					}, Records.Num() * NumFields * 48));
+				});
+			});
+		});
+	}
+
+	TUniquePtr<FHttpServerResponse> FActorHandler::GetActorTransform(const FHttpServerRequest& Request, const FPathParams& Params)
+	{
+		uint32 Id;
+		FString Message;
+		if (!GetActorId(Params, Id, Message))
+		{
+			return FWebUtil::ErrorResponse(Message);
+		}
+		AActor* Actor = FActorIndexService::FindActor(Id);
+		if (Actor == nullptr)
+		{
+			return FWebUtil::ErrorResponse(FString::Printf(TEXT("Actor not found: %u"), Id), static_cast<int32>(EHttpServerResponseCodes::NotFound));
+		}
+		const FTransform& Transform = Actor->GetActorTransform();
+		return FWebUtil::SuccessResponse([Id, &Transform](FBodyWriter& Writer)
+		{
+			Writer.WriteObjectStart(4);
+			Writer.WriteIdentifier(TEXT("id"));
+			Writer.WriteValue((double)Id);
+			WriteVector(Writer, TEXT("location"), Transform.GetLocation());
+			WriteRotator(Writer, TEXT("rotation"), Transform.Rotator());
+			WriteVector(Writer, TEXT("scale"), Transform.GetScale3D());
+			Writer.WriteObjectEnd();
+		}, 256);
+	}
+
+	void FActorHandler::SetActorTransform(const FHttpServerRequestRef& Request, const FPathParams& Params, const FHttpResponseCallback& Respond)
+	{
+		uint32 Id;
+		FString Message;
+		if (!GetActorId(Params, Id, Message))
+		{
+			Respond(FWebUtil::ErrorResponse(Message));
+			return;
+		}
+		FWebUtil::RunOnWorkerThread([Request, Respond, Id]()
+		{
+			// parse transform on worker thread, omitted parts are kept
+			TSharedPtr<FJsonObject> RequestBody = FWebUtil::GetRequestJsonBody(*Request);
+			if (RequestBody == nullptr)
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Failed to parse request body to json!")));
+				return;
+			}
+			const TSharedPtr<FJsonObject>* Object;
+			TOptional<FVector> Location;
+			TOptional<FRotator> Rotation;
+			TOptional<FVector> Scale;
+			FVector Vector;
+			FRotator Rotator;
+			if (RequestBody->TryGetObjectField(TEXT("location"), Object))
+			{
+				if (!ReadVector(*Object, Vector))
+				{
+					Respond(FWebUtil::ErrorResponse(TEXT("Invalid location, requires x, y, z!")));
+					return;
+				}
+				Location = Vector;
+			}
+			if (RequestBody->TryGetObjectField(TEXT("rotation"), Object))
+			{
+				if (!ReadRotator(*Object, Rotator))
+				{
+					Respond(FWebUtil::ErrorResponse(TEXT("Invalid rotation, requires pitch, yaw, roll!")));
+					return;
+				}
+				Rotation = Rotator;
+			}
+			if (RequestBody->TryGetObjectField(TEXT("scale"), Object))
+			{
+				if (!ReadVector(*Object, Vector))
+				{
+					Respond(FWebUtil::ErrorResponse(TEXT("Invalid scale, requires x, y, z!")));
+					return;
+				}
+				Scale = Vector;
+			}
+			if (!Location.IsSet() && !Rotation.IsSet() && !Scale.IsSet())
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Requires location, rotation or scale!")));
+				return;
+			}
+
+			// same-frame writes of an actor are coalesced like player setters
+			FString Key = FString::Printf(TEXT("%s|%u"), TRANSFORM_ROUTE, Id);
+			bool bQueued = FWebUtil::EnqueueCoalescedMutation(Key, [Respond, Id, Location, Rotation, Scale]()
+			{
+				AActor* Actor = FActorIndexService::FindActor(Id);
+				if (Actor == nullptr)
+				{
+					Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Actor not found: %u"), Id), static_cast<int32>(EHttpServerResponseCodes::NotFound)));
+					return;
+				}
+				FTransform Transform = Actor->GetActorTransform();
+				if (Location.IsSet())
+				{
+					Transform.SetLocation(Location.GetValue());
+				}
+				if (Rotation.IsSet())
+				{
+					Transform.SetRotation(Rotation.GetValue().Quaternion());
+				}
+				if (Scale.IsSet())
+				{
+					Transform.SetScale3D(Scale.GetValue());
+				}
+				Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+				Respond(FWebUtil::SuccessResponse(TEXT("Actor transform is set")));
+			}, [Respond]()
+			{
+				Respond(FWebUtil::CoalescedResponse());
+			});
+			if (!bQueued)
+			{
+				Respond(FWebUtil::TooManyRequestsResponse());
+			}
+		});
+	}
+}
\ No newline at end of file
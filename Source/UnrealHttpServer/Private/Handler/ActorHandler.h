@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Runtime/Online/HTTPServer/Public/HttpResultCallback.h"
+#include "Util/WebUtil.h"
+#include "Util/PathRouter.h"
+
+namespace UnrealHttpServer
+{
+	class FActorHandler
+	{
+	public:
+		/**
+		 * Query actors of game world by class, tag, sphere or box, with field projection & pagination
+		 * Body: { "class": "StaticMeshActor", "tag": "Enemy", "sphere": { "x", "y", "z", "radius" },
+		 *         "box": { "min": { "x", "y", "z" }, "max": { "x", "y", "z" } },
+		 *         "fields": ["id", "name", "class", "location", "rotation", "scale", "tags"], "offset": 0, "limit": 100 }
+		 */
+		static void QueryActors(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond);
+
+		/* Prefix of per-actor routes, dispatched by path router */
+		static const TCHAR* const ROUTE;
+
+		/* Pattern of actor transform route, id is index id of actor (see query field "id") */
+		static const TCHAR* const TRANSFORM_ROUTE;
+
+		/**
+		 * Get actor transform, GET /actors/{id:int}/transform
+		 */
+		static TUniquePtr<FHttpServerResponse> GetActorTransform(const FHttpServerRequest& Request, const FPathParams& Params);
+
+		/**
+		 * Set actor transform through the mutation queue, PUT /actors/{id:int}/transform
+		 * Body: { "location": { "x", "y", "z" }, "rotation": { "pitch", "yaw", "roll" }, "scale": { "x", "y", "z" } }, all optional
+		 */
+		static void SetActorTransform(const FHttpServerRequestRef& Request, const FPathParams& Params, const FHttpResponseCallback& Respond);
+
+	private:
+		/* Default & max actors count in one page */
+		static const int32 DEFAULT_QUERY_LIMIT = 100;
+		static const int32 MAX_QUERY_LIMIT = 10000;
+	};
+}
\ No newline at end of file
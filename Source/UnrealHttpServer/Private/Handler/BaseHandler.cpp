@@ -1,17 +1,17 @@
 #include "Handler/BaseHandler.h"
 #include "Util/WebUtil.h"
-#include "Engine.h"
-#include "Log.h"
+#include "Util/RouteMetrics.h"
+#include "Util/StartupTiming.h"
 
 namespace UnrealHttpServer
 {
 	TUniquePtr<FHttpServerResponse> FBaseHandler::HealthCheck(const FHttpServerRequest& Request)
 	{
-		UE_LOG(UHttpLog, Log, TEXT("Health Check"));
-		if (GEngine != nullptr)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Green, TEXT("Health Check Successfully!"));
-		}
 		return FWebUtil::SuccessResponse("Health Check Successfully!");
 	}
+
+	TUniquePtr<FHttpServerResponse> FBaseHandler::Metrics(const FHttpServerRequest& Request)
+	{
+		return FHttpServerResponse::Create(FRouteMetrics::ExportPrometheusText() + FStartupTiming::ExportPrometheusText(), TEXT("text/plain; version=0.0.4; charset=utf-8"));
+	}
 }
\ No newline at end of file
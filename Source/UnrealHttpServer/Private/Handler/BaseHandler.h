@@ -13,6 +13,11 @@ namespace UnrealHttpServer
 		 */
 		static TUniquePtr<FHttpServerResponse> HealthCheck(const FHttpServerRequest& Request);
 
+		/**
+		 * Route metrics in Prometheus text format
+		 */
+		static TUniquePtr<FHttpServerResponse> Metrics(const FHttpServerRequest& Request);
+
 
 	};
 }
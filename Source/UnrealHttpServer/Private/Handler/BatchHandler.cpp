@@ -0,0 +1,143 @@
+#include "Handler/BatchHandler.h"
+#include "Handler/PlayerHandler.h"
+#include "Handler/WorldHandler.h"
+#include "Log.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		/**
+		 * Parsed batch operation
+		 */
+		struct FBatchOperation
+		{
+			FString Name;
+			TSharedPtr<FJsonObject> Params;
+		};
+	}
+
+	void FBatchHandler::ExecuteBatch(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+	{
+		FWebUtil::RunOnWorkerThread([Request, Respond]()
+		{
+			// parse batch body on worker thread
+			TSharedPtr<FJsonObject> RequestBody = FWebUtil::GetRequestJsonBody(*Request);
+			if (RequestBody == nullptr)
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Failed to parse request body to json!")));
+				return;
+			}
+			FString Mode = TEXT("stop_on_error");
+			RequestBody->TryGetStringField(TEXT("mode"), Mode);
+			if (Mode != TEXT("stop_on_error") && Mode != TEXT("continue_on_error"))
+			{
+				Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Invalid batch mode: %s"), *Mode)));
+				return;
+			}
+			bool bStopOnError = Mode == TEXT("stop_on_error");
+
+			const TArray<TSharedPtr<FJsonValue>>* OperationValues;
+			if (!RequestBody->TryGetArrayField(TEXT("operations"), OperationValues))
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Missing operations array!")));
+				return;
+			}
+			if (OperationValues->Num() > MAX_BATCH_OPERATIONS)
+			{
+				Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Too many operations, max: %d"), MAX_BATCH_OPERATIONS)));
+				return;
+			}
+
+			// validate all operations before touching the game thread
+			TArray<FBatchOperation> Operations;
+			Operations.Reserve(OperationValues->Num());
+			for (int32 Index = 0; Index < OperationValues->Num(); ++Index)
+			{
+				const TSharedPtr<FJsonObject>* OperationObject;
+				FBatchOperation Operation;
+				if (!(*OperationValues)[Index]->TryGetObject(OperationObject) || !(*OperationObject)->TryGetStringField(TEXT("op"), Operation.Name))
+				{
+					Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Invalid operation at index %d!"), Index)));
+					return;
+				}
+				if (FindOperation(Operation.Name) == nullptr)
+				{
+					Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Unknown operation at index %d: %s"), Index, *Operation.Name)));
+					return;
+				}
+				const TSharedPtr<FJsonObject>* Params;
+				if ((*OperationObject)->TryGetObjectField(TEXT("params"), Params))
+				{
+					Operation.Params = *Params;
+				}
+				Operations.Add(MoveTemp(Operation));
+			}
+			// release the request dom on this thread, so that params are only owned by the operations moved to game thread
+			RequestBody.Reset();
+
+			// execute operations in one pass of the mutation queue
+			bool bQueued = FWebUtil::EnqueueMutation([Operations = MoveTemp(Operations), bStopOnError, Respond]()
+			{
+				TArray<TSharedPtr<FJsonValue>> Results;
+				Results.Reserve(Operations.Num());
+				int32 FailedCount = 0;
+				for (const FBatchOperation& Operation : Operations)
+				{
+					TSharedPtr<FJsonObject> Data;
+					FString Message;
+					bool bSuccess = (*FindOperation(Operation.Name))(Operation.Params, Data, Message);
+
+					TSharedPtr<FJsonObject> Result = MakeShareable(new FJsonObject());
+					Result->SetStringField(TEXT("op"), Operation.Name);
+					Result->SetBoolField(TEXT("success"), bSuccess);
+					Result->SetStringField(TEXT("message"), Message);
+					Result->SetObjectField(TEXT("data"), Data.IsValid() ? Data : MakeShareable(new FJsonObject()));
+					Results.Add(MakeShareable(new FJsonValueObject(Result)));
+					if (!bSuccess)
+					{
+						++FailedCount;
+						if (bStopOnError)
+						{
+							break;
+						}
+					}
+				}
+
+				TSharedPtr<FJsonObject> Body = MakeShareable(new FJsonObject());
+				Body->SetArrayField(TEXT("results"), Results);
+				Body->SetNumberField(TEXT("executed"), Results.Num());
+				Body->SetNumberField(TEXT("failed"), FailedCount);
+				if (FailedCount > 0)
+				{
+					Respond(FWebUtil::ErrorResponse(Body, FString::Printf(TEXT("%d of %d operations failed!"), FailedCount, Results.Num())));
+					return;
+				}
+				Respond(FWebUtil::SuccessResponse(Body));
+			});
+			if (!bQueued)
+			{
+				Respond(FWebUtil::TooManyRequestsResponse());
+			}
+		});
+	}
+
+	const FJsonOperation* FBatchHandler::FindOperation(const FString& Name)
+	{
+		return GetOperations().Find(Name);
+	}
+
+	const TMap<FString, FJsonOperation>& FBatchHandler::GetOperations()
+	{
+		static const TMap<FString, FJsonOperation> Operations = {
+			{ TEXT("player.get_location"), FWebUtil::CreateTypedOperation<FUHttpPlayerTarget, FUHttpPlayerLocation>(&FPlayerHandler::GetPlayerLocation) },
+			{ TEXT("player.set_location"), FWebUtil::CreateTypedOperation<FUHttpSetPlayerLocationRequest, FUHttpEmpty>(&FPlayerHandler::SetPlayerLocation) },
+			{ TEXT("player.get_rotation"), FWebUtil::CreateTypedOperation<FUHttpPlayerTarget, FUHttpPlayerRotation>(&FPlayerHandler::GetPlayerRotation) },
+			{ TEXT("player.set_rotation"), FWebUtil::CreateTypedOperation<FUHttpSetPlayerRotationRequest, FUHttpEmpty>(&FPlayerHandler::SetPlayerRotation) },
+			{ TEXT("world.capture_snapshot"), FWebUtil::CreateTypedOperation<FUHttpCaptureSnapshotRequest, FUHttpSnapshotInfo>(&FWorldHandler::CaptureSnapshot) },
+			{ TEXT("world.restore_snapshot"), FWebUtil::CreateTypedOperation<FUHttpSnapshotRequest, FUHttpRestoreSnapshotResponse>(&FWorldHandler::RestoreSnapshot) },
+		};
+		return Operations;
+	}
+}
\ No newline at end of file
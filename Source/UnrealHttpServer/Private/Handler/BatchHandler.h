@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Runtime/Online/HTTPServer/Public/HttpResultCallback.h"
+#include "Util/WebUtil.h"
+
+namespace UnrealHttpServer
+{
+	class FBatchHandler
+	{
+	public:
+		/**
+		 * Execute batch operations in one game thread pass
+		 * Body: { "mode": "stop_on_error" | "continue_on_error", "operations": [{ "op": "player.set_location", "params": {...} }] }
+		 */
+		static void ExecuteBatch(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond);
+
+		/**
+		 * Find a registered operation by name, returns nullptr if not found
+		 */
+		static const FJsonOperation* FindOperation(const FString& Name);
+
+	private:
+		/* Max operations count in one batch, to bound the game thread cost of a single request */
+		static const int32 MAX_BATCH_OPERATIONS = 1024;
+
+		/**
+		 * Get operations that can be executed in batch, keyed by operation name
+		 */
+		static const TMap<FString, FJsonOperation>& GetOperations();
+	};
+}
\ No newline at end of file
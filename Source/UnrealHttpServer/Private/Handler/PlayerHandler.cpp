@@ -2,90 +2,240 @@
 #include "Log.h"
 #include "Util/WebUtil.h"
 #include "Service/PlayerService.h"
-#include "Runtime/JsonUtilities/Public/JsonObjectConverter.h"
+#include "Service/TransformFeedService.h"
+#include "Service/TransformHistoryService.h"
 #include "GameFramework/Pawn.h"
 
 namespace UnrealHttpServer
 {
-	TUniquePtr<FHttpServerResponse> FPlayerHandler::GetPlayerLocation(const FHttpServerRequest& Request)
+	bool FPlayerHandler::GetPlayerLocation(const FUHttpPlayerTarget& Request, FUHttpPlayerLocation& OutResponse, FString& OutMessage)
 	{
-		APawn* PlayerPawn = FPlayerService::GetPlayerPawn();
+		APawn* PlayerPawn = GetTargetPawn(Request, OutMessage);
 		if (PlayerPawn == nullptr)
 		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to get valid player pawn instance!"));
+			return false;
 		}
 		FVector PlayerLocation = PlayerPawn->GetActorLocation();
-		TSharedPtr<FJsonObject> Body = MakeShareable(new FJsonObject());
-		Body->SetNumberField(TEXT("x"), PlayerLocation.X);
-		Body->SetNumberField(TEXT("y"), PlayerLocation.Y);
-		Body->SetNumberField(TEXT("z"), PlayerLocation.Z);
-		return FWebUtil::SuccessResponse(Body);
+		OutResponse.X = PlayerLocation.X;
+		OutResponse.Y = PlayerLocation.Y;
+		OutResponse.Z = PlayerLocation.Z;
+		return true;
 	}
 
-	TUniquePtr<FHttpServerResponse> FPlayerHandler::SetPlayerLocation(const FHttpServerRequest& Request)
+	bool FPlayerHandler::SetPlayerLocation(const FUHttpSetPlayerLocationRequest& Request, FUHttpEmpty& OutResponse, FString& OutMessage)
 	{
-		// get request json and player pawn
-		TSharedPtr<FJsonObject> RequestBody = FWebUtil::GetRequestJsonBody(Request);
-		if (RequestBody == nullptr)
-		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to parse request body to json!"));
-		}
-		APawn* PlayerPawn = FPlayerService::GetPlayerPawn();
+		APawn* PlayerPawn = GetTargetPawn(Request, OutMessage);
 		if (PlayerPawn == nullptr)
 		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to get valid player pawn instance!"));
+			return false;
 		}
-		// set new location
-		FVector NewLocation;
-		NewLocation.X = RequestBody->GetNumberField(TEXT("x"));
-		NewLocation.Y = RequestBody->GetNumberField(TEXT("y"));
-		NewLocation.Z = RequestBody->GetNumberField(TEXT("z"));
-		UE_LOG(UHttpLog, Log, TEXT("Set player new location to (%.2f, %.2f, %.2f)"), NewLocation.X, NewLocation.Y, NewLocation.Z);
+		FVector NewLocation(Request.X, Request.Y, Request.Z);
 		if (!PlayerPawn->SetActorLocation(NewLocation, false, nullptr, ETeleportType::ResetPhysics))
 		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to set player location!"));
+			OutMessage = TEXT("Failed to set player location!");
+			return false;
 		}
-		return FWebUtil::SuccessResponse(TEXT("Player location set successfully!"));
+		OutMessage = TEXT("Player location set successfully!");
+		return true;
 	}
 
-	TUniquePtr<FHttpServerResponse> FPlayerHandler::GetPlayerRotation(const FHttpServerRequest& Request)
+	bool FPlayerHandler::GetPlayerRotation(const FUHttpPlayerTarget& Request, FUHttpPlayerRotation& OutResponse, FString& OutMessage)
 	{
-		APawn* PlayerPawn = FPlayerService::GetPlayerPawn();
+		APawn* PlayerPawn = GetTargetPawn(Request, OutMessage);
 		if (PlayerPawn == nullptr)
 		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to get valid player pawn instance!"));
+			return false;
 		}
 		FRotator PlayerRotation = PlayerPawn->GetActorRotation();
-		TSharedPtr<FJsonObject> Body = MakeShareable(new FJsonObject());
-		Body->SetNumberField(TEXT("pitch"), PlayerRotation.Pitch);
-		Body->SetNumberField(TEXT("yaw"), PlayerRotation.Yaw);
-		Body->SetNumberField(TEXT("roll"), PlayerRotation.Roll);
-		return FWebUtil::SuccessResponse(Body);
+		OutResponse.Pitch = PlayerRotation.Pitch;
+		OutResponse.Yaw = PlayerRotation.Yaw;
+		OutResponse.Roll = PlayerRotation.Roll;
+		return true;
+	}
+
+	bool FPlayerHandler::SetPlayerRotation(const FUHttpSetPlayerRotationRequest& Request, FUHttpEmpty& OutResponse, FString& OutMessage)
+	{
+		APawn* PlayerPawn = GetTargetPawn(Request, OutMessage);
+		if (PlayerPawn == nullptr)
+		{
+			return false;
+		}
+		FRotator NewRotation(Request.Pitch, Request.Yaw, Request.Roll);
+		if (!PlayerPawn->SetActorRotation(NewRotation, ETeleportType::ResetPhysics))
+		{
+			OutMessage = TEXT("Failed to set player rotation!");
+			return false;
+		}
+		OutMessage = TEXT("Player rotation set successfully!");
+		return true;
+	}
+
+	bool FPlayerHandler::GetPublishedPlayerLocation(const FUHttpPlayerTarget& Request, FUHttpPlayerLocation& OutResponse, FString& OutMessage, uint64& OutFrame)
+	{
+		FPublishedPlayer Player;
+		if (!GetPublishedPlayer(Request, Player, OutMessage, OutFrame))
+		{
+			return false;
+		}
+		OutResponse.X = Player.Location.X;
+		OutResponse.Y = Player.Location.Y;
+		OutResponse.Z = Player.Location.Z;
+		return true;
+	}
+
+	bool FPlayerHandler::GetPublishedPlayerRotation(const FUHttpPlayerTarget& Request, FUHttpPlayerRotation& OutResponse, FString& OutMessage, uint64& OutFrame)
+	{
+		FPublishedPlayer Player;
+		if (!GetPublishedPlayer(Request, Player, OutMessage, OutFrame))
+		{
+			return false;
+		}
+		OutResponse.Pitch = Player.Rotation.Pitch;
+		OutResponse.Yaw = Player.Rotation.Yaw;
+		OutResponse.Roll = Player.Rotation.Roll;
+		return true;
+	}
+
+	FString FPlayerHandler::GetTargetKey(const FUHttpPlayerTarget& Target)
+	{
+		return FString::Printf(TEXT("%s#%d"), *Target.World, Target.Player);
+	}
+
+	void FPlayerHandler::WatchPlayerTransform(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+	{
+		uint64 LastSequence = 0;
+		const FString* SequenceParam = Request->QueryParams.Find(TEXT("seq"));
+		if (SequenceParam != nullptr)
+		{
+			if (!SequenceParam->IsNumeric())
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Invalid seq!")));
+				return;
+			}
+			LastSequence = FCString::Strtoui64(**SequenceParam, nullptr, 10);
+		}
+		int32 TimeoutMs = DEFAULT_WATCH_TIMEOUT_MS;
+		const FString* TimeoutParam = Request->QueryParams.Find(TEXT("timeout_ms"));
+		if (TimeoutParam != nullptr)
+		{
+			TimeoutMs = FMath::Clamp(FCString::Atoi(**TimeoutParam), 0, MAX_WATCH_TIMEOUT_MS);
+		}
+		FTransformFeedService::Watch(LastSequence, TimeoutMs / 1000.0, Respond);
 	}
 
-	TUniquePtr<FHttpServerResponse> FPlayerHandler::SetPlayerRotation(const FHttpServerRequest& Request)
+	void FPlayerHandler::GetPlayerHistory(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
 	{
-		// get request json and player pawn
-		TSharedPtr<FJsonObject> RequestBody = FWebUtil::GetRequestJsonBody(Request);
-		if (RequestBody == nullptr)
+		const TMap<FString, FString>& QueryParams = Request->QueryParams;
+		const FString* StepParam = QueryParams.Find(TEXT("step"));
+		const FString* MaxSamplesParam = QueryParams.Find(TEXT("max_samples"));
+		int32 Step = StepParam != nullptr ? FMath::Max(1, FCString::Atoi(**StepParam)) : 1;
+		int32 MaxSamples = MaxSamplesParam != nullptr ? FMath::Clamp(FCString::Atoi(**MaxSamplesParam), 1, MAX_HISTORY_SAMPLES) : DEFAULT_HISTORY_SAMPLES;
+
+		// copy the range on game thread (where the handler is invoked and the ring buffer is written), downsampled to max samples
+		TArray<FTransformSample> Samples;
+		const FString* FromTimeParam = QueryParams.Find(TEXT("from_time"));
+		const FString* ToTimeParam = QueryParams.Find(TEXT("to_time"));
+		if (FromTimeParam != nullptr || ToTimeParam != nullptr)
 		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to parse request body to json!"));
+			double FromTime = FromTimeParam != nullptr ? FCString::Atod(**FromTimeParam) : 0;
+			double ToTime = ToTimeParam != nullptr ? FCString::Atod(**ToTimeParam) : MAX_dbl;
+			int32 Count = FTransformHistoryService::CountByTime(FromTime, ToTime);
+			FTransformHistoryService::QueryByTime(FromTime, ToTime, FMath::Max(Step, FMath::DivideAndRoundUp(Count, MaxSamples)), Samples);
 		}
-		APawn* PlayerPawn = FPlayerService::GetPlayerPawn();
+		else
+		{
+			const FString* FromFrameParam = QueryParams.Find(TEXT("from_frame"));
+			const FString* ToFrameParam = QueryParams.Find(TEXT("to_frame"));
+			uint64 FromFrame = FromFrameParam != nullptr ? FCString::Strtoui64(**FromFrameParam, nullptr, 10) : 0;
+			uint64 ToFrame = ToFrameParam != nullptr ? FCString::Strtoui64(**ToFrameParam, nullptr, 10) : MAX_uint64;
+			int32 Count = FTransformHistoryService::CountByFrame(FromFrame, ToFrame);
+			FTransformHistoryService::QueryByFrame(FromFrame, ToFrame, FMath::Max(Step, FMath::DivideAndRoundUp(Count, MaxSamples)), Samples);
+		}
+
+		// serialize on worker thread
+		FWebUtil::RunOnWorkerThread([Samples = MoveTemp(Samples), Respond]()
+		{
+			static const TCHAR* const Fields[] = {
+				TEXT("frame"), TEXT("time"), TEXT("x"), TEXT("y"), TEXT("z"),
+				TEXT("pitch"), TEXT("yaw"), TEXT("roll"), TEXT("vx"), TEXT("vy"), TEXT("vz")
+			};
+			const int32 NumFields = UE_ARRAY_COUNT(Fields);
+			Respond(FWebUtil::SuccessResponse([&Samples, NumFields](FBodyWriter& Writer)
+			{
+				Writer.WriteObjectStart(3);
+				Writer.WriteIdentifier(TEXT("fields"));
+				Writer.WriteArrayStart(NumFields);
+				for (const TCHAR* Field : Fields)
+				{
+					Writer.WriteValue(Field);
+				}
+				Writer.WriteArrayEnd();
+				Writer.WriteIdentifier(TEXT("count"));
+				Writer.WriteValue((double)Samples.Num());
+				Writer.WriteIdentifier(TEXT("samples"));
+				Writer.WriteArrayStart(Samples.Num() * NumFields);
+				for (const FTransformSample& Sample : Samples)
+				{
+					Writer.WriteValue((double)Sample.Frame);
+					Writer.WriteValue(Sample.Time);
+					Writer.WriteValue((double)Sample.Location.X);
+					Writer.WriteValue((double)Sample.Location.Y);
+					Writer.WriteValue((double)Sample.Location.Z);
+					Writer.WriteValue((double)Sample.Rotation.Pitch);
+					Writer.WriteValue((double)Sample.Rotation.Yaw);
+					Writer.WriteValue((double)Sample.Rotation.Roll);
+					Writer.WriteValue((double)Sample.Velocity.X);
+					Writer.WriteValue((double)Sample.Velocity.Y);
+					Writer.WriteValue((double)Sample.Velocity.Z);
+				}
+				Writer.WriteArrayEnd();
+				Writer.WriteObjectEnd();
+			}, Samples.Num() * NumFields * 12));
+		});
+	}
+
+	/* ================= Private Methods ==================== */
+
+	APawn* FPlayerHandler::GetTargetPawn(const FUHttpPlayerTarget& Target, FString& OutMessage)
+	{
+		FPlayerTarget PlayerTarget;
+		if (!FPlayerService::ParseTarget(Target.World, FString::FromInt(Target.Player), PlayerTarget))
+		{
+			OutMessage = TEXT("Invalid player target!");
+			return nullptr;
+		}
+		APawn* PlayerPawn = FPlayerService::GetPlayerPawn(PlayerTarget);
 		if (PlayerPawn == nullptr)
 		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to get valid player pawn instance!"));
+			OutMessage = TEXT("Failed to get valid player pawn instance!");
+			return nullptr;
 		}
-		// set new rotation
-		FRotator NewRotation;
-		NewRotation.Pitch = RequestBody->GetNumberField("pitch");
-		NewRotation.Yaw = RequestBody->GetNumberField("yaw");
-		NewRotation.Roll = RequestBody->GetNumberField("roll");
-		UE_LOG(UHttpLog, Log, TEXT("Set player new rotation to (pitch: %.2f, yaw: %.2f, roll: %.2f)"), NewRotation.Pitch, NewRotation.Yaw, NewRotation.Roll);
-		if (!PlayerPawn->SetActorRotation(NewRotation, ETeleportType::ResetPhysics))
+		return PlayerPawn;
+	}
+
+	bool FPlayerHandler::GetPublishedPlayer(const FUHttpPlayerTarget& Target, FPublishedPlayer& OutPlayer, FString& OutMessage, uint64& OutFrame)
+	{
+		FPlayerTarget PlayerTarget;
+		if (!FPlayerService::ParseTarget(Target.World, FString::FromInt(Target.Player), PlayerTarget))
+		{
+			OutMessage = TEXT("Invalid player target!");
+			return false;
+		}
+		FWorldStateReader Reader;
+		const FWorldState* State = Reader.Get();
+		if (State == nullptr)
+		{
+			OutMessage = TEXT("World state is not published yet!");
+			return false;
+		}
+		OutFrame = State->Frame;
+		const FPublishedPlayer* Player = State->FindPlayer(PlayerTarget);
+		if (Player == nullptr || !Player->bHasPawn)
 		{
-			return FWebUtil::ErrorResponse(TEXT("Failed to set player rotation!"));
+			OutMessage = TEXT("Failed to get valid player pawn instance!");
+			return false;
 		}
-		return FWebUtil::SuccessResponse(TEXT("Player rotation set successfully!"));
+		OutPlayer = *Player;
+		return true;
 	}
 }
\ No newline at end of file
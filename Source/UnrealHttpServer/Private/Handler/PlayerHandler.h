@@ -3,30 +3,86 @@
 
 #include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
 #include "Runtime/Online/HTTPServer/Public/HttpResultCallback.h"
+#include "Util/WebUtil.h"
+#include "Service/PlayerService.h"
+#include "Service/WorldStateService.h"
+#include "Model/PlayerModel.h"
 
 namespace UnrealHttpServer
 {
 	class FPlayerHandler
 	{
 	public:
+		/* ================= Typed Responsers (game thread only, shared by routes and batch) ==================== */
+		/* target player is selected by optional "world" & "player" fields, from query params of routes or params of batch */
+
 		/**
 		 * get player location
 		 */
-		static TUniquePtr<FHttpServerResponse> GetPlayerLocation(const FHttpServerRequest& Request);
+		static bool GetPlayerLocation(const FUHttpPlayerTarget& Request, FUHttpPlayerLocation& OutResponse, FString& OutMessage);
 
 		/**
-		 * set player location
+		 * set player location (teleport), body: x, y, z
 		 */
-		static TUniquePtr<FHttpServerResponse> SetPlayerLocation(const FHttpServerRequest& Request);
+		static bool SetPlayerLocation(const FUHttpSetPlayerLocationRequest& Request, FUHttpEmpty& OutResponse, FString& OutMessage);
 
 		/**
 		 * get player rotation
 		 */
-		static TUniquePtr<FHttpServerResponse> GetPlayerRotation(const FHttpServerRequest& Request);
+		static bool GetPlayerRotation(const FUHttpPlayerTarget& Request, FUHttpPlayerRotation& OutResponse, FString& OutMessage);
+
+		/**
+		 * set player rotation, body: pitch, yaw, roll
+		 */
+		static bool SetPlayerRotation(const FUHttpSetPlayerRotationRequest& Request, FUHttpEmpty& OutResponse, FString& OutMessage);
+
+		/**
+		 * get coalescing key of target player, writes to same target & property in one frame are merged
+		 */
+		static FString GetTargetKey(const FUHttpPlayerTarget& Target);
+
+		/* ================= Framed Responsers (worker thread, read published world state) ==================== */
+
+		/**
+		 * get player location of published world state
+		 */
+		static bool GetPublishedPlayerLocation(const FUHttpPlayerTarget& Request, FUHttpPlayerLocation& OutResponse, FString& OutMessage, uint64& OutFrame);
+
+		/**
+		 * get player rotation of published world state
+		 */
+		static bool GetPublishedPlayerRotation(const FUHttpPlayerTarget& Request, FUHttpPlayerRotation& OutResponse, FString& OutMessage, uint64& OutFrame);
+
+		/* ================= Routes ==================== */
+
+		/**
+		 * long-poll player transform changes, query: seq (last seen sequence), timeout_ms
+		 */
+		static void WatchPlayerTransform(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond);
+
+		/**
+		 * get player transform history, query: from_frame & to_frame or from_time & to_time, step, max_samples
+		 * samples are returned as one flat array of frame, time, x, y, z, pitch, yaw, roll, vx, vy, vz
+		 */
+		static void GetPlayerHistory(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond);
+
+	private:
+		/* Default & max long-poll timeout of transform watching */
+		static const int32 DEFAULT_WATCH_TIMEOUT_MS = 10000;
+		static const int32 MAX_WATCH_TIMEOUT_MS = 60000;
+
+		/* Default & max samples of one history response */
+		static const int32 DEFAULT_HISTORY_SAMPLES = 10000;
+		static const int32 MAX_HISTORY_SAMPLES = 100000;
+
+		/**
+		 * get pawn of target player
+		 */
+		static APawn* GetTargetPawn(const FUHttpPlayerTarget& Target, FString& OutMessage);
 
 		/**
-		 * set player rotation
+		 * copy published state of target player, outputs frame of published state
 		 */
-		static TUniquePtr<FHttpServerResponse> SetPlayerRotation(const FHttpServerRequest& Request);
+		static bool GetPublishedPlayer(const FUHttpPlayerTarget& Target, FPublishedPlayer& OutPlayer, FString& OutMessage, uint64& OutFrame);
 	};
 }
\ No newline at end of file
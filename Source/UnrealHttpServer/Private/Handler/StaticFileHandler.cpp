@@ -0,0 +1,156 @@
+#include "Handler/StaticFileHandler.h"
+#include "Service/StaticFileService.h"
+#include "Util/ResponseCache.h"
+#include "Log.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		const TArray<FString>* FindHeader(const FHttpServerRequest& Request, const TCHAR* Name)
+		{
+			const TArray<FString>* Values = Request.Headers.Find(Name);
+			return Values != nullptr && Values->Num() > 0 ? Values : nullptr;
+		}
+	}
+
+	const TCHAR* const FStaticFileHandler::ROUTE = TEXT("/static");
+
+	void FStaticFileHandler::ServeFile(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+	{
+		// file system & copy of content are off game thread
+		FWebUtil::RunOnWorkerThread([Request, Respond]()
+		{
+			FString Path = Request->RelativePath.GetPath();
+			Path.RemoveFromStart(ROUTE);
+			FStaticFilePtr File = FStaticFileService::Open(Path);
+			if (!File.IsValid())
+			{
+				TUniquePtr<FHttpServerResponse> NotFoundResponse = FWebUtil::ErrorResponse(FString::Printf(TEXT("File not found: %s"), *Path), static_cast<int32>(EHttpServerResponseCodes::NotFound));
+				NotFoundResponse->Code = EHttpServerResponseCodes::NotFound;
+				Respond(MoveTemp(NotFoundResponse));
+				return;
+			}
+
+			TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+			Response->Headers.Add(TEXT("etag"), { File->GetETag() });
+			Response->Headers.Add(TEXT("last-modified"), { File->GetModified().ToHttpDate() });
+			// served as is, whole files are not gzipped on the fly so the strong entity tag stays valid for If-Range
+			Response->Headers.Add(TEXT("cache-control"), { TEXT("no-cache, no-transform") });
+			Response->Headers.Add(TEXT("accept-ranges"), { TEXT("bytes") });
+
+			// conditional get, If-None-Match takes precedence
+			bool bNotModified = false;
+			if (FindHeader(*Request, TEXT("if-none-match")) != nullptr)
+			{
+				bNotModified = FResponseCache::MatchesETag(*Request, File->GetETag());
+			}
+			else if (const TArray<FString>* IfModifiedSince = FindHeader(*Request, TEXT("if-modified-since")))
+			{
+				// http dates have second precision, split into values by comma
+				FDateTime Since;
+				FString SinceString = FString::Join(*IfModifiedSince, TEXT(", "));
+				bNotModified = FDateTime::ParseHttpDate(SinceString, Since) && File->GetModified().GetTicks() / ETimespan::TicksPerSecond <= Since.GetTicks() / ETimespan::TicksPerSecond;
+			}
+			if (bNotModified)
+			{
+				Response->Code = EHttpServerResponseCodes::NotModified;
+				Respond(MoveTemp(Response));
+				return;
+			}
+
+			int64 Size = File->GetSize();
+			bool bHasRange = false;
+			int64 Start = 0;
+			int64 End = Size - 1;
+			if (!ParseRange(*Request, Size, File->GetETag(), bHasRange, Start, End))
+			{
+				Response->Code = static_cast<EHttpServerResponseCodes>(416);
+				Response->Headers.Add(TEXT("content-range"), { FString::Printf(TEXT("bytes */%lld"), Size) });
+				Response->Headers.Add(TEXT("content-length"), { TEXT("0") });
+				Respond(MoveTemp(Response));
+				return;
+			}
+			int64 Length = bHasRange ? End - Start + 1 : Size;
+			if (Length > MAX_int32)
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("File is too large, request a range!")));
+				return;
+			}
+			Response->Code = bHasRange ? EHttpServerResponseCodes::PartialContent : EHttpServerResponseCodes::Ok;
+			if (bHasRange)
+			{
+				Response->Headers.Add(TEXT("content-range"), { FString::Printf(TEXT("bytes %lld-%lld/%lld"), Start, End, Size) });
+			}
+			Response->Headers.Add(TEXT("content-type"), { File->GetMimeType() });
+			Response->Headers.Add(TEXT("content-length"), { FString::Printf(TEXT("%lld"), Length) });
+			// the only copy, from mapped pages into response body
+			Response->Body.SetNumUninitialized((int32)Length);
+			if (Length > 0)
+			{
+				FMemory::Memcpy(Response->Body.GetData(), File->GetData() + Start, Length);
+			}
+			Respond(MoveTemp(Response));
+		});
+	}
+
+	bool FStaticFileHandler::ParseRange(const FHttpServerRequest& Request, int64 Size, const FString& ETag, bool& bOutHasRange, int64& OutStart, int64& OutEnd)
+	{
+		bOutHasRange = false;
+		const TArray<FString>* RangeValues = FindHeader(Request, TEXT("range"));
+		// header values are split by comma, more than one value is a multi-range request
+		if (RangeValues == nullptr || RangeValues->Num() != 1)
+		{
+			return true;
+		}
+		// range of a changed entity is ignored, whole file is served
+		const TArray<FString>* IfRangeValues = FindHeader(Request, TEXT("if-range"));
+		if (IfRangeValues != nullptr && (*IfRangeValues)[0] != ETag)
+		{
+			return true;
+		}
+		FString RangeSpec = (*RangeValues)[0].TrimStartAndEnd();
+		if (!RangeSpec.RemoveFromStart(TEXT("bytes=")))
+		{
+			return true;
+		}
+		FString StartString;
+		FString EndString;
+		if (!RangeSpec.Split(TEXT("-"), &StartString, &EndString))
+		{
+			return true;
+		}
+		StartString.TrimStartAndEndInline();
+		EndString.TrimStartAndEndInline();
+		if (StartString.IsEmpty())
+		{
+			// suffix range, last N bytes
+			if (!EndString.IsNumeric())
+			{
+				return true;
+			}
+			int64 Suffix = FCString::Atoi64(*EndString);
+			if (Suffix <= 0 || Size == 0)
+			{
+				return false;
+			}
+			OutStart = FMath::Max<int64>(0, Size - Suffix);
+			OutEnd = Size - 1;
+		}
+		else
+		{
+			if (!StartString.IsNumeric() || (!EndString.IsEmpty() && !EndString.IsNumeric()))
+			{
+				return true;
+			}
+			OutStart = FCString::Atoi64(*StartString);
+			OutEnd = EndString.IsEmpty() ? Size - 1 : FMath::Min<int64>(FCString::Atoi64(*EndString), Size - 1);
+			if (OutStart >= Size || OutEnd < OutStart)
+			{
+				return false;
+			}
+		}
+		bOutHasRange = true;
+		return true;
+	}
+}
\ No newline at end of file
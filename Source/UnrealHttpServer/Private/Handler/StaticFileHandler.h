@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Runtime/Online/HTTPServer/Public/HttpResultCallback.h"
+#include "Util/WebUtil.h"
+
+namespace UnrealHttpServer
+{
+	class FStaticFileHandler
+	{
+	public:
+		/* Route prefix of static files, /static/<path> serves <root>/<path> */
+		static const TCHAR* const ROUTE;
+
+		/**
+		 * serve static file under route, supports If-None-Match, If-Modified-Since, Range & If-Range
+		 */
+		static void ServeFile(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond);
+
+	private:
+		/**
+		 * Parse single byte range of Range header against file size, returns false if unsatisfiable
+		 * Multiple ranges & ranges with a stale If-Range are not supported, whole file is served (bOutHasRange false)
+		 */
+		static bool ParseRange(const FHttpServerRequest& Request, int64 Size, const FString& ETag, bool& bOutHasRange, int64& OutStart, int64& OutEnd);
+	};
+}
\ No newline at end of file
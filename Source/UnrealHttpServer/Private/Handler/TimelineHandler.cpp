@@ -0,0 +1,137 @@
+#include "Handler/TimelineHandler.h"
+#include "Handler/BatchHandler.h"
+#include "Service/TimelineService.h"
+#include "Log.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		bool ReadProgress(const FString& Id, FUHttpTimelineProgress& OutResponse, FString& OutMessage)
+		{
+			FTimelineProgress Progress;
+			if (!FTimelineService::GetProgress(Id, Progress))
+			{
+				OutMessage = FString::Printf(TEXT("Timeline not found: %s"), *Id);
+				return false;
+			}
+			OutResponse.Id = Id;
+			OutResponse.State = FTimelineService::GetStateName(Progress.State);
+			OutResponse.Timebase = FTimelineService::GetTimebaseName(Progress.Timebase);
+			OutResponse.Total = Progress.Total;
+			OutResponse.Executed = Progress.Executed;
+			OutResponse.Failed = Progress.Failed;
+			OutResponse.Elapsed = Progress.Elapsed;
+			OutResponse.LastError = Progress.LastError;
+			return true;
+		}
+	}
+
+	void FTimelineHandler::StartTimeline(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+	{
+		FWebUtil::RunOnWorkerThread([Request, Respond]()
+		{
+			// parse & validate timeline on worker thread
+			TSharedPtr<FJsonObject> RequestBody = FWebUtil::GetRequestJsonBody(*Request);
+			if (RequestBody == nullptr)
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Failed to parse request body to json!")));
+				return;
+			}
+			FString TimebaseName = TEXT("frame");
+			RequestBody->TryGetStringField(TEXT("timebase"), TimebaseName);
+			if (TimebaseName != TEXT("frame") && TimebaseName != TEXT("time"))
+			{
+				Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Invalid timebase: %s"), *TimebaseName)));
+				return;
+			}
+			ETimelineTimebase Timebase = TimebaseName == TEXT("frame") ? ETimelineTimebase::Frame : ETimelineTimebase::Time;
+			FString Mode = TEXT("continue_on_error");
+			RequestBody->TryGetStringField(TEXT("mode"), Mode);
+			if (Mode != TEXT("stop_on_error") && Mode != TEXT("continue_on_error"))
+			{
+				Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Invalid timeline mode: %s"), *Mode)));
+				return;
+			}
+			bool bStopOnError = Mode == TEXT("stop_on_error");
+
+			const TArray<TSharedPtr<FJsonValue>>* StepValues;
+			if (!RequestBody->TryGetArrayField(TEXT("steps"), StepValues))
+			{
+				Respond(FWebUtil::ErrorResponse(TEXT("Missing steps array!")));
+				return;
+			}
+			if (StepValues->Num() > MAX_TIMELINE_STEPS)
+			{
+				Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Too many steps, max: %d"), MAX_TIMELINE_STEPS)));
+				return;
+			}
+			TArray<FTimelineStep> Steps;
+			Steps.Reserve(StepValues->Num());
+			for (int32 Index = 0; Index < StepValues->Num(); ++Index)
+			{
+				const TSharedPtr<FJsonObject>* StepObject;
+				FTimelineStep Step;
+				if (!(*StepValues)[Index]->TryGetObject(StepObject)
+					|| !(*StepObject)->TryGetStringField(TEXT("op"), Step.Name)
+					|| !(*StepObject)->TryGetNumberField(TEXT("at"), Step.Offset)
+					|| Step.Offset < 0)
+				{
+					Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Invalid step at index %d!"), Index)));
+					return;
+				}
+				Step.Operation = FBatchHandler::FindOperation(Step.Name);
+				if (Step.Operation == nullptr)
+				{
+					Respond(FWebUtil::ErrorResponse(FString::Printf(TEXT("Unknown operation at index %d: %s"), Index, *Step.Name)));
+					return;
+				}
+				const TSharedPtr<FJsonObject>* Params;
+				if ((*StepObject)->TryGetObjectField(TEXT("params"), Params))
+				{
+					Step.Params = *Params;
+				}
+				Steps.Add(MoveTemp(Step));
+			}
+			RequestBody.Reset();
+
+			// start on game thread directly, the mutation queue budget would shift the start frame
+			FWebUtil::RunOnGameThread([Steps = MoveTemp(Steps), Timebase, bStopOnError, Respond]() mutable
+			{
+				int32 NumSteps = Steps.Num();
+				FString Id = FTimelineService::Start(MoveTemp(Steps), Timebase, bStopOnError);
+				TSharedPtr<FJsonObject> Data = MakeShareable(new FJsonObject());
+				Data->SetStringField(TEXT("id"), Id);
+				Data->SetNumberField(TEXT("steps"), NumSteps);
+				Data->SetNumberField(TEXT("start_frame"), (double)GFrameCounter);
+				Respond(FWebUtil::SuccessResponse(Data));
+			});
+		});
+	}
+
+	bool FTimelineHandler::GetTimelineProgress(const FUHttpTimelineRequest& Request, FUHttpTimelineProgress& OutResponse, FString& OutMessage)
+	{
+		return ReadProgress(Request.Id, OutResponse, OutMessage);
+	}
+
+	bool FTimelineHandler::PauseTimeline(const FUHttpPauseTimelineRequest& Request, FUHttpTimelineProgress& OutResponse, FString& OutMessage)
+	{
+		if (!FTimelineService::SetPaused(Request.Id, Request.Paused))
+		{
+			OutMessage = FString::Printf(TEXT("Timeline not found or finished: %s"), *Request.Id);
+			return false;
+		}
+		return ReadProgress(Request.Id, OutResponse, OutMessage);
+	}
+
+	bool FTimelineHandler::CancelTimeline(const FUHttpTimelineRequest& Request, FUHttpTimelineProgress& OutResponse, FString& OutMessage)
+	{
+		if (!FTimelineService::Cancel(Request.Id))
+		{
+			OutMessage = FString::Printf(TEXT("Timeline not found or finished: %s"), *Request.Id);
+			return false;
+		}
+		return ReadProgress(Request.Id, OutResponse, OutMessage);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Runtime/Online/HTTPServer/Public/HttpResultCallback.h"
+#include "Util/WebUtil.h"
+#include "Model/TimelineModel.h"
+
+namespace UnrealHttpServer
+{
+	class FTimelineHandler
+	{
+	public:
+		/**
+		 * Start a timeline of batch operations executed on schedule by server
+		 * Body: { "timebase": "frame" | "time", "mode": "stop_on_error" | "continue_on_error",
+		 *         "steps": [{ "at": <frame or seconds offset>, "op": "player.set_location", "params": {...} }] }
+		 */
+		static void StartTimeline(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond);
+
+		/* ================= Typed Responsers (game thread only) ==================== */
+
+		/**
+		 * get timeline progress, query: id
+		 */
+		static bool GetTimelineProgress(const FUHttpTimelineRequest& Request, FUHttpTimelineProgress& OutResponse, FString& OutMessage);
+
+		/**
+		 * pause or resume timeline, body: id, paused
+		 */
+		static bool PauseTimeline(const FUHttpPauseTimelineRequest& Request, FUHttpTimelineProgress& OutResponse, FString& OutMessage);
+
+		/**
+		 * cancel timeline, body: id
+		 */
+		static bool CancelTimeline(const FUHttpTimelineRequest& Request, FUHttpTimelineProgress& OutResponse, FString& OutMessage);
+
+	private:
+		/* Max steps of one timeline */
+		static const int32 MAX_TIMELINE_STEPS = 100000;
+	};
+}
\ No newline at end of file
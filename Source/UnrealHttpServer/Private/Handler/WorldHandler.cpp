@@ -0,0 +1,87 @@
+#include "Handler/WorldHandler.h"
+#include "Log.h"
+#include "Service/PlayerService.h"
+#include "Service/ActorIndexService.h"
+#include "Service/SnapshotService.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/Guid.h"
+
+namespace UnrealHttpServer
+{
+	bool FWorldHandler::CaptureSnapshot(const FUHttpCaptureSnapshotRequest& Request, FUHttpSnapshotInfo& OutResponse, FString& OutMessage)
+	{
+		FPlayerTarget PlayerTarget;
+		if (!FPlayerService::ParseTarget(Request.World, FString::FromInt(Request.Player), PlayerTarget))
+		{
+			OutMessage = TEXT("Invalid player target!");
+			return false;
+		}
+
+		// player pawn first, then selected actors
+		TArray<AActor*> Actors;
+		APawn* PlayerPawn = FPlayerService::GetPlayerPawn(PlayerTarget);
+		if (PlayerPawn != nullptr)
+		{
+			Actors.Add(PlayerPawn);
+		}
+		if (!Request.Class.IsEmpty() || !Request.Tag.IsEmpty())
+		{
+			FActorQuery Query;
+			if (!Request.Class.IsEmpty())
+			{
+				Query.Class = FindObject<UClass>(ANY_PACKAGE, *Request.Class);
+				if (Query.Class == nullptr || !Query.Class->IsChildOf(AActor::StaticClass()))
+				{
+					OutMessage = FString::Printf(TEXT("Invalid actor class: %s"), *Request.Class);
+					return false;
+				}
+			}
+			if (!Request.Tag.IsEmpty())
+			{
+				Query.Tag = FName(*Request.Tag);
+			}
+			Query.Limit = FMath::Max(0, Request.Limit);
+			TArray<AActor*> SelectedActors;
+			FActorIndexService::Query(Query, SelectedActors);
+			for (AActor* Actor : SelectedActors)
+			{
+				if (Actor != PlayerPawn)
+				{
+					Actors.Add(Actor);
+				}
+			}
+		}
+		if (Actors.Num() == 0)
+		{
+			OutMessage = TEXT("No actor to capture!");
+			return false;
+		}
+
+		OutResponse.Id = Request.Id.IsEmpty() ? FGuid::NewGuid().ToString(EGuidFormats::Digits).ToLower() : Request.Id;
+		OutResponse.Bytes = FSnapshotService::Capture(OutResponse.Id, Actors, Request.Velocities);
+		OutResponse.Actors = Actors.Num();
+		return true;
+	}
+
+	bool FWorldHandler::RestoreSnapshot(const FUHttpSnapshotRequest& Request, FUHttpRestoreSnapshotResponse& OutResponse, FString& OutMessage)
+	{
+		double StartSeconds = FPlatformTime::Seconds();
+		if (!FSnapshotService::Restore(Request.Id, OutResponse.Restored, OutResponse.Missing))
+		{
+			OutMessage = FString::Printf(TEXT("Snapshot not found: %s"), *Request.Id);
+			return false;
+		}
+		OutResponse.Ms = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+		return true;
+	}
+
+	bool FWorldHandler::DeleteSnapshot(const FUHttpSnapshotRequest& Request, FUHttpEmpty& OutResponse, FString& OutMessage)
+	{
+		if (!FSnapshotService::Remove(Request.Id))
+		{
+			OutMessage = FString::Printf(TEXT("Snapshot not found: %s"), *Request.Id);
+			return false;
+		}
+		return true;
+	}
+}
\ No newline at end of file
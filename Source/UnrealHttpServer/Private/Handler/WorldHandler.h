@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Util/WebUtil.h"
+#include "Model/WorldModel.h"
+
+namespace UnrealHttpServer
+{
+	class FWorldHandler
+	{
+	public:
+		/* ================= Typed Responsers (game thread only, shared by routes and batch) ==================== */
+
+		/**
+		 * capture transforms of target player pawn & selected actors into an in-memory snapshot
+		 * body: id, class, tag, limit, velocities
+		 */
+		static bool CaptureSnapshot(const FUHttpCaptureSnapshotRequest& Request, FUHttpSnapshotInfo& OutResponse, FString& OutMessage);
+
+		/**
+		 * restore snapshot in one game thread pass, body: id
+		 */
+		static bool RestoreSnapshot(const FUHttpSnapshotRequest& Request, FUHttpRestoreSnapshotResponse& OutResponse, FString& OutMessage);
+
+		/**
+		 * delete snapshot, query: id
+		 */
+		static bool DeleteSnapshot(const FUHttpSnapshotRequest& Request, FUHttpEmpty& OutResponse, FString& OutMessage);
+	};
+}
\ No newline at end of file
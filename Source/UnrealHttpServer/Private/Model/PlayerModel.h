@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerModel.generated.h"
+
+/**
+ * Empty response data
+ */
+USTRUCT()
+struct FUHttpEmpty
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Target player, world: "server" | "pie:<instance>" (empty for first game world), player: <index>
+ */
+USTRUCT()
+struct FUHttpPlayerTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString World;
+
+	UPROPERTY()
+	int32 Player = 0;
+};
+
+/**
+ * Player location
+ */
+USTRUCT()
+struct FUHttpPlayerLocation
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float X = 0;
+
+	UPROPERTY()
+	float Y = 0;
+
+	UPROPERTY()
+	float Z = 0;
+};
+
+/**
+ * Player rotation
+ */
+USTRUCT()
+struct FUHttpPlayerRotation
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float Pitch = 0;
+
+	UPROPERTY()
+	float Yaw = 0;
+
+	UPROPERTY()
+	float Roll = 0;
+};
+
+/**
+ * Set player location request, target from query params (or batch params) & location from body
+ */
+USTRUCT()
+struct FUHttpSetPlayerLocationRequest : public FUHttpPlayerTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float X = 0;
+
+	UPROPERTY()
+	float Y = 0;
+
+	UPROPERTY()
+	float Z = 0;
+};
+
+/**
+ * Set player rotation request, target from query params (or batch params) & rotation from body
+ */
+USTRUCT()
+struct FUHttpSetPlayerRotationRequest : public FUHttpPlayerTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float Pitch = 0;
+
+	UPROPERTY()
+	float Yaw = 0;
+
+	UPROPERTY()
+	float Roll = 0;
+};
\ No newline at end of file
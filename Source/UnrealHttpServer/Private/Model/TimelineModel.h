@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TimelineModel.generated.h"
+
+/**
+ * Timeline selected by id
+ */
+USTRUCT()
+struct FUHttpTimelineRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Id;
+};
+
+/**
+ * Pause or resume timeline
+ */
+USTRUCT()
+struct FUHttpPauseTimelineRequest : public FUHttpTimelineRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	bool Paused = true;
+};
+
+/**
+ * Progress of timeline
+ */
+USTRUCT()
+struct FUHttpTimelineProgress
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Id;
+
+	/* running | paused | completed | cancelled | failed */
+	UPROPERTY()
+	FString State;
+
+	/* frame | time */
+	UPROPERTY()
+	FString Timebase;
+
+	UPROPERTY()
+	int32 Total = 0;
+
+	UPROPERTY()
+	int32 Executed = 0;
+
+	UPROPERTY()
+	int32 Failed = 0;
+
+	/* Elapsed frames or seconds on timeline, pauses excluded */
+	UPROPERTY()
+	double Elapsed = 0;
+
+	/* Message of last failed step */
+	UPROPERTY()
+	FString LastError;
+};
\ No newline at end of file
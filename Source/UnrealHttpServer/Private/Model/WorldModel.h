@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Model/PlayerModel.h"
+#include "WorldModel.generated.h"
+
+/**
+ * Capture world snapshot request, pawn of target player & actors selected by class/tag are captured
+ */
+USTRUCT()
+struct FUHttpCaptureSnapshotRequest : public FUHttpPlayerTarget
+{
+	GENERATED_BODY()
+
+	/* Snapshot id, generated if empty, replaces existing snapshot of same id */
+	UPROPERTY()
+	FString Id;
+
+	/* Class of selected actors, none selected if both class & tag are empty */
+	UPROPERTY()
+	FString Class;
+
+	/* Tag of selected actors */
+	UPROPERTY()
+	FString Tag;
+
+	/* Max selected actors */
+	UPROPERTY()
+	int32 Limit = 1000;
+
+	/* Capture linear & angular velocities */
+	UPROPERTY()
+	bool Velocities = false;
+};
+
+/**
+ * Captured world snapshot
+ */
+USTRUCT()
+struct FUHttpSnapshotInfo
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Id;
+
+	/* Captured actors, including player pawn */
+	UPROPERTY()
+	int32 Actors = 0;
+
+	/* Size of snapshot blob */
+	UPROPERTY()
+	int32 Bytes = 0;
+};
+
+/**
+ * Snapshot selected by id, to restore or delete
+ */
+USTRUCT()
+struct FUHttpSnapshotRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Id;
+};
+
+/**
+ * Restored world snapshot
+ */
+USTRUCT()
+struct FUHttpRestoreSnapshotResponse
+{
+	GENERATED_BODY()
+
+	/* Restored actors */
+	UPROPERTY()
+	int32 Restored = 0;
+
+	/* Captured actors destroyed since capture */
+	UPROPERTY()
+	int32 Missing = 0;
+
+	/* Elapsed milliseconds of restore pass */
+	UPROPERTY()
+	float Ms = 0;
+};
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include "Service/ActorIndexService.h"
+#include "Service/PlayerService.h"
+#include "Log.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<float> CVarActorIndexCellSize(
+			TEXT("UHttp.ActorIndex.CellSize"),
+			1000.0f,
+			TEXT("Grid cell size (in unreal units) of actor spatial index, read once at startup"),
+			ECVF_ReadOnly);
+
+		TAutoConsoleVariable<int32> CVarActorIndexSweepPerTick(
+			TEXT("UHttp.ActorIndex.SweepPerTick"),
+			2048,
+			TEXT("Actors checked per tick for destruction & missed moves in actor spatial index (moves of root components are indexed immediately)"));
+
+		/* Max cells visited by a spatial query before falling back to visiting every cell */
+		const int64 MAX_QUERY_CELLS = 4096;
+	}
+
+	TMap<uint32, FActorIndexService::FIndexedActor> FActorIndexService::Actors;
+	TMap<TWeakObjectPtr<AActor>, uint32> FActorIndexService::ActorIds;
+	uint32 FActorIndexService::NextId = 1;
+	TMap<FIntVector, TArray<uint32>> FActorIndexService::Cells;
+	TArray<uint32> FActorIndexService::SweepOrder;
+	int32 FActorIndexService::SweepCursor = 0;
+	float FActorIndexService::CellSize = 1000.0f;
+	TWeakObjectPtr<UWorld> FActorIndexService::IndexedWorld;
+	FDelegateHandle FActorIndexService::ActorSpawnedHandle;
+	FDelegateHandle FActorIndexService::TickerHandle;
+
+	/* ================= Public Methods ==================== */
+
+	void FActorIndexService::Initialize()
+	{
+		CellSize = FMath::Max(1.0f, CVarActorIndexCellSize.GetValueOnGameThread());
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FActorIndexService::Tick));
+	}
+
+	void FActorIndexService::Shutdown()
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		Reset();
+	}
+
+	int32 FActorIndexService::Query(const FActorQuery& Query, TArray<AActor*>& OutActors)
+	{
+		// candidates from cells overlapping query bounds, or every actor without spatial filter
+		TArray<uint32> Candidates;
+		if (Query.bHasSphere || Query.bHasBox)
+		{
+			FBox Bounds = Query.bHasBox ? Query.Box : FBox(ForceInit);
+			if (Query.bHasSphere)
+			{
+				FBox SphereBounds = FBox::BuildAABB(Query.SphereCenter, FVector(Query.SphereRadius));
+				Bounds = Query.bHasBox ? Bounds.Overlap(SphereBounds) : SphereBounds;
+			}
+			if (!Bounds.IsValid)
+			{
+				return 0;
+			}
+			FIntVector MinCell = GetCell(Bounds.Min);
+			FIntVector MaxCell = GetCell(Bounds.Max);
+			int64 NumCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+			if (NumCells <= FMath::Min<int64>(Cells.Num(), MAX_QUERY_CELLS))
+			{
+				for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+				{
+					for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+					{
+						for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+						{
+							const TArray<uint32>* CellActors = Cells.Find(FIntVector(X, Y, Z));
+							if (CellActors != nullptr)
+							{
+								Candidates.Append(*CellActors);
+							}
+						}
+					}
+				}
+			}
+			else
+			{
+				// query bounds cover more cells than occupied, visit occupied cells only
+				for (const auto& Cell : Cells)
+				{
+					if (Cell.Key.X >= MinCell.X && Cell.Key.X <= MaxCell.X
+						&& Cell.Key.Y >= MinCell.Y && Cell.Key.Y <= MaxCell.Y
+						&& Cell.Key.Z >= MinCell.Z && Cell.Key.Z <= MaxCell.Z)
+					{
+						Candidates.Append(Cell.Value);
+					}
+				}
+			}
+		}
+		else
+		{
+			Candidates = SweepOrder;
+		}
+
+		// stable order for pagination
+		Candidates.Sort();
+		int32 Total = 0;
+		for (uint32 Id : Candidates)
+		{
+			const FIndexedActor* Indexed = Actors.Find(Id);
+			AActor* Actor = Indexed != nullptr ? Indexed->Actor.Get() : nullptr;
+			if (Actor == nullptr || !Matches(Query, Actor))
+			{
+				continue;
+			}
+			if (Total >= Query.Offset && OutActors.Num() < Query.Limit)
+			{
+				OutActors.Add(Actor);
+			}
+			++Total;
+		}
+		return Total;
+	}
+
+	AActor* FActorIndexService::FindActor(uint32 Id)
+	{
+		const FIndexedActor* Indexed = Actors.Find(Id);
+		return Indexed != nullptr ? Indexed->Actor.Get() : nullptr;
+	}
+
+	uint32 FActorIndexService::GetActorId(AActor* Actor)
+	{
+		const uint32* Id = ActorIds.Find(Actor);
+		return Id != nullptr ? *Id : 0;
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FActorIndexService::Tick(float DeltaTime)
+	{
+		// follow the game world of default player target
+		UWorld* World = FPlayerService::GetWorld(FPlayerTarget());
+		if (World != IndexedWorld.Get())
+		{
+			Rebuild(World);
+		}
+		if (World == nullptr || SweepOrder.Num() == 0)
+		{
+			return true;
+		}
+
+		// sweep a slice: drop destroyed actors, fallback for moves missed by TransformUpdated (e.g. root component replaced)
+		int32 Budget = FMath::Min(SweepOrder.Num(), CVarActorIndexSweepPerTick.GetValueOnGameThread());
+		for (int32 Checked = 0; Checked < Budget && SweepOrder.Num() > 0; ++Checked)
+		{
+			if (SweepCursor >= SweepOrder.Num())
+			{
+				SweepCursor = 0;
+			}
+			uint32 Id = SweepOrder[SweepCursor];
+			FIndexedActor* Indexed = Actors.Find(Id);
+			AActor* Actor = Indexed != nullptr ? Indexed->Actor.Get() : nullptr;
+			if (Actor == nullptr || Actor->IsPendingKill())
+			{
+				if (Indexed != nullptr)
+				{
+					UnbindRoot(*Indexed);
+					RemoveFromCell(Id, Indexed->Cell);
+					ActorIds.Remove(Indexed->Actor);
+					Actors.Remove(Id);
+				}
+				SweepOrder.RemoveAtSwap(SweepCursor, 1, false);
+				continue;
+			}
+			BindRoot(Id, *Indexed, Actor);
+			UpdateCell(Id, *Indexed, Actor->GetActorLocation());
+			++SweepCursor;
+		}
+		return true;
+	}
+
+	void FActorIndexService::Rebuild(UWorld* World)
+	{
+		Reset();
+		if (World == nullptr)
+		{
+			return;
+		}
+		IndexedWorld = World;
+		ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateStatic(&FActorIndexService::AddActor));
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			AddActor(*It);
+		}
+		UE_LOG(UHttpLog, Log, TEXT("Actor index rebuilt: %d actors in %d cells"), Actors.Num(), Cells.Num());
+	}
+
+	void FActorIndexService::Reset()
+	{
+		if (IndexedWorld.IsValid())
+		{
+			IndexedWorld->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		}
+		IndexedWorld.Reset();
+		ActorSpawnedHandle.Reset();
+		for (auto& Indexed : Actors)
+		{
+			UnbindRoot(Indexed.Value);
+		}
+		Actors.Reset();
+		ActorIds.Reset();
+		Cells.Reset();
+		SweepOrder.Reset();
+		SweepCursor = 0;
+	}
+
+	void FActorIndexService::AddActor(AActor* Actor)
+	{
+		if (Actor == nullptr)
+		{
+			return;
+		}
+		if (ActorIds.Contains(Actor))
+		{
+			return;
+		}
+		// weak pointers of an actor reusing the object slot of a destroyed one differ by serial number, so its stale entry is not matched
+		uint32 Id = NextId++;
+		ActorIds.Add(Actor, Id);
+		FIndexedActor& Indexed = Actors.Add(Id);
+		Indexed.Actor = Actor;
+		Indexed.Cell = GetCell(Actor->GetActorLocation());
+		Cells.FindOrAdd(Indexed.Cell).Add(Id);
+		SweepOrder.Add(Id);
+		BindRoot(Id, Indexed, Actor);
+	}
+
+	void FActorIndexService::BindRoot(uint32 Id, FIndexedActor& Indexed, AActor* Actor)
+	{
+		USceneComponent* Root = Actor->GetRootComponent();
+		if (Root == Indexed.Root.Get() && (Root == nullptr || Indexed.TransformUpdatedHandle.IsValid()))
+		{
+			return;
+		}
+		UnbindRoot(Indexed);
+		if (Root != nullptr)
+		{
+			Indexed.Root = Root;
+			Indexed.TransformUpdatedHandle = Root->TransformUpdated.AddStatic(&FActorIndexService::OnTransformUpdated, Id);
+		}
+	}
+
+	void FActorIndexService::UnbindRoot(FIndexedActor& Indexed)
+	{
+		USceneComponent* Root = Indexed.Root.Get();
+		if (Root != nullptr)
+		{
+			Root->TransformUpdated.Remove(Indexed.TransformUpdatedHandle);
+		}
+		Indexed.Root.Reset();
+		Indexed.TransformUpdatedHandle.Reset();
+	}
+
+	void FActorIndexService::OnTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, uint32 Id)
+	{
+		// transforms updated off game thread are left to the sweep
+		if (!IsInGameThread())
+		{
+			return;
+		}
+		FIndexedActor* Indexed = Actors.Find(Id);
+		if (Indexed != nullptr && Indexed->Root.Get() == Component)
+		{
+			UpdateCell(Id, *Indexed, Component->GetComponentLocation());
+		}
+	}
+
+	void FActorIndexService::UpdateCell(uint32 Id, FIndexedActor& Indexed, const FVector& Location)
+	{
+		FIntVector Cell = GetCell(Location);
+		if (Cell != Indexed.Cell)
+		{
+			RemoveFromCell(Id, Indexed.Cell);
+			Cells.FindOrAdd(Cell).Add(Id);
+			Indexed.Cell = Cell;
+		}
+	}
+
+	void FActorIndexService::RemoveFromCell(uint32 Id, const FIntVector& Cell)
+	{
+		TArray<uint32>* CellActors = Cells.Find(Cell);
+		if (CellActors == nullptr)
+		{
+			return;
+		}
+		CellActors->RemoveSingleSwap(Id, false);
+		if (CellActors->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+
+	FIntVector FActorIndexService::GetCell(const FVector& Location)
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / CellSize),
+			FMath::FloorToInt(Location.Y / CellSize),
+			FMath::FloorToInt(Location.Z / CellSize));
+	}
+
+	bool FActorIndexService::Matches(const FActorQuery& Query, AActor* Actor)
+	{
+		if (Query.Class != nullptr && !Actor->IsA(Query.Class))
+		{
+			return false;
+		}
+		if (!Query.Tag.IsNone() && !Actor->ActorHasTag(Query.Tag))
+		{
+			return false;
+		}
+		FVector Location = Actor->GetActorLocation();
+		if (Query.bHasSphere && FVector::DistSquared(Location, Query.SphereCenter) > FMath::Square(Query.SphereRadius))
+		{
+			return false;
+		}
+		if (Query.bHasBox && !Query.Box.IsInsideOrOn(Location))
+		{
+			return false;
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Components/SceneComponent.h"
+
+class AActor;
+class UWorld;
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Actor query filters & page
+	 */
+	struct FActorQuery
+	{
+		/* Class filter (actor must be a subclass), nullptr for any */
+		UClass* Class = nullptr;
+		/* Tag filter, NAME_None for any */
+		FName Tag = NAME_None;
+		/* Sphere filter on actor location */
+		bool bHasSphere = false;
+		FVector SphereCenter = FVector::ZeroVector;
+		float SphereRadius = 0;
+		/* Box filter on actor location */
+		bool bHasBox = false;
+		FBox Box = FBox(ForceInit);
+		/* Page of matched actors, ordered by index id */
+		int32 Offset = 0;
+		int32 Limit = 100;
+	};
+
+	/**
+	 * Index of actors in the game world, bucketed by location in a uniform grid
+	 * Spawns are indexed from the world spawn delegate and moves are re-bucketed from TransformUpdated of root components.
+	 * Destroyed actors (no runtime delegate in the engine) and root components replaced after spawn are picked up
+	 * by a budgeted round-robin sweep on ticker
+	 */
+	class FActorIndexService
+	{
+	public:
+		/**
+		 * Register ticker
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister ticker & delegates and clear the index
+		 */
+		static void Shutdown();
+
+		/**
+		 * Query actors, returns total matched count and outputs actors of the page (game thread only)
+		 */
+		static int32 Query(const FActorQuery& Query, TArray<AActor*>& OutActors);
+
+		/**
+		 * Find indexed actor by index id, nullptr if not indexed or destroyed (game thread only)
+		 */
+		static AActor* FindActor(uint32 Id);
+
+		/**
+		 * Get index id of actor, 0 if not indexed (game thread only)
+		 * Ids are assigned in spawn order and never reused, unlike object unique ids which are reused after garbage collection
+		 */
+		static uint32 GetActorId(AActor* Actor);
+
+	private:
+		/**
+		 * Indexed actor & its grid cell
+		 */
+		struct FIndexedActor
+		{
+			TWeakObjectPtr<AActor> Actor;
+			FIntVector Cell;
+			/* Root component watched for moves & its TransformUpdated binding */
+			TWeakObjectPtr<USceneComponent> Root;
+			FDelegateHandle TransformUpdatedHandle;
+		};
+
+		/* Indexed actors by index id */
+		static TMap<uint32, FIndexedActor> Actors;
+		/* Index ids by actor */
+		static TMap<TWeakObjectPtr<AActor>, uint32> ActorIds;
+		/* Next index id, kept across rebuilds so that ids of a previous world do not find actors of the current one */
+		static uint32 NextId;
+		/* Actor ids by grid cell */
+		static TMap<FIntVector, TArray<uint32>> Cells;
+		/* Actor ids in sweep order & next sweep position */
+		static TArray<uint32> SweepOrder;
+		static int32 SweepCursor;
+		/* Grid cell size, read once at startup */
+		static float CellSize;
+
+		static TWeakObjectPtr<UWorld> IndexedWorld;
+		static FDelegateHandle ActorSpawnedHandle;
+		static FDelegateHandle TickerHandle;
+
+		/**
+		 * Follow current game world and sweep a slice of actors
+		 */
+		static bool Tick(float DeltaTime);
+
+		/**
+		 * Rebuild index for world
+		 */
+		static void Rebuild(UWorld* World);
+
+		/**
+		 * Clear index and unbind from world
+		 */
+		static void Reset();
+
+		/**
+		 * Add actor to index
+		 */
+		static void AddActor(AActor* Actor);
+
+		/**
+		 * Watch root component of actor for moves, rebinds if root component changed
+		 */
+		static void BindRoot(uint32 Id, FIndexedActor& Indexed, AActor* Actor);
+
+		/**
+		 * Stop watching root component of indexed actor
+		 */
+		static void UnbindRoot(FIndexedActor& Indexed);
+
+		/**
+		 * Re-bucket indexed actor moved by its root component
+		 */
+		static void OnTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, uint32 Id);
+
+		/**
+		 * Move actor id into cell of location if it changed
+		 */
+		static void UpdateCell(uint32 Id, FIndexedActor& Indexed, const FVector& Location);
+
+		/**
+		 * Remove actor id from its cell
+		 */
+		static void RemoveFromCell(uint32 Id, const FIntVector& Cell);
+
+		/**
+		 * Get grid cell of location
+		 */
+		static FIntVector GetCell(const FVector& Location);
+
+		/**
+		 * Check if actor matches query filters
+		 */
+		static bool Matches(const FActorQuery& Query, AActor* Actor);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "Service/BenchmarkService.h"
+#include "Service/PlayerService.h"
+#include "WebServer.h"
+#include "Log.h"
+#include "HttpModule.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "GameFramework/Pawn.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Serialization/JsonSerializer.h"
+
+namespace UnrealHttpServer
+{
+	IConsoleObject* FBenchmarkService::Command = nullptr;
+	FDelegateHandle FBenchmarkService::TickerHandle;
+	uint32 FBenchmarkService::RunId = 0;
+	FString FBenchmarkService::BaseUrl;
+	FString FBenchmarkService::Transport;
+	double FBenchmarkService::DurationSeconds = 5;
+	double FBenchmarkService::BaselineSeconds = 1;
+	TArray<FBenchmarkService::FBenchCase> FBenchmarkService::Cases;
+	TArray<FBenchmarkService::FBenchResult> FBenchmarkService::Results;
+	FBenchmarkService::FBenchResult FBenchmarkService::Current;
+	int32 FBenchmarkService::CaseIndex = 0;
+	FBenchmarkService::EPhase FBenchmarkService::Phase = FBenchmarkService::EPhase::Baseline;
+	double FBenchmarkService::PhaseStart = 0;
+	int32 FBenchmarkService::InFlight = 0;
+	uint32 FBenchmarkService::ListenerPort = 0;
+	TSharedPtr<FJsonObject> FBenchmarkService::LastReport;
+	FString FBenchmarkService::LastReportPath;
+
+	/* ================= Public Methods ==================== */
+
+	void FBenchmarkService::Initialize()
+	{
+		Command = IConsoleManager::Get().RegisterConsoleCommand(
+			TEXT("UHttp.Bench"),
+			TEXT("Benchmark server routes with local load: UHttp.Bench [port=N | transport=engine|socket] [duration=5] [baseline=1] [concurrency=1,8,32] [routes=/health,...]"),
+			FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+			{
+				Start(Args);
+			}));
+	}
+
+	void FBenchmarkService::Shutdown()
+	{
+		Stop();
+		if (Command != nullptr)
+		{
+			IConsoleManager::Get().UnregisterConsoleObject(Command);
+			Command = nullptr;
+		}
+	}
+
+	bool FBenchmarkService::Start(const TArray<FString>& Args)
+	{
+		if (TickerHandle.IsValid())
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Benchmark is already running!"));
+			return false;
+		}
+		FString CommandLine = FString::Join(Args, TEXT(" "));
+
+		// target the given port, or start a listener of transport on a free one
+		uint32 Port = 0;
+		Transport = TEXT("external");
+		if (!FParse::Value(*CommandLine, TEXT("port="), Port))
+		{
+			EServerTransport ServerTransport = FWebServer::GetConfiguredTransport();
+			FString TransportValue;
+			if (FParse::Value(*CommandLine, TEXT("transport="), TransportValue) && !FWebServer::ParseTransport(TransportValue, ServerTransport))
+			{
+				UE_LOG(UHttpLog, Warning, TEXT("Unknown benchmark transport: %s"), *TransportValue);
+				return false;
+			}
+			// standalone listener, so that the module server & its startup timing are untouched
+			Port = FWebServer::StartStandalone(ServerTransport);
+			if (Port == 0)
+			{
+				UE_LOG(UHttpLog, Warning, TEXT("Benchmark failed to start listener!"));
+				return false;
+			}
+			ListenerPort = Port;
+			Transport = ServerTransport == EServerTransport::Socket ? TEXT("socket") : TEXT("engine");
+		}
+		BaseUrl = FString::Printf(TEXT("http://127.0.0.1:%u"), Port);
+
+		DurationSeconds = 5;
+		BaselineSeconds = 1;
+		FParse::Value(*CommandLine, TEXT("duration="), DurationSeconds);
+		FParse::Value(*CommandLine, TEXT("baseline="), BaselineSeconds);
+		DurationSeconds = FMath::Max(0.1, DurationSeconds);
+		BaselineSeconds = FMath::Max(0.0, BaselineSeconds);
+
+		FString ConcurrencyValue = TEXT("1,8,32");
+		FString RoutesValue = TEXT("/health,/player/get_location,/player/get_rotation,/player/set_location,/player/set_rotation");
+		FParse::Value(*CommandLine, TEXT("concurrency="), ConcurrencyValue, false);
+		FParse::Value(*CommandLine, TEXT("routes="), RoutesValue, false);
+		TArray<FString> ConcurrencyLevels;
+		TArray<FString> Routes;
+		ConcurrencyValue.ParseIntoArray(ConcurrencyLevels, TEXT(","));
+		RoutesValue.ParseIntoArray(Routes, TEXT(","));
+
+		// set routes write back current transform, so that the benchmark does not move the player
+		FVector Location = FVector::ZeroVector;
+		FRotator Rotation = FRotator::ZeroRotator;
+		APawn* Pawn = FPlayerService::GetPlayerPawn();
+		if (Pawn != nullptr)
+		{
+			Location = Pawn->GetActorLocation();
+			Rotation = Pawn->GetActorRotation();
+		}
+
+		Cases.Reset();
+		for (const FString& Route : Routes)
+		{
+			FBenchCase Case;
+			Case.Path = Route;
+			Case.Verb = TEXT("GET");
+			if (Route == TEXT("/player/set_location"))
+			{
+				Case.Verb = TEXT("PUT");
+				Case.Body = FString::Printf(TEXT("{\"x\":%.17g,\"y\":%.17g,\"z\":%.17g}"), Location.X, Location.Y, Location.Z);
+			}
+			else if (Route == TEXT("/player/set_rotation"))
+			{
+				Case.Verb = TEXT("PUT");
+				Case.Body = FString::Printf(TEXT("{\"pitch\":%.17g,\"yaw\":%.17g,\"roll\":%.17g}"), Rotation.Pitch, Rotation.Yaw, Rotation.Roll);
+			}
+			for (const FString& Level : ConcurrencyLevels)
+			{
+				Case.Concurrency = FMath::Max(1, FCString::Atoi(*Level));
+				Cases.Add(Case);
+			}
+		}
+		if (Cases.Num() == 0)
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Benchmark has no cases to run!"));
+			StopListener();
+			return false;
+		}
+
+		UE_LOG(UHttpLog, Log, TEXT("Benchmark started: %s, %d cases, %.1fs each"), *BaseUrl, Cases.Num(), DurationSeconds);
+		++RunId;
+		Results.Reset();
+		LastReport.Reset();
+		LastReportPath.Empty();
+		BeginCase(0);
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FBenchmarkService::Tick));
+		return true;
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FBenchmarkService::Tick(float DeltaTime)
+	{
+		double Now = FPlatformTime::Seconds();
+		switch (Phase)
+		{
+		case EPhase::Baseline:
+			Current.BaselineFrameMs.Add(DeltaTime * 1000.0);
+			if (Now - PhaseStart >= BaselineSeconds)
+			{
+				Phase = EPhase::Run;
+				PhaseStart = Now;
+				for (int32 Index = 0; Index < Current.Case.Concurrency; ++Index)
+				{
+					SendRequest();
+				}
+			}
+			break;
+		case EPhase::Run:
+			Current.FrameMs.Add(DeltaTime * 1000.0);
+			if (Now - PhaseStart >= DurationSeconds)
+			{
+				Phase = EPhase::Drain;
+			}
+			break;
+		case EPhase::Drain:
+			if (InFlight > 0)
+			{
+				break;
+			}
+			// throughput over the whole run including drain, so that slow tails are not cut off
+			Current.Seconds = Now - PhaseStart;
+			Results.Add(MoveTemp(Current));
+			if (CaseIndex + 1 < Cases.Num())
+			{
+				BeginCase(CaseIndex + 1);
+				break;
+			}
+			Finish();
+			return false;
+		}
+		return true;
+	}
+
+	void FBenchmarkService::BeginCase(int32 Index)
+	{
+		CaseIndex = Index;
+		Current = FBenchResult();
+		Current.Case = Cases[Index];
+		Phase = EPhase::Baseline;
+		PhaseStart = FPlatformTime::Seconds();
+		InFlight = 0;
+	}
+
+	void FBenchmarkService::SendRequest()
+	{
+		auto Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(BaseUrl + Current.Case.Path);
+		Request->SetVerb(Current.Case.Verb);
+		if (!Current.Case.Body.IsEmpty())
+		{
+			Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+			Request->SetContentAsString(Current.Case.Body);
+		}
+		Request->OnProcessRequestComplete().BindStatic(&FBenchmarkService::OnRequestComplete, RunId, FPlatformTime::Seconds());
+		if (Request->ProcessRequest())
+		{
+			++InFlight;
+		}
+		else
+		{
+			++Current.Errors;
+		}
+	}
+
+	void FBenchmarkService::OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSucceeded, uint32 RequestRunId, double StartSeconds)
+	{
+		if (RequestRunId != RunId)
+		{
+			return;
+		}
+		--InFlight;
+		++Current.Requests;
+		Current.LatenciesMs.Add((FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+		if (!bSucceeded || !Response.IsValid() || Response->GetResponseCode() != 200 || !IsSuccessEnvelope(Response->GetContentAsString()))
+		{
+			++Current.Errors;
+		}
+		// keep concurrency level until the run ends
+		if (Phase == EPhase::Run)
+		{
+			SendRequest();
+		}
+	}
+
+	bool FBenchmarkService::IsSuccessEnvelope(const FString& Content)
+	{
+		// failures are responded as 200 with success false in envelope
+		TSharedPtr<FJsonObject> Envelope;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+		bool bSuccess = false;
+		return FJsonSerializer::Deserialize(Reader, Envelope) && Envelope.IsValid() && Envelope->TryGetBoolField(TEXT("success"), bSuccess) && bSuccess;
+	}
+
+	void FBenchmarkService::StopListener()
+	{
+		if (ListenerPort != 0)
+		{
+			FWebServer::StopStandalone(ListenerPort);
+			ListenerPort = 0;
+		}
+	}
+
+	void FBenchmarkService::Finish()
+	{
+		TickerHandle.Reset();
+		StopListener();
+		TArray<TSharedPtr<FJsonValue>> ResultValues;
+		for (FBenchResult& Result : Results)
+		{
+			double Throughput = Result.Seconds > 0 ? Result.Requests / Result.Seconds : 0;
+			double LatencyP50 = GetPercentile(Result.LatenciesMs, 50);
+			double LatencyP99 = GetPercentile(Result.LatenciesMs, 99);
+			double BaselineFrameP50 = GetPercentile(Result.BaselineFrameMs, 50);
+			double BaselineFrameP99 = GetPercentile(Result.BaselineFrameMs, 99);
+			double FrameP50 = GetPercentile(Result.FrameMs, 50);
+			double FrameP99 = GetPercentile(Result.FrameMs, 99);
+			UE_LOG(UHttpLog, Log, TEXT("Bench %s %s x%d: %d requests, %d errors, %.1f req/s, latency p50 %.3fms p99 %.3fms, frame p50 %.3fms (baseline %.3fms) p99 %.3fms (baseline %.3fms)"),
+				*Result.Case.Verb, *Result.Case.Path, Result.Case.Concurrency, Result.Requests, Result.Errors, Throughput,
+				LatencyP50, LatencyP99, FrameP50, BaselineFrameP50, FrameP99, BaselineFrameP99);
+
+			TSharedPtr<FJsonObject> Latency = MakeShareable(new FJsonObject());
+			Latency->SetNumberField(TEXT("p50"), LatencyP50);
+			Latency->SetNumberField(TEXT("p99"), LatencyP99);
+			Latency->SetNumberField(TEXT("max"), GetPercentile(Result.LatenciesMs, 100));
+			TSharedPtr<FJsonObject> Frame = MakeShareable(new FJsonObject());
+			Frame->SetNumberField(TEXT("baseline_p50"), BaselineFrameP50);
+			Frame->SetNumberField(TEXT("baseline_p99"), BaselineFrameP99);
+			Frame->SetNumberField(TEXT("p50"), FrameP50);
+			Frame->SetNumberField(TEXT("p99"), FrameP99);
+
+			TSharedPtr<FJsonObject> ResultObject = MakeShareable(new FJsonObject());
+			ResultObject->SetStringField(TEXT("route"), Result.Case.Path);
+			ResultObject->SetStringField(TEXT("verb"), Result.Case.Verb);
+			ResultObject->SetNumberField(TEXT("concurrency"), Result.Case.Concurrency);
+			ResultObject->SetNumberField(TEXT("requests"), Result.Requests);
+			ResultObject->SetNumberField(TEXT("errors"), Result.Errors);
+			ResultObject->SetNumberField(TEXT("seconds"), Result.Seconds);
+			ResultObject->SetNumberField(TEXT("throughput_rps"), Throughput);
+			ResultObject->SetObjectField(TEXT("latency_ms"), Latency);
+			ResultObject->SetObjectField(TEXT("frame_ms"), Frame);
+			ResultValues.Add(MakeShareable(new FJsonValueObject(ResultObject)));
+		}
+
+		FDateTime Now = FDateTime::UtcNow();
+		TSharedPtr<FJsonObject> Report = MakeShareable(new FJsonObject());
+		Report->SetStringField(TEXT("timestamp"), Now.ToIso8601());
+		Report->SetStringField(TEXT("engine_version"), FEngineVersion::Current().ToString());
+		Report->SetStringField(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+		Report->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+		Report->SetStringField(TEXT("base_url"), BaseUrl);
+		Report->SetStringField(TEXT("transport"), Transport);
+		Report->SetNumberField(TEXT("duration_seconds"), DurationSeconds);
+		Report->SetNumberField(TEXT("baseline_seconds"), BaselineSeconds);
+		Report->SetArrayField(TEXT("results"), ResultValues);
+
+		FString ReportString;
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+		FJsonSerializer::Serialize(Report.ToSharedRef(), Writer);
+		FString ReportPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("UnrealHttpServer"), TEXT("Bench"),
+			FString::Printf(TEXT("bench-%s.json"), *Now.ToString(TEXT("%Y%m%d-%H%M%S"))));
+		if (FFileHelper::SaveStringToFile(ReportString, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			UE_LOG(UHttpLog, Log, TEXT("Benchmark results written: %s"), *ReportPath);
+			LastReportPath = ReportPath;
+		}
+		else
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Failed to write benchmark results: %s"), *ReportPath);
+		}
+		LastReport = Report;
+		Results.Reset();
+		Current = FBenchResult();
+	}
+
+	void FBenchmarkService::Stop()
+	{
+		if (TickerHandle.IsValid())
+		{
+			FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+			TickerHandle.Reset();
+		}
+		StopListener();
+		++RunId;
+		Cases.Reset();
+		Results.Reset();
+		Current = FBenchResult();
+		InFlight = 0;
+	}
+
+	double FBenchmarkService::GetPercentile(TArray<double>& Samples, double Percentile)
+	{
+		if (Samples.Num() == 0)
+		{
+			return 0;
+		}
+		Samples.Sort();
+		int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile / 100.0 * Samples.Num()) - 1, 0, Samples.Num() - 1);
+		return Samples[Index];
+	}
+}
\ No newline at end of file
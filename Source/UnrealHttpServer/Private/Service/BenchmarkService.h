@@ -0,0 +1,146 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Dom/JsonObject.h"
+
+class IConsoleObject;
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Local load generator for server routes, driven by console command:
+	 *   UHttp.Bench [port=N | transport=engine|socket] [duration=5] [baseline=1] [concurrency=1,8,32] [routes=/health,/player/get_location,...]
+	 * For each route & concurrency level, keeps N requests in flight through the HTTP client for the duration,
+	 * and samples frame time before (baseline) and during the run. Without port, a standalone listener of transport is started on a free port for the run.
+	 * Results (throughput, latency & frame time percentiles) are logged and written as json into Saved/UnrealHttpServer/Bench
+	 * Automation spec UnrealHttpServer.Benchmark (Tests/BenchmarkSpec.cpp) runs /health & /player/* at 1, 8 & 32 in flight
+	 */
+	class FBenchmarkService
+	{
+	public:
+		/**
+		 * Register console command
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister console command and stop running benchmark
+		 */
+		static void Shutdown();
+
+		/**
+		 * Start benchmark with console command args, returns false if already running or args are invalid
+		 */
+		static bool Start(const TArray<FString>& Args);
+
+		static bool IsRunning() { return TickerHandle.IsValid(); }
+
+		/**
+		 * Stop running benchmark without writing results
+		 */
+		static void Stop();
+
+		/**
+		 * Get report of last finished benchmark, nullptr if none finished since start
+		 */
+		static TSharedPtr<FJsonObject> GetLastReport() { return LastReport; }
+
+		/**
+		 * Get path of last written results file, empty if none
+		 */
+		static const FString& GetLastReportPath() { return LastReportPath; }
+
+	private:
+		/**
+		 * Benchmarked request of a route at a concurrency level
+		 */
+		struct FBenchCase
+		{
+			FString Path;
+			FString Verb;
+			FString Body;
+			int32 Concurrency;
+		};
+
+		/**
+		 * Samples of a finished or running case
+		 */
+		struct FBenchResult
+		{
+			FBenchCase Case;
+			int32 Requests = 0;
+			int32 Errors = 0;
+			double Seconds = 0;
+			TArray<double> LatenciesMs;
+			TArray<double> BaselineFrameMs;
+			TArray<double> FrameMs;
+		};
+
+		enum class EPhase : uint8
+		{
+			Baseline,
+			Run,
+			Drain,
+		};
+
+		static IConsoleObject* Command;
+		static FDelegateHandle TickerHandle;
+		/* Bumped on every start & stop, completions of stale runs are ignored */
+		static uint32 RunId;
+		static FString BaseUrl;
+		/* Transport of started listener, external if port is given */
+		static FString Transport;
+		static double DurationSeconds;
+		static double BaselineSeconds;
+		static TArray<FBenchCase> Cases;
+		static TArray<FBenchResult> Results;
+		static FBenchResult Current;
+		static int32 CaseIndex;
+		static EPhase Phase;
+		static double PhaseStart;
+		static int32 InFlight;
+		/* Port of started standalone listener, 0 if external */
+		static uint32 ListenerPort;
+		static TSharedPtr<FJsonObject> LastReport;
+		static FString LastReportPath;
+
+		/**
+		 * Advance phases & sample frame time
+		 */
+		static bool Tick(float DeltaTime);
+
+		/**
+		 * Begin baseline phase of case
+		 */
+		static void BeginCase(int32 Index);
+
+		/**
+		 * Send one request of current case
+		 */
+		static void SendRequest();
+
+		static void OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSucceeded, uint32 RequestRunId, double StartSeconds);
+
+		/**
+		 * Check if response body is an envelope of success true
+		 */
+		static bool IsSuccessEnvelope(const FString& Content);
+
+		/**
+		 * Stop standalone listener of benchmark if started
+		 */
+		static void StopListener();
+
+		/**
+		 * Log results & write them into json file
+		 */
+		static void Finish();
+
+		/**
+		 * Get percentile (0~100) of samples, sorts samples in place
+		 */
+		static double GetPercentile(TArray<double>& Samples, double Percentile);
+	};
+}
\ No newline at end of file
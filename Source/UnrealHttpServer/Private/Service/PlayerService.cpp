@@ -1,42 +1,209 @@
 #include "PlayerService.h"
 #include "Log.h"
 #include "Engine.h"
+#include "GameFramework/PlayerController.h"
 
 
 namespace UnrealHttpServer
 {
+	TMap<uint64, FPlayerService::FCachedPlayer> FPlayerService::Cache;
+	FDelegateHandle FPlayerService::PostWorldInitializationHandle;
+	FDelegateHandle FPlayerService::WorldCleanupHandle;
+	FDelegateHandle FPlayerService::PostLoadMapHandle;
+
+	namespace
+	{
+		/**
+		 * Pack target into cache key
+		 */
+		uint64 GetTargetKey(const FPlayerTarget& Target)
+		{
+			return (static_cast<uint64>(static_cast<uint32>(Target.PieInstance)) << 32)
+				| (static_cast<uint64>(Target.bServer) << 31)
+				| static_cast<uint64>(Target.PlayerIndex & 0x7FFFFFFF);
+		}
+	}
+
 	/* ================= Public Methods ==================== */
 
+	void FPlayerService::Initialize()
+	{
+		PostWorldInitializationHandle = FWorldDelegates::OnPostWorldInitialization.AddLambda([](UWorld*, const UWorld::InitializationValues)
+		{
+			InvalidateCache();
+		});
+		WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld*, bool, bool)
+		{
+			InvalidateCache();
+		});
+		PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda([](UWorld*)
+		{
+			InvalidateCache();
+		});
+	}
+
+	void FPlayerService::Shutdown()
+	{
+		FWorldDelegates::OnPostWorldInitialization.Remove(PostWorldInitializationHandle);
+		FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+		FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+		InvalidateCache();
+	}
+
 	APawn* FPlayerService::GetPlayerPawn()
+	{
+		return GetPlayerPawn(FPlayerTarget());
+	}
+
+	APawn* FPlayerService::GetPlayerPawn(const FPlayerTarget& Target)
+	{
+		// hot path, the pawn is valid as long as it is still possessed by the cached controller
+		// (possession is validated here as the engine exposes no native possession-change delegate)
+		FCachedPlayer* Cached = Cache.Find(GetTargetKey(Target));
+		if (Cached != nullptr)
+		{
+			APlayerController* Controller = Cached->Controller.Get();
+			APawn* Pawn = Cached->Pawn.Get();
+			if (Controller != nullptr && Pawn != nullptr && Controller->GetPawn() == Pawn)
+			{
+				return Pawn;
+			}
+		}
+
+		APawn* PlayerPawn = Resolve(Target).Pawn.Get();
+		if (PlayerPawn == nullptr)
+		{
+			UE_LOG(UHttpLog, Verbose, TEXT("Player is not a pawn or not under control!"));
+		}
+		return PlayerPawn;
+	}
+
+	UWorld* FPlayerService::GetWorld(const FPlayerTarget& Target)
+	{
+		FCachedPlayer* Cached = Cache.Find(GetTargetKey(Target));
+		if (Cached != nullptr && Cached->World.IsValid())
+		{
+			return Cached->World.Get();
+		}
+		return Resolve(Target).World.Get();
+	}
+
+	bool FPlayerService::ParseTarget(const TMap<FString, FString>& QueryParams, FPlayerTarget& OutTarget)
+	{
+		const FString* World = QueryParams.Find(TEXT("world"));
+		const FString* Player = QueryParams.Find(TEXT("player"));
+		return ParseTarget(World != nullptr ? *World : FString(), Player != nullptr ? *Player : FString(), OutTarget);
+	}
+
+	bool FPlayerService::ParseTarget(const TSharedPtr<FJsonObject>& Params, FPlayerTarget& OutTarget)
+	{
+		FString World, Player;
+		if (Params.IsValid())
+		{
+			Params->TryGetStringField(TEXT("world"), World);
+			int32 PlayerIndex;
+			if (Params->TryGetNumberField(TEXT("player"), PlayerIndex))
+			{
+				Player = FString::FromInt(PlayerIndex);
+			}
+		}
+		return ParseTarget(World, Player, OutTarget);
+	}
+
+	/* ================= Private Methods ==================== */
+
+	FPlayerService::FCachedPlayer& FPlayerService::Resolve(const FPlayerTarget& Target)
+	{
+		FCachedPlayer& Cached = Cache.FindOrAdd(GetTargetKey(Target));
+		Cached.World = FindWorld(Target);
+		Cached.Controller = FindPlayerController(Cached.World.Get(), Target.PlayerIndex);
+		Cached.Pawn = Cached.Controller.IsValid() ? Cached.Controller->GetPawn() : nullptr;
+		return Cached;
+	}
+
+	UWorld* FPlayerService::FindWorld(const FPlayerTarget& Target)
 	{
 		if (GEngine == nullptr)
 		{
 			UE_LOG(UHttpLog, Warning, TEXT("Cannot find GEngine!"));
 			return nullptr;
 		}
-		auto WorldContexts = GEngine->GetWorldContexts();
-		if (WorldContexts.Num() == 0)
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
 		{
-			UE_LOG(UHttpLog, Warning, TEXT("No world context!"));
-			return nullptr;
+			UWorld* World = WorldContext.World();
+			if (World == nullptr || (WorldContext.WorldType != EWorldType::Game && WorldContext.WorldType != EWorldType::PIE))
+			{
+				continue;
+			}
+			if (Target.PieInstance != INDEX_NONE && WorldContext.PIEInstance != Target.PieInstance)
+			{
+				continue;
+			}
+			if (Target.bServer && World->GetNetMode() != NM_DedicatedServer && World->GetNetMode() != NM_ListenServer)
+			{
+				continue;
+			}
+			return World;
 		}
-		auto World = WorldContexts[0].World();
+		UE_LOG(UHttpLog, Verbose, TEXT("No matched game world!"));
+		return nullptr;
+	}
+
+	APlayerController* FPlayerService::FindPlayerController(UWorld* World, int32 PlayerIndex)
+	{
 		if (World == nullptr)
 		{
-			UE_LOG(UHttpLog, Warning, TEXT("No current world!"));
 			return nullptr;
 		}
-		auto FirstPlayerController = World->GetFirstPlayerController();
-		if (FirstPlayerController == nullptr)
+		int32 Index = 0;
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It, ++Index)
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, TEXT("Failed to get first player controller!"));
-			return nullptr;
+			if (Index == PlayerIndex)
+			{
+				return It->Get();
+			}
 		}
-		auto PlayerPawn = FirstPlayerController->GetPawn();
-		if (PlayerPawn == nullptr)
+		UE_LOG(UHttpLog, Verbose, TEXT("Failed to get player controller %d!"), PlayerIndex);
+		return nullptr;
+	}
+
+	bool FPlayerService::ParseTarget(const FString& World, const FString& Player, FPlayerTarget& OutTarget)
+	{
+		OutTarget = FPlayerTarget();
+		if (World == TEXT("server"))
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, TEXT("Player is not a pawn or not under control!"));
+			OutTarget.bServer = true;
 		}
-		return PlayerPawn;
+		else if (World.StartsWith(TEXT("pie:")))
+		{
+			FString Instance = World.RightChop(4);
+			if (!Instance.IsNumeric())
+			{
+				return false;
+			}
+			OutTarget.PieInstance = FCString::Atoi(*Instance);
+		}
+		else if (!World.IsEmpty())
+		{
+			return false;
+		}
+		if (!Player.IsEmpty())
+		{
+			if (!Player.IsNumeric())
+			{
+				return false;
+			}
+			OutTarget.PlayerIndex = FCString::Atoi(*Player);
+			if (OutTarget.PlayerIndex < 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void FPlayerService::InvalidateCache()
+	{
+		Cache.Reset();
 	}
 }
\ No newline at end of file
@@ -3,15 +3,106 @@
 #include "CoreMinimal.h"
 
 #include "GameFramework/Controller.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+
+class UWorld;
+class APlayerController;
 
 namespace UnrealHttpServer
 {
+	/**
+	 * Target of player requests, selects world and local player
+	 */
+	struct FPlayerTarget
+	{
+		/* PIE instance of target world, INDEX_NONE for any */
+		int32 PieInstance = INDEX_NONE;
+		/* Whether target world should be a server (dedicated or listen) world */
+		bool bServer = false;
+		/* Player controller index in target world */
+		int32 PlayerIndex = 0;
+	};
+
 	class FPlayerService
 	{
 	public:
 		/**
-		 * Get player pawn
+		 * Register world & map delegates that invalidate the cache
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister delegates and clear the cache
+		 */
+		static void Shutdown();
+
+		/**
+		 * Get player pawn (first player of first game world)
 		 */
 		static APawn* GetPlayerPawn();
+
+		/**
+		 * Get player pawn of target, cached on game thread
+		 */
+		static APawn* GetPlayerPawn(const FPlayerTarget& Target);
+
+		/**
+		 * Get world of target, cached on game thread
+		 */
+		static UWorld* GetWorld(const FPlayerTarget& Target);
+
+		/**
+		 * Parse target from query params, world: "server" | "pie:<instance>", player: <index>
+		 */
+		static bool ParseTarget(const TMap<FString, FString>& QueryParams, FPlayerTarget& OutTarget);
+
+		/**
+		 * Parse target from json params, same fields as query params
+		 */
+		static bool ParseTarget(const TSharedPtr<FJsonObject>& Params, FPlayerTarget& OutTarget);
+
+		/**
+		 * Parse target from world & player string
+		 */
+		static bool ParseTarget(const FString& World, const FString& Player, FPlayerTarget& OutTarget);
+
+	private:
+		/**
+		 * Cached weak references of resolved target
+		 */
+		struct FCachedPlayer
+		{
+			TWeakObjectPtr<UWorld> World;
+			TWeakObjectPtr<APlayerController> Controller;
+			TWeakObjectPtr<APawn> Pawn;
+		};
+
+		/* Resolved targets keyed by packed target */
+		static TMap<uint64, FCachedPlayer> Cache;
+
+		/* Delegate handles for cache invalidation */
+		static FDelegateHandle PostWorldInitializationHandle;
+		static FDelegateHandle WorldCleanupHandle;
+		static FDelegateHandle PostLoadMapHandle;
+
+		/**
+		 * Resolve target without cache
+		 */
+		static FCachedPlayer& Resolve(const FPlayerTarget& Target);
+
+		/**
+		 * Find world of target in engine world contexts
+		 */
+		static UWorld* FindWorld(const FPlayerTarget& Target);
+
+		/**
+		 * Find player controller by index in world
+		 */
+		static APlayerController* FindPlayerController(UWorld* World, int32 PlayerIndex);
+
+		/**
+		 * Clear the cache
+		 */
+		static void InvalidateCache();
 	};
 }
\ No newline at end of file
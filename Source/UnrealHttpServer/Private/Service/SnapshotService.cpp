@@ -0,0 +1,177 @@
+#include "Service/SnapshotService.h"
+#include "Log.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "Components/PrimitiveComponent.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<int32> CVarSnapshotMaxCount(
+			TEXT("UHttp.Snapshot.MaxCount"),
+			16,
+			TEXT("Max world snapshots kept in memory"));
+
+		void SerializeVector(FArchive& Ar, FVector& Vector)
+		{
+			Ar << Vector.X << Vector.Y << Vector.Z;
+		}
+
+		/**
+		 * Get simulating root primitive of actor, nullptr if not simulating physics
+		 */
+		UPrimitiveComponent* GetSimulatingRoot(AActor* Actor)
+		{
+			UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+			return Root != nullptr && Root->IsSimulatingPhysics() ? Root : nullptr;
+		}
+	}
+
+	TMap<FString, FSnapshotService::FSnapshot> FSnapshotService::Snapshots;
+	uint64 FSnapshotService::NextSerial = 0;
+
+	/* ================= Public Methods ==================== */
+
+	void FSnapshotService::Shutdown()
+	{
+		Snapshots.Empty();
+	}
+
+	int32 FSnapshotService::Capture(const FString& Id, const TArray<AActor*>& Actors, bool bVelocities)
+	{
+		FSnapshot Snapshot;
+		Snapshot.Serial = ++NextSerial;
+		Snapshot.Actors.Reserve(Actors.Num());
+		Snapshot.Blob.Reserve(12 + Actors.Num() * (bVelocities ? 64 : 40));
+
+		FMemoryWriter Writer(Snapshot.Blob);
+		uint32 Magic = MAGIC;
+		uint16 Version = VERSION;
+		uint16 Flags = bVelocities ? FLAG_VELOCITIES : 0;
+		uint32 Count = Actors.Num();
+		Writer << Magic << Version << Flags << Count;
+		for (AActor* Actor : Actors)
+		{
+			FTransform Transform = Actor->GetActorTransform();
+			FVector Location = Transform.GetLocation();
+			FQuat Rotation = Transform.GetRotation();
+			FVector Scale = Transform.GetScale3D();
+			SerializeVector(Writer, Location);
+			Writer << Rotation.X << Rotation.Y << Rotation.Z << Rotation.W;
+			SerializeVector(Writer, Scale);
+			if (bVelocities)
+			{
+				UPrimitiveComponent* Root = GetSimulatingRoot(Actor);
+				FVector LinearVelocity = Root != nullptr ? Root->GetPhysicsLinearVelocity() : Actor->GetVelocity();
+				FVector AngularVelocity = Root != nullptr ? Root->GetPhysicsAngularVelocityInDegrees() : FVector::ZeroVector;
+				SerializeVector(Writer, LinearVelocity);
+				SerializeVector(Writer, AngularVelocity);
+			}
+			Snapshot.Actors.Add(Actor);
+		}
+
+		int32 Bytes = Snapshot.Blob.Num();
+		Snapshots.Add(Id, MoveTemp(Snapshot));
+		Trim();
+		return Bytes;
+	}
+
+	bool FSnapshotService::Restore(const FString& Id, int32& OutRestored, int32& OutMissing)
+	{
+		const FSnapshot* Snapshot = Snapshots.Find(Id);
+		if (Snapshot == nullptr)
+		{
+			return false;
+		}
+		OutRestored = 0;
+		OutMissing = 0;
+
+		FMemoryReader Reader(Snapshot->Blob);
+		uint32 Magic = 0;
+		uint16 Version = 0;
+		uint16 Flags = 0;
+		uint32 Count = 0;
+		Reader << Magic << Version << Flags << Count;
+		if (Magic != MAGIC || Version != VERSION || Count != (uint32)Snapshot->Actors.Num())
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Corrupted world snapshot: %s"), *Id);
+			return false;
+		}
+		bool bVelocities = (Flags & FLAG_VELOCITIES) != 0;
+		for (const TWeakObjectPtr<AActor>& WeakActor : Snapshot->Actors)
+		{
+			FVector Location;
+			FQuat Rotation;
+			FVector Scale;
+			FVector LinearVelocity = FVector::ZeroVector;
+			FVector AngularVelocity = FVector::ZeroVector;
+			SerializeVector(Reader, Location);
+			Reader << Rotation.X << Rotation.Y << Rotation.Z << Rotation.W;
+			SerializeVector(Reader, Scale);
+			if (bVelocities)
+			{
+				SerializeVector(Reader, LinearVelocity);
+				SerializeVector(Reader, AngularVelocity);
+			}
+
+			AActor* Actor = WeakActor.Get();
+			if (Actor == nullptr || Actor->IsPendingKill())
+			{
+				++OutMissing;
+				continue;
+			}
+			// teleport resets physics state, captured velocities are applied afterwards
+			Actor->SetActorTransform(FTransform(Rotation, Location, Scale), false, nullptr, ETeleportType::ResetPhysics);
+			if (bVelocities)
+			{
+				if (UPrimitiveComponent* Root = GetSimulatingRoot(Actor))
+				{
+					Root->SetPhysicsLinearVelocity(LinearVelocity);
+					Root->SetPhysicsAngularVelocityInDegrees(AngularVelocity);
+				}
+				else if (APawn* Pawn = Cast<APawn>(Actor))
+				{
+					if (UPawnMovementComponent* MovementComponent = Pawn->GetMovementComponent())
+					{
+						MovementComponent->Velocity = LinearVelocity;
+						MovementComponent->UpdateComponentVelocity();
+					}
+				}
+			}
+			++OutRestored;
+		}
+		return true;
+	}
+
+	bool FSnapshotService::Remove(const FString& Id)
+	{
+		return Snapshots.Remove(Id) > 0;
+	}
+
+	/* ================= Private Methods ==================== */
+
+	void FSnapshotService::Trim()
+	{
+		int32 MaxCount = FMath::Max(1, CVarSnapshotMaxCount.GetValueOnGameThread());
+		while (Snapshots.Num() > MaxCount)
+		{
+			const FString* OldestId = nullptr;
+			uint64 OldestSerial = MAX_uint64;
+			for (const TPair<FString, FSnapshot>& Pair : Snapshots)
+			{
+				if (Pair.Value.Serial < OldestSerial)
+				{
+					OldestSerial = Pair.Value.Serial;
+					OldestId = &Pair.Key;
+				}
+			}
+			UE_LOG(UHttpLog, Verbose, TEXT("Dropped world snapshot: %s"), **OldestId);
+			Snapshots.Remove(FString(*OldestId));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+namespace UnrealHttpServer
+{
+	/**
+	 * In-memory world snapshots for fast resets, transforms (and optionally velocities) of actors packed in a binary blob:
+	 *   header: [magic u32][version u16][flags u16][count u32]
+	 *   entry:  [location 3 f32][rotation quat 4 f32][scale 3 f32] + [linear velocity 3 f32][angular velocity 3 f32] with velocities
+	 * Snapshots are kept up to UHttp.Snapshot.MaxCount, least recently captured ones are dropped (game thread only)
+	 */
+	class FSnapshotService
+	{
+	public:
+		/**
+		 * Clear snapshots
+		 */
+		static void Shutdown();
+
+		/**
+		 * Capture actors under id, returns blob size
+		 */
+		static int32 Capture(const FString& Id, const TArray<AActor*>& Actors, bool bVelocities);
+
+		/**
+		 * Restore snapshot in one pass, returns false if not found, outputs restored & missing actor counts
+		 */
+		static bool Restore(const FString& Id, int32& OutRestored, int32& OutMissing);
+
+		/**
+		 * Remove snapshot, returns false if not found
+		 */
+		static bool Remove(const FString& Id);
+
+	private:
+		static const uint32 MAGIC = 0x4E534855; // "UHSN"
+		static const uint16 VERSION = 1;
+		static const uint16 FLAG_VELOCITIES = 1 << 0;
+
+		/**
+		 * Stored snapshot, actors are kept in entry order
+		 */
+		struct FSnapshot
+		{
+			TArray<uint8> Blob;
+			TArray<TWeakObjectPtr<AActor>> Actors;
+			uint64 Serial = 0;
+		};
+
+		static TMap<FString, FSnapshot> Snapshots;
+		static uint64 NextSerial;
+
+		/**
+		 * Drop least recently captured snapshots over max count
+		 */
+		static void Trim();
+	};
+}
\ No newline at end of file
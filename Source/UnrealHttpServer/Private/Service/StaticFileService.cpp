@@ -0,0 +1,237 @@
+#include "Service/StaticFileService.h"
+#include "Log.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<FString> CVarStaticRoot(
+			TEXT("UHttp.Static.Root"),
+			TEXT(""),
+			TEXT("Root directory of static files, Saved/UnrealHttpServer/Static if empty"),
+			ECVF_ReadOnly);
+
+		TAutoConsoleVariable<int32> CVarStaticCacheMB(
+			TEXT("UHttp.Static.CacheMB"),
+			64,
+			TEXT("Size cap of mapped static files kept in cache (MB)"));
+
+		TAutoConsoleVariable<int32> CVarStaticMaxCachedFileMB(
+			TEXT("UHttp.Static.MaxCachedFileMB"),
+			16,
+			TEXT("Files larger than this (MB) are mapped per request and not cached"));
+
+		const TMap<FString, const TCHAR*>& GetMimeTypes()
+		{
+			static const TMap<FString, const TCHAR*> MimeTypes = {
+				{ TEXT("html"), TEXT("text/html; charset=utf-8") },
+				{ TEXT("htm"), TEXT("text/html; charset=utf-8") },
+				{ TEXT("css"), TEXT("text/css; charset=utf-8") },
+				{ TEXT("js"), TEXT("application/javascript; charset=utf-8") },
+				{ TEXT("mjs"), TEXT("application/javascript; charset=utf-8") },
+				{ TEXT("json"), TEXT("application/json") },
+				{ TEXT("map"), TEXT("application/json") },
+				{ TEXT("txt"), TEXT("text/plain; charset=utf-8") },
+				{ TEXT("log"), TEXT("text/plain; charset=utf-8") },
+				{ TEXT("csv"), TEXT("text/csv; charset=utf-8") },
+				{ TEXT("xml"), TEXT("application/xml") },
+				{ TEXT("svg"), TEXT("image/svg+xml") },
+				{ TEXT("png"), TEXT("image/png") },
+				{ TEXT("jpg"), TEXT("image/jpeg") },
+				{ TEXT("jpeg"), TEXT("image/jpeg") },
+				{ TEXT("gif"), TEXT("image/gif") },
+				{ TEXT("bmp"), TEXT("image/bmp") },
+				{ TEXT("webp"), TEXT("image/webp") },
+				{ TEXT("ico"), TEXT("image/x-icon") },
+				{ TEXT("woff"), TEXT("font/woff") },
+				{ TEXT("woff2"), TEXT("font/woff2") },
+				{ TEXT("wasm"), TEXT("application/wasm") },
+				{ TEXT("mp4"), TEXT("video/mp4") },
+				{ TEXT("webm"), TEXT("video/webm") },
+				{ TEXT("zip"), TEXT("application/zip") },
+				{ TEXT("gz"), TEXT("application/gzip") },
+			};
+			return MimeTypes;
+		}
+	}
+
+	/* ================= Static File ==================== */
+
+	FStaticFile::FStaticFile(const FString& InFilename, int64 InSize, const FDateTime& InModified)
+		: Filename(InFilename)
+		, Size(InSize)
+		, Modified(InModified)
+		, ETag(FString::Printf(TEXT("\"%llx-%llx\""), InSize, InModified.GetTicks()))
+		, MimeType(FStaticFileService::GetMimeType(InFilename))
+	{
+	}
+
+	FStaticFile::~FStaticFile()
+	{
+		delete MappedRegion;
+		delete MappedHandle;
+	}
+
+	bool FStaticFile::Open()
+	{
+		if (Size == 0)
+		{
+			return true;
+		}
+		MappedHandle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename);
+		if (MappedHandle != nullptr)
+		{
+			MappedRegion = MappedHandle->MapRegion(0, Size);
+			if (MappedRegion != nullptr && MappedRegion->GetMappedSize() == Size)
+			{
+				return true;
+			}
+			delete MappedRegion;
+			delete MappedHandle;
+			MappedRegion = nullptr;
+			MappedHandle = nullptr;
+		}
+		// platform without file mapping
+		return FFileHelper::LoadFileToArray(LoadedData, *Filename) && LoadedData.Num() == Size;
+	}
+
+	const uint8* FStaticFile::GetData() const
+	{
+		return MappedRegion != nullptr ? MappedRegion->GetMappedPtr() : LoadedData.GetData();
+	}
+
+	/* ================= Static File Service ==================== */
+
+	FString FStaticFileService::RootDir;
+	FCriticalSection FStaticFileService::CacheLock;
+	TMap<FString, FStaticFileService::FCacheEntry> FStaticFileService::Cache;
+	int64 FStaticFileService::CachedBytes = 0;
+	uint64 FStaticFileService::UseCounter = 0;
+
+	void FStaticFileService::Initialize()
+	{
+		RootDir = CVarStaticRoot.GetValueOnGameThread();
+		if (RootDir.IsEmpty())
+		{
+			RootDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("UnrealHttpServer"), TEXT("Static"));
+		}
+		RootDir = FPaths::ConvertRelativePathToFull(RootDir);
+		FPaths::NormalizeDirectoryName(RootDir);
+		UE_LOG(UHttpLog, Log, TEXT("Static files root: %s"), *RootDir);
+	}
+
+	void FStaticFileService::Shutdown()
+	{
+		FScopeLock Lock(&CacheLock);
+		Cache.Empty();
+		CachedBytes = 0;
+	}
+
+	FStaticFilePtr FStaticFileService::Open(const FString& RelativePath)
+	{
+		// reject parent segments before touching the file system
+		TArray<FString> Segments;
+		RelativePath.ParseIntoArray(Segments, TEXT("/"));
+		for (const FString& Segment : Segments)
+		{
+			if (Segment == TEXT("..") || Segment.Contains(TEXT("\\")) || Segment.Contains(TEXT(":")))
+			{
+				return nullptr;
+			}
+		}
+		if (Segments.Num() == 0)
+		{
+			Segments.Add(TEXT("index.html"));
+		}
+		FString Filename = FPaths::Combine(RootDir, FString::Join(Segments, TEXT("/")));
+		if (!FPaths::IsUnderDirectory(Filename, RootDir))
+		{
+			return nullptr;
+		}
+		FFileStatData StatData = IFileManager::Get().GetStatData(*Filename);
+		if (StatData.bIsDirectory)
+		{
+			Filename = FPaths::Combine(Filename, TEXT("index.html"));
+			StatData = IFileManager::Get().GetStatData(*Filename);
+		}
+		if (!StatData.bIsValid || StatData.bIsDirectory)
+		{
+			return nullptr;
+		}
+
+		{
+			FScopeLock Lock(&CacheLock);
+			FCacheEntry* Entry = Cache.Find(Filename);
+			if (Entry != nullptr)
+			{
+				if (Entry->File->GetSize() == StatData.FileSize && Entry->File->GetModified() == StatData.ModificationTime)
+				{
+					Entry->LastUsed = ++UseCounter;
+					return Entry->File;
+				}
+				// changed on disk
+				CachedBytes -= Entry->File->GetSize();
+				Cache.Remove(Filename);
+			}
+		}
+
+		// map out of lock, concurrent opens of a same file may both map it, the later one wins the cache
+		TSharedPtr<FStaticFile, ESPMode::ThreadSafe> File = MakeShared<FStaticFile, ESPMode::ThreadSafe>(Filename, StatData.FileSize, StatData.ModificationTime);
+		if (!File->Open())
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Failed to open static file: %s"), *Filename);
+			return nullptr;
+		}
+		int64 MaxCachedFileBytes = (int64)CVarStaticMaxCachedFileMB.GetValueOnAnyThread() * 1024 * 1024;
+		int64 MaxCacheBytes = (int64)CVarStaticCacheMB.GetValueOnAnyThread() * 1024 * 1024;
+		if (File->GetSize() <= MaxCachedFileBytes && File->GetSize() <= MaxCacheBytes)
+		{
+			FScopeLock Lock(&CacheLock);
+			FCacheEntry* Existing = Cache.Find(Filename);
+			if (Existing != nullptr)
+			{
+				CachedBytes -= Existing->File->GetSize();
+			}
+			FCacheEntry& Entry = Cache.Add(Filename);
+			Entry.File = File;
+			Entry.LastUsed = ++UseCounter;
+			CachedBytes += File->GetSize();
+			Evict(MaxCacheBytes);
+		}
+		return File;
+	}
+
+	const TCHAR* FStaticFileService::GetMimeType(const FString& Filename)
+	{
+		const TCHAR* const* MimeType = GetMimeTypes().Find(FPaths::GetExtension(Filename).ToLower());
+		return MimeType != nullptr ? *MimeType : TEXT("application/octet-stream");
+	}
+
+	/* ================= Private Methods ==================== */
+
+	void FStaticFileService::Evict(int64 MaxBytes)
+	{
+		while (CachedBytes > MaxBytes && Cache.Num() > 0)
+		{
+			const FString* OldestKey = nullptr;
+			const FCacheEntry* OldestEntry = nullptr;
+			for (const TPair<FString, FCacheEntry>& Pair : Cache)
+			{
+				if (OldestEntry == nullptr || Pair.Value.LastUsed < OldestEntry->LastUsed)
+				{
+					OldestKey = &Pair.Key;
+					OldestEntry = &Pair.Value;
+				}
+			}
+			CachedBytes -= OldestEntry->File->GetSize();
+			Cache.Remove(FString(*OldestKey));
+		}
+	}
+}
\ No newline at end of file
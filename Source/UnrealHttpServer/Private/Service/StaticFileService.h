@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Opened static file, content is memory mapped (or loaded if the platform cannot map files)
+	 * Shared by cache & in-flight responses, unmapped when the last reference is released
+	 */
+	class FStaticFile
+	{
+	public:
+		FStaticFile(const FString& InFilename, int64 InSize, const FDateTime& InModified);
+		~FStaticFile();
+
+		/**
+		 * Map or load content, returns false if failed
+		 */
+		bool Open();
+
+		const uint8* GetData() const;
+
+		int64 GetSize() const
+		{
+			return Size;
+		}
+
+		const FDateTime& GetModified() const
+		{
+			return Modified;
+		}
+
+		/* Strong validator from size & modified time */
+		const FString& GetETag() const
+		{
+			return ETag;
+		}
+
+		const FString& GetMimeType() const
+		{
+			return MimeType;
+		}
+
+	private:
+		FString Filename;
+		int64 Size;
+		FDateTime Modified;
+		FString ETag;
+		FString MimeType;
+		IMappedFileHandle* MappedHandle = nullptr;
+		IMappedFileRegion* MappedRegion = nullptr;
+		/* Fallback content if not mapped */
+		TArray<uint8> LoadedData;
+	};
+
+	typedef TSharedPtr<const FStaticFile, ESPMode::ThreadSafe> FStaticFilePtr;
+
+	/**
+	 * Static files under root directory (UHttp.Static.Root, default Saved/UnrealHttpServer/Static)
+	 * Hot files are kept mapped in a LRU cache capped by UHttp.Static.CacheMB, files are revalidated by size & modified time
+	 * Thread safe, files are opened on worker threads
+	 */
+	class FStaticFileService
+	{
+	public:
+		/**
+		 * Resolve root directory
+		 */
+		static void Initialize();
+
+		/**
+		 * Release cached files
+		 */
+		static void Shutdown();
+
+		/**
+		 * Open file of path relative to root, nullptr if not found or out of root
+		 */
+		static FStaticFilePtr Open(const FString& RelativePath);
+
+		/**
+		 * Get MIME type by file extension
+		 */
+		static const TCHAR* GetMimeType(const FString& Filename);
+
+	private:
+		struct FCacheEntry
+		{
+			FStaticFilePtr File;
+			uint64 LastUsed = 0;
+		};
+
+		static FString RootDir;
+		static FCriticalSection CacheLock;
+		static TMap<FString, FCacheEntry> Cache;
+		static int64 CachedBytes;
+		static uint64 UseCounter;
+
+		/**
+		 * Evict least recently used files over cache size cap (cache locked)
+		 */
+		static void Evict(int64 MaxBytes);
+	};
+}
\ No newline at end of file
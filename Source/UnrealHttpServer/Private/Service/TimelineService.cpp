@@ -0,0 +1,196 @@
+#include "Service/TimelineService.h"
+#include "Log.h"
+#include "Containers/Ticker.h"
+#include "Misc/Guid.h"
+
+namespace UnrealHttpServer
+{
+	TMap<FString, FTimelineService::FTimeline> FTimelineService::Timelines;
+	uint64 FTimelineService::NextSerial = 0;
+	FDelegateHandle FTimelineService::TickerHandle;
+
+	/* ================= Public Methods ==================== */
+
+	void FTimelineService::Initialize()
+	{
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FTimelineService::Tick));
+	}
+
+	void FTimelineService::Shutdown()
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		Timelines.Empty();
+	}
+
+	FString FTimelineService::Start(TArray<FTimelineStep>&& Steps, ETimelineTimebase Timebase, bool bStopOnError)
+	{
+		FString Id = FGuid::NewGuid().ToString(EGuidFormats::Digits).ToLower();
+		FTimeline& Timeline = Timelines.Add(Id);
+		Timeline.Steps = MoveTemp(Steps);
+		Timeline.Steps.StableSort([](const FTimelineStep& A, const FTimelineStep& B)
+		{
+			return A.Offset < B.Offset;
+		});
+		Timeline.Total = Timeline.Steps.Num();
+		Timeline.Timebase = Timebase;
+		Timeline.State = Timeline.Steps.Num() > 0 ? ETimelineState::Running : ETimelineState::Completed;
+		Timeline.bStopOnError = bStopOnError;
+		Timeline.Origin = GetNow(Timebase);
+		Timeline.Serial = ++NextSerial;
+		TrimFinished();
+		return Id;
+	}
+
+	bool FTimelineService::GetProgress(const FString& Id, FTimelineProgress& OutProgress)
+	{
+		const FTimeline* Timeline = Timelines.Find(Id);
+		if (Timeline == nullptr)
+		{
+			return false;
+		}
+		OutProgress.Timebase = Timeline->Timebase;
+		OutProgress.State = Timeline->State;
+		OutProgress.Total = Timeline->Total;
+		OutProgress.Executed = Timeline->NextStep;
+		OutProgress.Failed = Timeline->Failed;
+		OutProgress.Elapsed = (Timeline->State == ETimelineState::Paused ? Timeline->PausedAt : GetNow(Timeline->Timebase)) - Timeline->Origin;
+		OutProgress.LastError = Timeline->LastError;
+		return true;
+	}
+
+	bool FTimelineService::SetPaused(const FString& Id, bool bPaused)
+	{
+		FTimeline* Timeline = Timelines.Find(Id);
+		if (Timeline == nullptr)
+		{
+			return false;
+		}
+		if (bPaused && Timeline->State == ETimelineState::Running)
+		{
+			Timeline->State = ETimelineState::Paused;
+			Timeline->PausedAt = GetNow(Timeline->Timebase);
+			return true;
+		}
+		if (!bPaused && Timeline->State == ETimelineState::Paused)
+		{
+			// shift origin by paused duration, so offsets stay relative to running time
+			Timeline->State = ETimelineState::Running;
+			Timeline->Origin += GetNow(Timeline->Timebase) - Timeline->PausedAt;
+			return true;
+		}
+		return Timeline->State == ETimelineState::Running || Timeline->State == ETimelineState::Paused;
+	}
+
+	bool FTimelineService::Cancel(const FString& Id)
+	{
+		FTimeline* Timeline = Timelines.Find(Id);
+		if (Timeline == nullptr || (Timeline->State != ETimelineState::Running && Timeline->State != ETimelineState::Paused))
+		{
+			return false;
+		}
+		Timeline->State = ETimelineState::Cancelled;
+		Timeline->Steps.Empty();
+		return true;
+	}
+
+	const TCHAR* FTimelineService::GetStateName(ETimelineState State)
+	{
+		switch (State)
+		{
+		case ETimelineState::Running:
+			return TEXT("running");
+		case ETimelineState::Paused:
+			return TEXT("paused");
+		case ETimelineState::Completed:
+			return TEXT("completed");
+		case ETimelineState::Cancelled:
+			return TEXT("cancelled");
+		case ETimelineState::Failed:
+			return TEXT("failed");
+		default:
+			return TEXT("unknown");
+		}
+	}
+
+	const TCHAR* FTimelineService::GetTimebaseName(ETimelineTimebase Timebase)
+	{
+		return Timebase == ETimelineTimebase::Frame ? TEXT("frame") : TEXT("time");
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FTimelineService::Tick(float DeltaTime)
+	{
+		bool bFinished = false;
+		for (TPair<FString, FTimeline>& Pair : Timelines)
+		{
+			FTimeline& Timeline = Pair.Value;
+			if (Timeline.State != ETimelineState::Running)
+			{
+				continue;
+			}
+			double Elapsed = GetNow(Timeline.Timebase) - Timeline.Origin;
+			while (Timeline.NextStep < Timeline.Steps.Num() && Timeline.Steps[Timeline.NextStep].Offset <= Elapsed)
+			{
+				const FTimelineStep& Step = Timeline.Steps[Timeline.NextStep++];
+				TSharedPtr<FJsonObject> Data;
+				FString Message;
+				if (!(*Step.Operation)(Step.Params, Data, Message))
+				{
+					++Timeline.Failed;
+					Timeline.LastError = FString::Printf(TEXT("%s: %s"), *Step.Name, *Message);
+					UE_LOG(UHttpLog, Verbose, TEXT("Timeline %s step %d failed, %s"), *Pair.Key, Timeline.NextStep - 1, *Timeline.LastError);
+					if (Timeline.bStopOnError)
+					{
+						Timeline.State = ETimelineState::Failed;
+						break;
+					}
+				}
+			}
+			if (Timeline.State == ETimelineState::Running && Timeline.NextStep >= Timeline.Steps.Num())
+			{
+				Timeline.State = ETimelineState::Completed;
+			}
+			if (Timeline.State != ETimelineState::Running)
+			{
+				// params are not needed after finish
+				Timeline.Steps.Empty();
+				bFinished = true;
+			}
+		}
+		if (bFinished)
+		{
+			TrimFinished();
+		}
+		return true;
+	}
+
+	double FTimelineService::GetNow(ETimelineTimebase Timebase)
+	{
+		return Timebase == ETimelineTimebase::Frame ? (double)GFrameCounter : FPlatformTime::Seconds();
+	}
+
+	void FTimelineService::TrimFinished()
+	{
+		TArray<TPair<uint64, FString>> Finished;
+		for (const TPair<FString, FTimeline>& Pair : Timelines)
+		{
+			if (Pair.Value.State != ETimelineState::Running && Pair.Value.State != ETimelineState::Paused)
+			{
+				Finished.Emplace(Pair.Value.Serial, Pair.Key);
+			}
+		}
+		if (Finished.Num() <= MAX_FINISHED_TIMELINES)
+		{
+			return;
+		}
+		Finished.Sort([](const TPair<uint64, FString>& A, const TPair<uint64, FString>& B)
+		{
+			return A.Key < B.Key;
+		});
+		for (int32 Index = 0; Index < Finished.Num() - MAX_FINISHED_TIMELINES; ++Index)
+		{
+			Timelines.Remove(Finished[Index].Value);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Util/WebUtil.h"
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Timebase of timeline step offsets
+	 */
+	enum class ETimelineTimebase : uint8
+	{
+		/* Offsets in frames since start */
+		Frame,
+		/* Offsets in seconds since start */
+		Time,
+	};
+
+	enum class ETimelineState : uint8
+	{
+		Running,
+		Paused,
+		Completed,
+		Cancelled,
+		Failed,
+	};
+
+	/**
+	 * Operation of timeline executed at offset, operations come from the batch registry
+	 */
+	struct FTimelineStep
+	{
+		FString Name;
+		const FJsonOperation* Operation = nullptr;
+		TSharedPtr<FJsonObject> Params;
+		double Offset = 0;
+	};
+
+	/**
+	 * Snapshot of timeline progress
+	 */
+	struct FTimelineProgress
+	{
+		ETimelineTimebase Timebase = ETimelineTimebase::Frame;
+		ETimelineState State = ETimelineState::Running;
+		int32 Total = 0;
+		int32 Executed = 0;
+		int32 Failed = 0;
+		double Elapsed = 0;
+		FString LastError;
+	};
+
+	/**
+	 * Server-side scheduled operation timelines, steps are executed by ticker on the frame (or first frame after the time)
+	 * their offset is due, so that playback does not depend on request timing (game thread only)
+	 */
+	class FTimelineService
+	{
+	public:
+		/**
+		 * Register ticker
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister ticker & drop timelines
+		 */
+		static void Shutdown();
+
+		/**
+		 * Start timeline of steps from now, steps are sorted by offset, returns id
+		 */
+		static FString Start(TArray<FTimelineStep>&& Steps, ETimelineTimebase Timebase, bool bStopOnError);
+
+		/**
+		 * Get progress of timeline, returns false if not found
+		 */
+		static bool GetProgress(const FString& Id, FTimelineProgress& OutProgress);
+
+		/**
+		 * Pause or resume running timeline, returns false if not found or finished
+		 */
+		static bool SetPaused(const FString& Id, bool bPaused);
+
+		/**
+		 * Cancel timeline, returns false if not found or finished
+		 */
+		static bool Cancel(const FString& Id);
+
+		static const TCHAR* GetStateName(ETimelineState State);
+
+		static const TCHAR* GetTimebaseName(ETimelineTimebase Timebase);
+
+	private:
+		/* Finished timelines kept for progress queries */
+		static const int32 MAX_FINISHED_TIMELINES = 64;
+
+		struct FTimeline
+		{
+			TArray<FTimelineStep> Steps;
+			ETimelineTimebase Timebase;
+			ETimelineState State;
+			bool bStopOnError;
+			/* Steps are released when finished, count is kept */
+			int32 Total = 0;
+			int32 NextStep = 0;
+			int32 Failed = 0;
+			FString LastError;
+			/* Frame or seconds of start, moved forward by pauses */
+			double Origin = 0;
+			/* Frame or seconds when paused */
+			double PausedAt = 0;
+			uint64 Serial = 0;
+		};
+
+		static TMap<FString, FTimeline> Timelines;
+		static uint64 NextSerial;
+		static FDelegateHandle TickerHandle;
+
+		/**
+		 * Execute due steps of running timelines
+		 */
+		static bool Tick(float DeltaTime);
+
+		/**
+		 * Current frame or seconds in timebase
+		 */
+		static double GetNow(ETimelineTimebase Timebase);
+
+		/**
+		 * Drop oldest finished timelines over limit
+		 */
+		static void TrimFinished();
+	};
+}
\ No newline at end of file
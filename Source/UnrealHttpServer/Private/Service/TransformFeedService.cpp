@@ -0,0 +1,151 @@
+#include "Service/TransformFeedService.h"
+#include "Service/PlayerService.h"
+#include "Log.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/Pawn.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<float> CVarFeedLocationEpsilon(
+			TEXT("UHttp.Feed.LocationEpsilon"),
+			0.1f,
+			TEXT("Min location change (in unreal units) to publish in player transform feed"));
+
+		TAutoConsoleVariable<float> CVarFeedRotationEpsilon(
+			TEXT("UHttp.Feed.RotationEpsilon"),
+			0.1f,
+			TEXT("Min rotation change (in degrees) to publish in player transform feed"));
+
+		TAutoConsoleVariable<int32> CVarFeedMaxWatchers(
+			TEXT("UHttp.Feed.MaxWatchers"),
+			256,
+			TEXT("Max pending long-poll requests of player transform feed"));
+	}
+
+	const TCHAR* const FTransformFeedService::FIELD_NAMES[NUM_FIELDS] = {
+		TEXT("x"), TEXT("y"), TEXT("z"), TEXT("pitch"), TEXT("yaw"), TEXT("roll")
+	};
+	uint64 FTransformFeedService::Sequence = 0;
+	FTransformFeedService::FFieldState FTransformFeedService::Fields[NUM_FIELDS];
+	TArray<FTransformFeedService::FWatcher> FTransformFeedService::Watchers;
+	FDelegateHandle FTransformFeedService::TickerHandle;
+
+	/* ================= Public Methods ==================== */
+
+	void FTransformFeedService::Initialize()
+	{
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FTransformFeedService::Tick));
+	}
+
+	void FTransformFeedService::Shutdown()
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		Watchers.Empty();
+	}
+
+	void FTransformFeedService::Watch(uint64 LastSequence, double TimeoutSeconds, const FHttpResponseCallback& Respond)
+	{
+		if (!IsInGameThread())
+		{
+			FWebUtil::RunOnGameThread([LastSequence, TimeoutSeconds, Respond]()
+			{
+				Watch(LastSequence, TimeoutSeconds, Respond);
+			});
+			return;
+		}
+
+		FWatcher Watcher;
+		// a sequence ahead of the feed comes from a previous session, restart from scratch
+		Watcher.LastSequence = LastSequence > Sequence ? 0 : LastSequence;
+		Watcher.Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+		Watcher.Format = FWebUtil::GetResponseFormat();
+		Watcher.Respond = Respond;
+
+		// already behind, respond immediately
+		if (Watcher.LastSequence < Sequence)
+		{
+			RespondToWatcher(Watcher, false);
+			return;
+		}
+		if (Watchers.Num() >= CVarFeedMaxWatchers.GetValueOnGameThread())
+		{
+			FResponseFormatScope FormatScope(Watcher.Format);
+			Respond(FWebUtil::ErrorResponse(TEXT("Too many pending watchers!")));
+			return;
+		}
+		Watchers.Add(MoveTemp(Watcher));
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FTransformFeedService::Tick(float DeltaTime)
+	{
+		APawn* PlayerPawn = FPlayerService::GetPlayerPawn();
+		if (PlayerPawn != nullptr)
+		{
+			FVector Location = PlayerPawn->GetActorLocation();
+			FRotator Rotation = PlayerPawn->GetActorRotation();
+			double Samples[NUM_FIELDS] = { Location.X, Location.Y, Location.Z, Rotation.Pitch, Rotation.Yaw, Rotation.Roll };
+			double LocationEpsilon = CVarFeedLocationEpsilon.GetValueOnGameThread();
+			double RotationEpsilon = CVarFeedRotationEpsilon.GetValueOnGameThread();
+
+			// compare against published values rather than last samples, so that slow drifts are published too
+			bool bChanged = false;
+			for (int32 Index = 0; Index < NUM_FIELDS; ++Index)
+			{
+				bool bIsRotation = Index >= 3;
+				double Delta = Samples[Index] - Fields[Index].Value;
+				if (bIsRotation)
+				{
+					Delta = FRotator::NormalizeAxis(Delta);
+				}
+				if (Sequence == 0 || FMath::Abs(Delta) > (bIsRotation ? RotationEpsilon : LocationEpsilon))
+				{
+					Fields[Index].Value = Samples[Index];
+					Fields[Index].Sequence = Sequence + 1;
+					bChanged = true;
+				}
+			}
+			if (bChanged)
+			{
+				++Sequence;
+			}
+		}
+
+		// complete changed or expired watchers
+		double Now = FPlatformTime::Seconds();
+		for (int32 Index = Watchers.Num() - 1; Index >= 0; --Index)
+		{
+			const FWatcher& Watcher = Watchers[Index];
+			bool bTimeout = Now >= Watcher.Deadline;
+			if (Watcher.LastSequence < Sequence || bTimeout)
+			{
+				RespondToWatcher(Watcher, Watcher.LastSequence >= Sequence);
+				Watchers.RemoveAtSwap(Index, 1, false);
+			}
+		}
+		return true;
+	}
+
+	void FTransformFeedService::RespondToWatcher(const FWatcher& Watcher, bool bTimeout)
+	{
+		TSharedPtr<FJsonObject> Changed = MakeShareable(new FJsonObject());
+		for (int32 Index = 0; Index < NUM_FIELDS; ++Index)
+		{
+			if (Fields[Index].Sequence > Watcher.LastSequence)
+			{
+				Changed->SetNumberField(FIELD_NAMES[Index], Fields[Index].Value);
+			}
+		}
+		TSharedPtr<FJsonObject> Body = MakeShareable(new FJsonObject());
+		Body->SetNumberField(TEXT("sequence"), (double)Sequence);
+		Body->SetBoolField(TEXT("timeout"), bTimeout);
+		Body->SetObjectField(TEXT("changed"), Changed);
+
+		FResponseFormatScope FormatScope(Watcher.Format);
+		Watcher.Respond(FWebUtil::SuccessResponse(Body));
+	}
+}
\ No newline at end of file
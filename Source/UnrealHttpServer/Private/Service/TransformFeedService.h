@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Util/WebUtil.h"
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Change feed of player transform
+	 * Samples the pawn every tick, bumps the sequence when location/rotation moves past epsilon,
+	 * and completes long-poll watchers with the fields changed since their last seen sequence
+	 */
+	class FTransformFeedService
+	{
+	public:
+		/**
+		 * Register ticker
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister ticker and drop pending watchers
+		 */
+		static void Shutdown();
+
+		/**
+		 * Watch transform changes after LastSequence, responds on change or when timeout
+		 */
+		static void Watch(uint64 LastSequence, double TimeoutSeconds, const FHttpResponseCallback& Respond);
+
+	private:
+		/* Transform fields, in order of x, y, z, pitch, yaw, roll */
+		static const int32 NUM_FIELDS = 6;
+		static const TCHAR* const FIELD_NAMES[NUM_FIELDS];
+
+		/**
+		 * Published field value & sequence it last changed at
+		 */
+		struct FFieldState
+		{
+			double Value = 0;
+			uint64 Sequence = 0;
+		};
+
+		/**
+		 * Pending long-poll request
+		 */
+		struct FWatcher
+		{
+			uint64 LastSequence;
+			double Deadline;
+			EBodyFormat Format;
+			FHttpResponseCallback Respond;
+		};
+
+		/* Latest published sequence, 0 until the pawn is first sampled */
+		static uint64 Sequence;
+		static FFieldState Fields[NUM_FIELDS];
+		static TArray<FWatcher> Watchers;
+		static FDelegateHandle TickerHandle;
+
+		/**
+		 * Sample pawn transform, publish changes and complete watchers
+		 */
+		static bool Tick(float DeltaTime);
+
+		/**
+		 * Respond to watcher with fields changed after its last sequence
+		 */
+		static void RespondToWatcher(const FWatcher& Watcher, bool bTimeout);
+	};
+}
\ No newline at end of file
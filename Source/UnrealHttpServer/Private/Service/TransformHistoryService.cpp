@@ -0,0 +1,168 @@
+#include "Service/TransformHistoryService.h"
+#include "Service/PlayerService.h"
+#include "Log.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<int32> CVarHistoryCapacity(
+			TEXT("UHttp.History.Capacity"),
+			36000,
+			TEXT("Max samples of player transform history, read once at startup (36000 = 10 minutes at 60 fps)"),
+			ECVF_ReadOnly);
+	}
+
+	TArray<uint64> FTransformHistoryService::Frames;
+	TArray<double> FTransformHistoryService::Times;
+	TArray<FVector> FTransformHistoryService::Locations;
+	TArray<FRotator> FTransformHistoryService::Rotations;
+	TArray<FVector> FTransformHistoryService::Velocities;
+	int32 FTransformHistoryService::Capacity = 0;
+	int32 FTransformHistoryService::Head = 0;
+	int32 FTransformHistoryService::Count = 0;
+	FDelegateHandle FTransformHistoryService::TickerHandle;
+
+	/* ================= Public Methods ==================== */
+
+	void FTransformHistoryService::Initialize()
+	{
+		Capacity = FMath::Max(1, CVarHistoryCapacity.GetValueOnGameThread());
+		Head = 0;
+		Count = 0;
+		Frames.SetNumZeroed(Capacity);
+		Times.SetNumZeroed(Capacity);
+		Locations.SetNumZeroed(Capacity);
+		Rotations.SetNumZeroed(Capacity);
+		Velocities.SetNumZeroed(Capacity);
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FTransformHistoryService::Tick));
+	}
+
+	void FTransformHistoryService::Shutdown()
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		Frames.Empty();
+		Times.Empty();
+		Locations.Empty();
+		Rotations.Empty();
+		Velocities.Empty();
+		Capacity = 0;
+		Head = 0;
+		Count = 0;
+	}
+
+	void FTransformHistoryService::QueryByFrame(uint64 FromFrame, uint64 ToFrame, int32 Step, TArray<FTransformSample>& OutSamples)
+	{
+		int32 First, Last;
+		if (FindRange(Frames, FromFrame, ToFrame, First, Last))
+		{
+			CopyRange(First, Last, Step, OutSamples);
+		}
+	}
+
+	void FTransformHistoryService::QueryByTime(double FromTime, double ToTime, int32 Step, TArray<FTransformSample>& OutSamples)
+	{
+		int32 First, Last;
+		if (FindRange(Times, FromTime, ToTime, First, Last))
+		{
+			CopyRange(First, Last, Step, OutSamples);
+		}
+	}
+
+	int32 FTransformHistoryService::CountByFrame(uint64 FromFrame, uint64 ToFrame)
+	{
+		int32 First, Last;
+		return FindRange(Frames, FromFrame, ToFrame, First, Last) ? Last - First + 1 : 0;
+	}
+
+	int32 FTransformHistoryService::CountByTime(double FromTime, double ToTime)
+	{
+		int32 First, Last;
+		return FindRange(Times, FromTime, ToTime, First, Last) ? Last - First + 1 : 0;
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FTransformHistoryService::Tick(float DeltaTime)
+	{
+		APawn* PlayerPawn = FPlayerService::GetPlayerPawn();
+		if (PlayerPawn == nullptr || Capacity == 0)
+		{
+			return true;
+		}
+		// world time goes back to zero on map change, restart history to keep keys ascending
+		double Time = PlayerPawn->GetWorld()->GetTimeSeconds();
+		if (Count > 0 && Time < Times[GetSlot(Count - 1)])
+		{
+			Count = 0;
+		}
+		Frames[Head] = GFrameCounter;
+		Times[Head] = Time;
+		Locations[Head] = PlayerPawn->GetActorLocation();
+		Rotations[Head] = PlayerPawn->GetActorRotation();
+		Velocities[Head] = PlayerPawn->GetVelocity();
+		Head = (Head + 1) % Capacity;
+		Count = FMath::Min(Count + 1, Capacity);
+		return true;
+	}
+
+	int32 FTransformHistoryService::GetSlot(int32 Index)
+	{
+		return (Head - Count + Index + Capacity) % Capacity;
+	}
+
+	template <typename KeyType>
+	bool FTransformHistoryService::FindRange(const TArray<KeyType>& Keys, KeyType From, KeyType To, int32& OutFirst, int32& OutLast)
+	{
+		if (Count == 0 || From > To)
+		{
+			return false;
+		}
+		// lower bound of From
+		int32 Low = 0, High = Count;
+		while (Low < High)
+		{
+			int32 Mid = (Low + High) / 2;
+			if (Keys[GetSlot(Mid)] < From)
+			{
+				Low = Mid + 1;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+		OutFirst = Low;
+		// upper bound of To
+		High = Count;
+		while (Low < High)
+		{
+			int32 Mid = (Low + High) / 2;
+			if (Keys[GetSlot(Mid)] <= To)
+			{
+				Low = Mid + 1;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+		OutLast = Low - 1;
+		return OutFirst <= OutLast;
+	}
+
+	void FTransformHistoryService::CopyRange(int32 First, int32 Last, int32 Step, TArray<FTransformSample>& OutSamples)
+	{
+		Step = FMath::Max(1, Step);
+		OutSamples.Reserve(OutSamples.Num() + (Last - First) / Step + 1);
+		for (int32 Index = First; Index <= Last; Index += Step)
+		{
+			int32 Slot = GetSlot(Index);
+			OutSamples.Add(FTransformSample{ Frames[Slot], Times[Slot], Locations[Slot], Rotations[Slot], Velocities[Slot] });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Copied history sample, used to hand a range of history over to worker threads
+	 */
+	struct FTransformSample
+	{
+		uint64 Frame;
+		double Time;
+		FVector Location;
+		FRotator Rotation;
+		FVector Velocity;
+	};
+
+	/**
+	 * Per-tick history of player transform
+	 * Stored in a fixed-capacity ring buffer of separate arrays per attribute, allocated once at startup
+	 */
+	class FTransformHistoryService
+	{
+	public:
+		/**
+		 * Allocate ring buffer and register ticker
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister ticker and free ring buffer
+		 */
+		static void Shutdown();
+
+		/**
+		 * Copy samples within frame range [FromFrame, ToFrame], keeping every Step-th sample (game thread only)
+		 */
+		static void QueryByFrame(uint64 FromFrame, uint64 ToFrame, int32 Step, TArray<FTransformSample>& OutSamples);
+
+		/**
+		 * Copy samples within world time range [FromTime, ToTime], keeping every Step-th sample (game thread only)
+		 */
+		static void QueryByTime(double FromTime, double ToTime, int32 Step, TArray<FTransformSample>& OutSamples);
+
+		/**
+		 * Count samples within frame range (game thread only)
+		 */
+		static int32 CountByFrame(uint64 FromFrame, uint64 ToFrame);
+
+		/**
+		 * Count samples within world time range (game thread only)
+		 */
+		static int32 CountByTime(double FromTime, double ToTime);
+
+	private:
+		/* Ring buffer attributes, indexed by slot */
+		static TArray<uint64> Frames;
+		static TArray<double> Times;
+		static TArray<FVector> Locations;
+		static TArray<FRotator> Rotations;
+		static TArray<FVector> Velocities;
+
+		/* Ring buffer capacity, next slot to write & sample count */
+		static int32 Capacity;
+		static int32 Head;
+		static int32 Count;
+
+		static FDelegateHandle TickerHandle;
+
+		/**
+		 * Record player transform of current frame
+		 */
+		static bool Tick(float DeltaTime);
+
+		/**
+		 * Get slot of the Index-th oldest sample
+		 */
+		static int32 GetSlot(int32 Index);
+
+		/**
+		 * Find index range [OutFirst, OutLast] of samples whose key is within [From, To], keys are ascending
+		 */
+		template <typename KeyType>
+		static bool FindRange(const TArray<KeyType>& Keys, KeyType From, KeyType To, int32& OutFirst, int32& OutLast);
+
+		/**
+		 * Copy samples in index range, keeping every Step-th sample
+		 */
+		static void CopyRange(int32 First, int32 Last, int32 Step, TArray<FTransformSample>& OutSamples);
+	};
+}
\ No newline at end of file
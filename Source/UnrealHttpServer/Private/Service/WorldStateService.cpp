@@ -0,0 +1,134 @@
+#include "Service/WorldStateService.h"
+#include "Log.h"
+#include "Engine.h"
+#include "Containers/Ticker.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+
+namespace UnrealHttpServer
+{
+	FWorldState FWorldStateService::Buffers[2];
+	std::atomic<int32> FWorldStateService::Readers[2];
+	std::atomic<FWorldState*> FWorldStateService::Published(nullptr);
+	FDelegateHandle FWorldStateService::TickerHandle;
+
+	const FPublishedPlayer* FWorldState::FindPlayer(const FPlayerTarget& Target) const
+	{
+		for (int32 Index = 0; Index < NumWorlds; ++Index)
+		{
+			const FPublishedWorld& World = Worlds[Index];
+			if (Target.PieInstance != INDEX_NONE && World.PieInstance != Target.PieInstance)
+			{
+				continue;
+			}
+			if (Target.bServer && !World.bServer)
+			{
+				continue;
+			}
+			return Target.PlayerIndex < World.NumPlayers ? &Players[World.FirstPlayer + Target.PlayerIndex] : nullptr;
+		}
+		return nullptr;
+	}
+
+	FWorldStateReader::FWorldStateReader()
+		: State(nullptr)
+	{
+		// register on published buffer, then check it is still published, as the writer only skips buffers with readers
+		for (;;)
+		{
+			FWorldState* Current = FWorldStateService::Published.load();
+			if (Current == nullptr)
+			{
+				return;
+			}
+			std::atomic<int32>& Count = FWorldStateService::Readers[Current - FWorldStateService::Buffers];
+			Count.fetch_add(1);
+			if (FWorldStateService::Published.load() == Current)
+			{
+				State = Current;
+				return;
+			}
+			Count.fetch_sub(1);
+		}
+	}
+
+	FWorldStateReader::~FWorldStateReader()
+	{
+		if (State != nullptr)
+		{
+			FWorldStateService::Readers[State - FWorldStateService::Buffers].fetch_sub(1);
+		}
+	}
+
+	/* ================= Public Methods ==================== */
+
+	void FWorldStateService::Initialize()
+	{
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FWorldStateService::Tick));
+	}
+
+	void FWorldStateService::Shutdown()
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		Published.store(nullptr);
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FWorldStateService::Tick(float DeltaTime)
+	{
+		FWorldState* Current = Published.load();
+		FWorldState* Back = Current == &Buffers[0] ? &Buffers[1] : &Buffers[0];
+		if (Readers[Back - Buffers].load() != 0)
+		{
+			// a slow reader still holds the state of last swap, keep serving current state until next tick
+			UE_LOG(UHttpLog, Verbose, TEXT("World state publishing is skipped, back buffer is being read"));
+			return true;
+		}
+		Capture(*Back);
+		Published.store(Back);
+		return true;
+	}
+
+	void FWorldStateService::Capture(FWorldState& OutState)
+	{
+		OutState.Frame = GFrameCounter;
+		OutState.Time = FPlatformTime::Seconds();
+		OutState.NumWorlds = 0;
+		OutState.NumPlayers = 0;
+		if (GEngine == nullptr)
+		{
+			return;
+		}
+		// same world & player order as FPlayerService resolves targets
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+		{
+			UWorld* World = WorldContext.World();
+			if (World == nullptr || (WorldContext.WorldType != EWorldType::Game && WorldContext.WorldType != EWorldType::PIE))
+			{
+				continue;
+			}
+			if (OutState.NumWorlds == FWorldState::MAX_WORLDS)
+			{
+				break;
+			}
+			FPublishedWorld& PublishedWorld = OutState.Worlds[OutState.NumWorlds++];
+			PublishedWorld.PieInstance = WorldContext.PIEInstance;
+			PublishedWorld.bServer = World->GetNetMode() == NM_DedicatedServer || World->GetNetMode() == NM_ListenServer;
+			PublishedWorld.FirstPlayer = OutState.NumPlayers;
+			PublishedWorld.NumPlayers = 0;
+			for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It && OutState.NumPlayers < FWorldState::MAX_PLAYERS; ++It)
+			{
+				FPublishedPlayer& Player = OutState.Players[OutState.NumPlayers++];
+				++PublishedWorld.NumPlayers;
+				APlayerController* Controller = It->Get();
+				APawn* Pawn = Controller != nullptr ? Controller->GetPawn() : nullptr;
+				Player.bHasPawn = Pawn != nullptr;
+				Player.Location = Player.bHasPawn ? Pawn->GetActorLocation() : FVector::ZeroVector;
+				Player.Rotation = Player.bHasPawn ? Pawn->GetActorRotation() : FRotator::ZeroRotator;
+				Player.Velocity = Player.bHasPawn ? Pawn->GetVelocity() : FVector::ZeroVector;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Service/PlayerService.h"
+
+#include <atomic>
+
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Published state of a local player, copied from its pawn
+	 */
+	struct FPublishedPlayer
+	{
+		bool bHasPawn;
+		FVector Location;
+		FRotator Rotation;
+		FVector Velocity;
+	};
+
+	/**
+	 * Published game world & range of its players
+	 */
+	struct FPublishedWorld
+	{
+		int32 PieInstance;
+		bool bServer;
+		int32 FirstPlayer;
+		int32 NumPlayers;
+	};
+
+	/**
+	 * POD copy of world state published once per tick, immutable while readable
+	 * Read from any thread without touching UObjects
+	 */
+	struct FWorldState
+	{
+		static const int32 MAX_WORLDS = 8;
+		static const int32 MAX_PLAYERS = 64;
+
+		/* Frame (GFrameCounter) the state is copied at */
+		uint64 Frame;
+		/* Platform time the state is copied at */
+		double Time;
+		int32 NumWorlds;
+		int32 NumPlayers;
+		FPublishedWorld Worlds[MAX_WORLDS];
+		FPublishedPlayer Players[MAX_PLAYERS];
+
+		/**
+		 * Find player of target, resolved like FPlayerService (first matched world, player by controller index)
+		 */
+		const FPublishedPlayer* FindPlayer(const FPlayerTarget& Target) const;
+	};
+
+	/**
+	 * Read access of published state in scope, the state is not overwritten while held (hold it briefly)
+	 */
+	class FWorldStateReader
+	{
+	public:
+		FWorldStateReader();
+		~FWorldStateReader();
+
+		/**
+		 * Get published state, nullptr if nothing is published yet
+		 */
+		const FWorldState* Get() const { return State; }
+
+	private:
+		const FWorldState* State;
+	};
+
+	/**
+	 * Double-buffered publisher of world state
+	 * Copies state into the back buffer on ticker and swaps the published pointer, so that read routes can be
+	 * served on worker threads. Publishing is skipped for a tick if a reader still holds the back buffer
+	 */
+	class FWorldStateService
+	{
+	public:
+		/**
+		 * Register ticker
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister ticker & unpublish state
+		 */
+		static void Shutdown();
+
+	private:
+		friend class FWorldStateReader;
+
+		static FWorldState Buffers[2];
+		/* Readers holding each buffer */
+		static std::atomic<int32> Readers[2];
+		/* Published buffer, nullptr if not published */
+		static std::atomic<FWorldState*> Published;
+		static FDelegateHandle TickerHandle;
+
+		/**
+		 * Copy world state into back buffer & publish it
+		 */
+		static bool Tick(float DeltaTime);
+
+		/**
+		 * Copy state of game worlds & their players (game thread)
+		 */
+		static void Capture(FWorldState& OutState);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "Service/BenchmarkService.h"
+#include "Containers/Ticker.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealHttpServer
+{
+	BEGIN_DEFINE_SPEC(FBenchmarkSpec, "UnrealHttpServer.Benchmark",
+		EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+		FDelegateHandle TickerHandle;
+
+		/**
+		 * Run benchmark with args on a listener of free port, check report of every case when finished
+		 */
+		void RunBenchmark(const FString& Args, int32 ExpectedCases, bool bExpectNoErrors, const FDoneDelegate& Done);
+
+	END_DEFINE_SPEC(FBenchmarkSpec)
+
+	void FBenchmarkSpec::RunBenchmark(const FString& Args, int32 ExpectedCases, bool bExpectNoErrors, const FDoneDelegate& Done)
+	{
+		TArray<FString> ArgArray;
+		Args.ParseIntoArrayWS(ArgArray);
+		if (!TestTrue(TEXT("benchmark started"), FBenchmarkService::Start(ArgArray)))
+		{
+			Done.Execute();
+			return;
+		}
+		// benchmark advances on core ticker, poll it until finished
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, ExpectedCases, bExpectNoErrors, Done](float DeltaTime)
+		{
+			if (FBenchmarkService::IsRunning())
+			{
+				return true;
+			}
+			TickerHandle.Reset();
+			TSharedPtr<FJsonObject> Report = FBenchmarkService::GetLastReport();
+			if (TestTrue(TEXT("benchmark reported"), Report.IsValid()))
+			{
+				TestTrue(TEXT("results file written"), FPaths::FileExists(FBenchmarkService::GetLastReportPath()));
+				const TArray<TSharedPtr<FJsonValue>>& Results = Report->GetArrayField(TEXT("results"));
+				TestEqual(TEXT("result of every case"), Results.Num(), ExpectedCases);
+				for (const TSharedPtr<FJsonValue>& Value : Results)
+				{
+					const TSharedPtr<FJsonObject>& Result = Value->AsObject();
+					FString Name = FString::Printf(TEXT("%s %s x%d"), *Result->GetStringField(TEXT("verb")),
+						*Result->GetStringField(TEXT("route")), (int32)Result->GetNumberField(TEXT("concurrency")));
+					const TSharedPtr<FJsonObject>& Latency = Result->GetObjectField(TEXT("latency_ms"));
+					const TSharedPtr<FJsonObject>& Frame = Result->GetObjectField(TEXT("frame_ms"));
+					AddInfo(FString::Printf(TEXT("%s: %.1f req/s, %d errors, latency p50 %.3fms p99 %.3fms, frame p99 %.3fms (baseline %.3fms)"), *Name,
+						Result->GetNumberField(TEXT("throughput_rps")), (int32)Result->GetNumberField(TEXT("errors")), Latency->GetNumberField(TEXT("p50")), Latency->GetNumberField(TEXT("p99")),
+						Frame->GetNumberField(TEXT("p99")), Frame->GetNumberField(TEXT("baseline_p99"))));
+					TestTrue(Name + TEXT(" served requests"), Result->GetNumberField(TEXT("requests")) > 0);
+					if (bExpectNoErrors)
+					{
+						TestEqual(Name + TEXT(" errors"), (int32)Result->GetNumberField(TEXT("errors")), 0);
+					}
+				}
+			}
+			Done.Execute();
+			return false;
+		}));
+	}
+
+	void FBenchmarkSpec::Define()
+	{
+		Describe("Routes", [this]()
+		{
+			LatentIt("should report throughput, latency & frame time of /health at each concurrency", FTimespan::FromSeconds(60), [this](const FDoneDelegate& Done)
+			{
+				RunBenchmark(TEXT("duration=2 baseline=0.5 concurrency=1,8,32 routes=/health"), 3, true, Done);
+			});
+
+			// player routes fail (success false) without a player pawn, errors are reported but not checked
+			LatentIt("should report throughput, latency & frame time of /player/* at each concurrency", FTimespan::FromSeconds(120), [this](const FDoneDelegate& Done)
+			{
+				RunBenchmark(TEXT("duration=2 baseline=0.5 concurrency=1,8,32 routes=/player/get_location,/player/get_rotation,/player/set_location,/player/set_rotation"), 12, false, Done);
+			});
+		});
+
+		AfterEach([this]()
+		{
+			// a timed out run should not leak into next spec
+			if (TickerHandle.IsValid())
+			{
+				FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+				TickerHandle.Reset();
+			}
+			FBenchmarkService::Stop();
+		});
+	}
+}
+
+#endif
\ No newline at end of file
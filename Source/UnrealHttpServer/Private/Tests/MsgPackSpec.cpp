@@ -0,0 +1,131 @@
+#include "Util/WebUtil.h"
+#include "Util/MsgPack.h"
+#include "Model/PlayerModel.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Serialization/JsonReader.h"
+#include "Runtime/Json/Public/Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealHttpServer
+{
+	BEGIN_DEFINE_SPEC(FMsgPackSpec, "UnrealHttpServer.MsgPack",
+		EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+		/* Encode & decode rounds timed per format */
+		static const int32 ITERATIONS = 100000;
+
+		/**
+		 * Encode response envelope of struct in format, the same way typed routes do
+		 */
+		static TUniquePtr<FHttpServerResponse> EncodeEnvelope(EBodyFormat Format, const FStructCodec& Codec, const void* Data);
+
+		/**
+		 * Decode envelope body of format into json dom, as a client reading it would
+		 */
+		static TSharedPtr<FJsonObject> DecodeEnvelope(EBodyFormat Format, const TArray<uint8>& Body);
+
+		/**
+		 * Time encoding & decoding of struct envelope in both formats, report sizes & timings and check both decode to the same data
+		 */
+		void CompareFormats(const TCHAR* Name, const UScriptStruct* Struct, const void* Data);
+
+	END_DEFINE_SPEC(FMsgPackSpec)
+
+	TUniquePtr<FHttpServerResponse> FMsgPackSpec::EncodeEnvelope(EBodyFormat Format, const FStructCodec& Codec, const void* Data)
+	{
+		FResponseFormatScope FormatScope(Format);
+		return FWebUtil::SuccessResponse([&Codec, Data](FBodyWriter& Writer)
+		{
+			Codec.Write(Writer, Data);
+		}, Codec.GetSizeHint());
+	}
+
+	TSharedPtr<FJsonObject> FMsgPackSpec::DecodeEnvelope(EBodyFormat Format, const TArray<uint8>& Body)
+	{
+		TSharedPtr<FJsonObject> Envelope;
+		if (Format == EBodyFormat::MsgPack)
+		{
+			FMsgPackReader Reader(Body.GetData(), Body.Num());
+			return Reader.ReadJsonObject(Envelope) ? Envelope : nullptr;
+		}
+		FMemoryReader BodyReader(Body);
+		TSharedRef<TJsonReader<UTF8CHAR>> JsonReader = TJsonReaderFactory<UTF8CHAR>::Create(&BodyReader);
+		return FJsonSerializer::Deserialize(JsonReader, Envelope) ? Envelope : nullptr;
+	}
+
+	void FMsgPackSpec::CompareFormats(const TCHAR* Name, const UScriptStruct* Struct, const void* Data)
+	{
+		const FStructCodec& Codec = FStructCodec::Get(Struct);
+		TSharedPtr<FJsonObject> Decoded[2];
+		int32 Sizes[2];
+		double EncodeUs[2];
+		double DecodeUs[2];
+		const EBodyFormat Formats[2] = { EBodyFormat::Json, EBodyFormat::MsgPack };
+		for (int32 Index = 0; Index < 2; ++Index)
+		{
+			double EncodeStart = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < ITERATIONS; ++Iteration)
+			{
+				EncodeEnvelope(Formats[Index], Codec, Data);
+			}
+			EncodeUs[Index] = (FPlatformTime::Seconds() - EncodeStart) * 1e6 / ITERATIONS;
+
+			TUniquePtr<FHttpServerResponse> Response = EncodeEnvelope(Formats[Index], Codec, Data);
+			Sizes[Index] = Response->Body.Num();
+			double DecodeStart = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < ITERATIONS; ++Iteration)
+			{
+				DecodeEnvelope(Formats[Index], Response->Body);
+			}
+			DecodeUs[Index] = (FPlatformTime::Seconds() - DecodeStart) * 1e6 / ITERATIONS;
+			Decoded[Index] = DecodeEnvelope(Formats[Index], Response->Body);
+		}
+
+		if (!TestTrue(TEXT("json envelope decoded"), Decoded[0].IsValid()) || !TestTrue(TEXT("msgpack envelope decoded"), Decoded[1].IsValid()))
+		{
+			return;
+		}
+		const TSharedPtr<FJsonObject>* JsonData = nullptr;
+		const TSharedPtr<FJsonObject>* MsgPackData = nullptr;
+		if (TestTrue(TEXT("json data"), Decoded[0]->TryGetObjectField(TEXT("data"), JsonData))
+			&& TestTrue(TEXT("msgpack data"), Decoded[1]->TryGetObjectField(TEXT("data"), MsgPackData)))
+		{
+			for (const auto& Field : (*JsonData)->Values)
+			{
+				// msgpack keeps float32 values exact, json prints them in shortest round trip form
+				TestEqual(FString::Printf(TEXT("%s.%s"), Name, *Field.Key), (float)(*MsgPackData)->GetNumberField(Field.Key), (float)Field.Value->AsNumber());
+			}
+		}
+		AddInfo(FString::Printf(TEXT("%s: json %d B, encode %.3fus, decode %.3fus; msgpack %d B (%.0f%%), encode %.3fus, decode %.3fus"),
+			Name, Sizes[0], EncodeUs[0], DecodeUs[0], Sizes[1], Sizes[0] > 0 ? 100.0 * Sizes[1] / Sizes[0] : 0, EncodeUs[1], DecodeUs[1]));
+	}
+
+	void FMsgPackSpec::Define()
+	{
+		Describe("Player envelopes", [this]()
+		{
+			It("should report size & codec time of get_location in json & msgpack", [this]()
+			{
+				FUHttpPlayerLocation Location;
+				Location.X = 1234.5678f;
+				Location.Y = -567.89f;
+				Location.Z = 100.25f;
+				CompareFormats(TEXT("get_location"), FUHttpPlayerLocation::StaticStruct(), &Location);
+			});
+
+			It("should report size & codec time of get_rotation in json & msgpack", [this]()
+			{
+				FUHttpPlayerRotation Rotation;
+				Rotation.Pitch = -12.5f;
+				Rotation.Yaw = 87.123f;
+				Rotation.Roll = 0;
+				CompareFormats(TEXT("get_rotation"), FUHttpPlayerRotation::StaticStruct(), &Rotation);
+			});
+		});
+	}
+}
+
+#endif
\ No newline at end of file
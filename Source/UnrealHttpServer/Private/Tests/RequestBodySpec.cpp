@@ -0,0 +1,121 @@
+#include "Util/WebUtil.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Misc/AutomationTest.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Serialization/JsonReader.h"
+#include "Runtime/Json/Public/Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealHttpServer
+{
+	BEGIN_DEFINE_SPEC(FRequestBodySpec, "UnrealHttpServer.RequestBody",
+		EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+		/**
+		 * Make json request of about body size, padding comes before the number fields so that both paths read all of it
+		 */
+		static FHttpServerRequest MakeRequest(int32 BodySize);
+
+		/**
+		 * Read x, y & z in the way before streaming: copy body, widen to TCHAR string & deserialize into dom
+		 */
+		static bool ReadFieldsByDom(const FHttpServerRequest& Request, double& OutX, double& OutY, double& OutZ);
+
+		/**
+		 * Time both paths on request of body size & check they read the same values
+		 */
+		void CompareReadPaths(int32 BodySize);
+
+	END_DEFINE_SPEC(FRequestBodySpec)
+
+	FHttpServerRequest FRequestBodySpec::MakeRequest(int32 BodySize)
+	{
+		static const FString FIELDS = TEXT("\"x\":1234.5,\"y\":-0.25,\"z\":98765");
+		FString Json = FString::Printf(TEXT("{\"padding\":\"%s\",%s}"),
+			*FString::ChrN(FMath::Max(0, BodySize - FIELDS.Len() - 15), TEXT('a')), *FIELDS);
+		FTCHARToUTF8 Utf8(*Json);
+
+		FHttpServerRequest Request;
+		Request.Verb = EHttpServerRequestVerbs::VERB_PUT;
+		Request.Headers.Add(TEXT("content-type"), { TEXT("application/json; charset=utf-8") });
+		Request.Body.Append((const uint8*)Utf8.Get(), Utf8.Length());
+		return Request;
+	}
+
+	bool FRequestBodySpec::ReadFieldsByDom(const FHttpServerRequest& Request, double& OutX, double& OutY, double& OutZ)
+	{
+		TArray<uint8> RequestBodyBytes = Request.Body;
+		RequestBodyBytes.Add(0);
+		FString RequestBodyString = FString(UTF8_TO_TCHAR(RequestBodyBytes.GetData()));
+		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(RequestBodyString);
+		TSharedPtr<FJsonObject> RequestBody;
+		if (!FJsonSerializer::Deserialize(JsonReader, RequestBody) || !RequestBody.IsValid())
+		{
+			return false;
+		}
+		return RequestBody->TryGetNumberField(TEXT("x"), OutX)
+			&& RequestBody->TryGetNumberField(TEXT("y"), OutY)
+			&& RequestBody->TryGetNumberField(TEXT("z"), OutZ);
+	}
+
+	void FRequestBodySpec::CompareReadPaths(int32 BodySize)
+	{
+		FHttpServerRequest Request = MakeRequest(BodySize);
+		// about 64MB read per path, at least a few rounds for large bodies
+		int32 Iterations = FMath::Clamp((64 * 1024 * 1024) / Request.Body.Num(), 8, 100000);
+
+		double DomX = 0, DomY = 0, DomZ = 0;
+		double DomStart = FPlatformTime::Seconds();
+		bool bDomRead = true;
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			bDomRead &= ReadFieldsByDom(Request, DomX, DomY, DomZ);
+		}
+		double DomSeconds = FPlatformTime::Seconds() - DomStart;
+
+		double X = 0, Y = 0, Z = 0;
+		const FJsonNumberField Fields[] = { { TEXT("x"), &X }, { TEXT("y"), &Y }, { TEXT("z"), &Z } };
+		double StreamStart = FPlatformTime::Seconds();
+		bool bStreamRead = true;
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			bStreamRead &= FWebUtil::ReadRequestNumberFields(Request, Fields);
+		}
+		double StreamSeconds = FPlatformTime::Seconds() - StreamStart;
+
+		TestTrue(TEXT("dom path read fields"), bDomRead);
+		TestTrue(TEXT("streaming path read fields"), bStreamRead);
+		TestEqual(TEXT("x"), X, DomX);
+		TestEqual(TEXT("y"), Y, DomY);
+		TestEqual(TEXT("z"), Z, DomZ);
+
+		double DomUs = DomSeconds * 1e6 / Iterations;
+		double StreamUs = StreamSeconds * 1e6 / Iterations;
+		AddInfo(FString::Printf(TEXT("%d bytes x%d: dom %.2fus, streaming %.2fus, %.2fx"),
+			Request.Body.Num(), Iterations, DomUs, StreamUs, StreamUs > 0 ? DomUs / StreamUs : 0));
+	}
+
+	void FRequestBodySpec::Define()
+	{
+		Describe("ReadRequestNumberFields", [this]()
+		{
+			It("should read the same fields as the dom path with a 100B body", [this]()
+			{
+				CompareReadPaths(100);
+			});
+
+			It("should read the same fields as the dom path with a 10KB body", [this]()
+			{
+				CompareReadPaths(10 * 1024);
+			});
+
+			It("should read the same fields as the dom path with a 1MB body", [this]()
+			{
+				CompareReadPaths(1024 * 1024);
+			});
+		});
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,943 @@
+#include "Transport/SocketServer.h"
+#include "Log.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/ScopeLock.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "Runtime/Online/HTTPServer/Public/HttpPath.h"
+#include "Runtime/Online/HTTPServer/Public/HttpRouteHandle.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerResponse.h"
+
+#include <atomic>
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<int32> CVarSocketServerWorkers(
+			TEXT("UHttp.SocketServer.Workers"),
+			4,
+			TEXT("Worker threads of socket server to parse requests & serialize responses, applied on start"));
+
+		TAutoConsoleVariable<float> CVarSocketServerKeepAliveSeconds(
+			TEXT("UHttp.SocketServer.KeepAliveSeconds"),
+			30.0f,
+			TEXT("Idle seconds before a persistent connection of socket server is closed"));
+
+		/* Max bytes of request line & headers */
+		const int32 MAX_HEADER_BYTES = 64 * 1024;
+
+		/* Max bytes of request body */
+		const int32 MAX_BODY_BYTES = 16 * 1024 * 1024;
+
+		/* Max requests of a connection being handled at a time, pipelined requests over it wait in buffer */
+		const int32 MAX_PIPELINED_REQUESTS = 32;
+
+		/* Max accepted connections */
+		const int32 MAX_CONNECTIONS = 1024;
+
+		/* Bytes of a socket read */
+		const int32 RECV_CHUNK_BYTES = 16 * 1024;
+
+		/* Idle loops of I/O thread before it sleeps between polls */
+		const int32 IDLE_SPIN_LOOPS = 64;
+
+		/**
+		 * Work item of worker pool
+		 */
+		class FSocketServerWork : public IQueuedWork
+		{
+		public:
+			FSocketServerWork(TUniqueFunction<void()>&& InTask)
+				: Task(MoveTemp(InTask))
+			{
+			}
+
+			virtual void DoThreadedWork() override
+			{
+				Task();
+				delete this;
+			}
+
+			virtual void Abandon() override
+			{
+				delete this;
+			}
+
+		private:
+			TUniqueFunction<void()> Task;
+		};
+
+		/**
+		 * Router of socket server, paths are matched like engine routers do (bound parent path matches child paths)
+		 * Bound & queried on game thread
+		 */
+		class FSocketRouter : public IHttpRouter
+		{
+		public:
+			virtual FHttpRouteHandle BindRoute(const FHttpPath& HttpPath, const EHttpServerRequestVerbs& HttpVerbs, const FHttpRequestHandler& Handler) override
+			{
+				const FString& Path = HttpPath.GetPath();
+				if (Routes.Contains(Path))
+				{
+					return nullptr;
+				}
+				FHttpRouteHandle RouteHandle = MakeShared<FHttpRouteHandleInternal>(Path, HttpVerbs, Handler);
+				Routes.Add(Path, RouteHandle);
+				return RouteHandle;
+			}
+
+			virtual void UnbindRoute(const FHttpRouteHandle& RouteHandle) override
+			{
+				if (RouteHandle.IsValid())
+				{
+					Routes.Remove(RouteHandle->Path);
+				}
+			}
+
+			FHttpRouteHandle FindRoute(FString Path) const
+			{
+				while (!Path.IsEmpty())
+				{
+					const FHttpRouteHandle* RouteHandle = Routes.Find(Path);
+					if (RouteHandle != nullptr)
+					{
+						return *RouteHandle;
+					}
+					int32 SlashIndex;
+					if (!Path.FindLastChar(TEXT('/'), SlashIndex) || SlashIndex == 0)
+					{
+						break;
+					}
+					Path.LeftInline(SlashIndex, false);
+				}
+				const FHttpRouteHandle* RootHandle = Routes.Find(TEXT("/"));
+				return RootHandle != nullptr ? *RootHandle : nullptr;
+			}
+
+		private:
+			TMap<FString, FHttpRouteHandle> Routes;
+		};
+
+		/**
+		 * Serialized response waiting to be sent in order
+		 */
+		struct FReadyResponse
+		{
+			TArray<uint8> Head;
+			TArray<uint8> Body;
+			bool bClose = false;
+		};
+
+		/**
+		 * Accepted connection, socket & send state are owned by I/O thread, buffers under lock are shared with workers
+		 */
+		struct FSocketConnection
+		{
+			FSocket* Socket = nullptr;
+			double LastActiveSeconds = 0;
+
+			/* I/O thread only */
+			TArray<TArray<uint8>> SendQueue;
+			int32 SendOffset = 0;
+			uint64 NextSendSequence = 0;
+			bool bCloseAfterSend = false;
+			bool bPeerClosed = false;
+
+			/* Requests parsed & not yet sent */
+			std::atomic<int32> PendingRequests{ 0 };
+
+			FCriticalSection Lock;
+			/* Received bytes not taken by parser yet */
+			TArray<uint8> Inbox;
+			/* Bytes taken by parser, only touched by the scheduled parse task */
+			TArray<uint8> ParseBuffer;
+			/* A parse task is scheduled */
+			bool bParsing = false;
+			/* Parser stopped at a close or invalid request, further bytes are ignored */
+			bool bParseClosed = false;
+			/* Sequence of next parsed request, only touched by the scheduled parse task */
+			uint64 NextRequestSequence = 0;
+			TMap<uint64, FReadyResponse> ReadyResponses;
+		};
+
+		typedef TSharedPtr<FSocketConnection, ESPMode::ThreadSafe> FSocketConnectionPtr;
+		typedef TWeakPtr<FSocketConnection, ESPMode::ThreadSafe> FSocketConnectionWeakPtr;
+
+		enum class EParseResult : uint8
+		{
+			Incomplete,
+			Parsed,
+			Invalid,
+		};
+
+		const TCHAR* GetReasonPhrase(int32 Code)
+		{
+			switch (Code)
+			{
+			case 200: return TEXT("OK");
+			case 204: return TEXT("No Content");
+			case 206: return TEXT("Partial Content");
+			case 304: return TEXT("Not Modified");
+			case 400: return TEXT("Bad Request");
+			case 404: return TEXT("Not Found");
+			case 413: return TEXT("Payload Too Large");
+			case 416: return TEXT("Range Not Satisfiable");
+			case 429: return TEXT("Too Many Requests");
+			case 500: return TEXT("Internal Server Error");
+			case 501: return TEXT("Not Implemented");
+			case 503: return TEXT("Service Unavailable");
+			case 505: return TEXT("HTTP Version Not Supported");
+			default: return TEXT("Unknown");
+			}
+		}
+
+		TUniquePtr<FHttpServerResponse> CreateStatusResponse(EHttpServerResponseCodes Code)
+		{
+			TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+			Response->Code = Code;
+			return Response;
+		}
+
+		EHttpServerRequestVerbs ParseVerb(const FString& Method)
+		{
+			if (Method.Equals(TEXT("GET"), ESearchCase::CaseSensitive))
+			{
+				return EHttpServerRequestVerbs::VERB_GET;
+			}
+			if (Method.Equals(TEXT("POST"), ESearchCase::CaseSensitive))
+			{
+				return EHttpServerRequestVerbs::VERB_POST;
+			}
+			if (Method.Equals(TEXT("PUT"), ESearchCase::CaseSensitive))
+			{
+				return EHttpServerRequestVerbs::VERB_PUT;
+			}
+			if (Method.Equals(TEXT("DELETE"), ESearchCase::CaseSensitive))
+			{
+				return EHttpServerRequestVerbs::VERB_DELETE;
+			}
+			if (Method.Equals(TEXT("PATCH"), ESearchCase::CaseSensitive))
+			{
+				return EHttpServerRequestVerbs::VERB_PATCH;
+			}
+			if (Method.Equals(TEXT("OPTIONS"), ESearchCase::CaseSensitive))
+			{
+				return EHttpServerRequestVerbs::VERB_OPTIONS;
+			}
+			return EHttpServerRequestVerbs::VERB_NONE;
+		}
+
+		/**
+		 * Parse one request from the front of buffer, consumed bytes & error status are set if parsed or invalid
+		 */
+		EParseResult ParseRequest(const uint8* Data, int32 Num, int32& OutConsumed, FHttpServerRequest& OutRequest, bool& bOutKeepAlive, EHttpServerResponseCodes& OutErrorCode)
+		{
+			// find end of headers
+			int32 HeaderEnd = INDEX_NONE;
+			for (int32 Index = 0; Index + 3 < Num && Index < MAX_HEADER_BYTES; ++Index)
+			{
+				if (Data[Index] == '\r' && Data[Index + 1] == '\n' && Data[Index + 2] == '\r' && Data[Index + 3] == '\n')
+				{
+					HeaderEnd = Index;
+					break;
+				}
+			}
+			if (HeaderEnd == INDEX_NONE)
+			{
+				if (Num >= MAX_HEADER_BYTES)
+				{
+					OutErrorCode = EHttpServerResponseCodes::RequestTooLarge;
+					return EParseResult::Invalid;
+				}
+				return EParseResult::Incomplete;
+			}
+
+			FUTF8ToTCHAR HeaderConverter(reinterpret_cast<const ANSICHAR*>(Data), HeaderEnd);
+			FString HeaderString(HeaderConverter.Length(), HeaderConverter.Get());
+			TArray<FString> Lines;
+			HeaderString.ParseIntoArray(Lines, TEXT("\r\n"));
+			OutErrorCode = EHttpServerResponseCodes::BadRequest;
+			if (Lines.Num() == 0)
+			{
+				return EParseResult::Invalid;
+			}
+
+			// request line
+			TArray<FString> RequestLine;
+			Lines[0].ParseIntoArrayWS(RequestLine);
+			if (RequestLine.Num() != 3)
+			{
+				return EParseResult::Invalid;
+			}
+			const FString& Version = RequestLine[2];
+			if (Version != TEXT("HTTP/1.1") && Version != TEXT("HTTP/1.0"))
+			{
+				OutErrorCode = EHttpServerResponseCodes::VersionNotSup;
+				return EParseResult::Invalid;
+			}
+			OutRequest.Verb = ParseVerb(RequestLine[0]);
+			if (OutRequest.Verb == EHttpServerRequestVerbs::VERB_NONE)
+			{
+				OutErrorCode = EHttpServerResponseCodes::NotSupported;
+				return EParseResult::Invalid;
+			}
+			FString Path = RequestLine[1];
+			FString Query;
+			RequestLine[1].Split(TEXT("?"), &Path, &Query);
+			OutRequest.RelativePath = FHttpPath(FGenericPlatformHttp::UrlDecode(Path));
+			if (!Query.IsEmpty())
+			{
+				TArray<FString> Params;
+				Query.ParseIntoArray(Params, TEXT("&"));
+				for (const FString& Param : Params)
+				{
+					FString Key = Param;
+					FString Value;
+					Param.Split(TEXT("="), &Key, &Value);
+					OutRequest.QueryParams.Add(FGenericPlatformHttp::UrlDecode(Key), FGenericPlatformHttp::UrlDecode(Value));
+				}
+			}
+
+			// headers, values are split by comma like engine listeners do
+			for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+			{
+				FString Name;
+				FString Value;
+				if (!Lines[LineIndex].Split(TEXT(":"), &Name, &Value))
+				{
+					return EParseResult::Invalid;
+				}
+				TArray<FString> Values;
+				Value.ParseIntoArray(Values, TEXT(","));
+				TArray<FString>& HeaderValues = OutRequest.Headers.FindOrAdd(Name.TrimStartAndEnd());
+				for (FString& HeaderValue : Values)
+				{
+					HeaderValues.Add(HeaderValue.TrimStartAndEnd());
+				}
+			}
+
+			if (OutRequest.Headers.Contains(TEXT("transfer-encoding")))
+			{
+				OutErrorCode = EHttpServerResponseCodes::NotSupported;
+				return EParseResult::Invalid;
+			}
+			int64 ContentLength = 0;
+			const TArray<FString>* ContentLengthValues = OutRequest.Headers.Find(TEXT("content-length"));
+			if (ContentLengthValues != nullptr && ContentLengthValues->Num() > 0)
+			{
+				if (!(*ContentLengthValues)[0].IsNumeric())
+				{
+					return EParseResult::Invalid;
+				}
+				ContentLength = FCString::Atoi64(*(*ContentLengthValues)[0]);
+			}
+			if (ContentLength < 0 || ContentLength > MAX_BODY_BYTES)
+			{
+				OutErrorCode = EHttpServerResponseCodes::RequestTooLarge;
+				return EParseResult::Invalid;
+			}
+			int32 BodyStart = HeaderEnd + 4;
+			if (Num - BodyStart < ContentLength)
+			{
+				return EParseResult::Incomplete;
+			}
+			OutRequest.Body.Append(Data + BodyStart, (int32)ContentLength);
+			OutConsumed = BodyStart + (int32)ContentLength;
+
+			// HTTP/1.1 connections persist unless closed, HTTP/1.0 ones need keep-alive
+			bOutKeepAlive = Version == TEXT("HTTP/1.1");
+			const TArray<FString>* ConnectionValues = OutRequest.Headers.Find(TEXT("connection"));
+			if (ConnectionValues != nullptr)
+			{
+				for (const FString& ConnectionValue : *ConnectionValues)
+				{
+					if (ConnectionValue == TEXT("close"))
+					{
+						bOutKeepAlive = false;
+					}
+					else if (ConnectionValue == TEXT("keep-alive"))
+					{
+						bOutKeepAlive = true;
+					}
+				}
+			}
+			return EParseResult::Parsed;
+		}
+
+		/**
+		 * Serialize status line & headers, body is moved as is
+		 */
+		void SerializeResponse(FHttpServerResponse& Response, bool bClose, FReadyResponse& OutResponse)
+		{
+			int32 Code = (int32)Response.Code;
+			FString Head = FString::Printf(TEXT("HTTP/1.1 %d %s\r\n"), Code, GetReasonPhrase(Code));
+			for (const TPair<FString, TArray<FString>>& Header : Response.Headers)
+			{
+				if (Header.Key == TEXT("content-length") || Header.Key == TEXT("connection"))
+				{
+					continue;
+				}
+				Head += Header.Key + TEXT(": ") + FString::Join(Header.Value, TEXT(", ")) + TEXT("\r\n");
+			}
+			Head += FString::Printf(TEXT("content-length: %d\r\nconnection: %s\r\n\r\n"), Response.Body.Num(), bClose ? TEXT("close") : TEXT("keep-alive"));
+			FTCHARToUTF8 HeadConverter(*Head, Head.Len());
+			OutResponse.Head.Append(reinterpret_cast<const uint8*>(HeadConverter.Get()), HeadConverter.Length());
+			OutResponse.Body = MoveTemp(Response.Body);
+			OutResponse.bClose = bClose;
+		}
+
+		/**
+		 * Listener, I/O thread & worker pool of a started server
+		 */
+		class FSocketServerRunner : public FRunnable, public TSharedFromThis<FSocketServerRunner, ESPMode::ThreadSafe>
+		{
+		public:
+			FSocketServerRunner()
+				: Router(MakeShared<FSocketRouter>())
+				, WakeEvent(FPlatformProcess::GetSynchEventFromPool(false))
+				, bStopping(false)
+			{
+			}
+
+			virtual ~FSocketServerRunner()
+			{
+				FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+			}
+
+			bool Listen(uint32 InPort, const FString& BindAddress)
+			{
+				ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+				if (SocketSubsystem == nullptr)
+				{
+					return false;
+				}
+				Listener = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("UHttpSocketServer"), false);
+				if (Listener == nullptr)
+				{
+					return false;
+				}
+				TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+				Address->SetAnyAddress();
+				if (!BindAddress.IsEmpty() && BindAddress != TEXT("any"))
+				{
+					bool bValid = false;
+					Address->SetIp(*BindAddress, bValid);
+					if (!bValid)
+					{
+						UE_LOG(UHttpLog, Warning, TEXT("Socket server got invalid bind address: %s"), *BindAddress);
+						SocketSubsystem->DestroySocket(Listener);
+						Listener = nullptr;
+						return false;
+					}
+				}
+				Address->SetPort(InPort);
+				Listener->SetReuseAddr(true);
+				if (!Listener->Bind(*Address) || !Listener->Listen(128) || !Listener->SetNonBlocking(true))
+				{
+					SocketSubsystem->DestroySocket(Listener);
+					Listener = nullptr;
+					return false;
+				}
+				Port = Listener->GetPortNo();
+
+				Pool = FQueuedThreadPool::Allocate();
+				Pool->Create(FMath::Max(1, CVarSocketServerWorkers.GetValueOnGameThread()), 64 * 1024, TPri_Normal);
+				Thread = FRunnableThread::Create(this, TEXT("UHttpSocketServer"), 0, TPri_AboveNormal);
+				return true;
+			}
+
+			void Shutdown()
+			{
+				if (Thread != nullptr)
+				{
+					Thread->Kill(true);
+					delete Thread;
+					Thread = nullptr;
+				}
+				// destroy pool out of lock, running work may still add work
+				FQueuedThreadPool* StoppedPool = nullptr;
+				{
+					FScopeLock PoolLock(&PoolMutex);
+					Swap(StoppedPool, Pool);
+				}
+				if (StoppedPool != nullptr)
+				{
+					StoppedPool->Destroy();
+					delete StoppedPool;
+				}
+				ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+				for (FSocketConnectionPtr& Connection : Connections)
+				{
+					CloseConnection(*Connection);
+				}
+				Connections.Reset();
+				if (Listener != nullptr)
+				{
+					Listener->Close();
+					SocketSubsystem->DestroySocket(Listener);
+					Listener = nullptr;
+				}
+			}
+
+			uint32 GetPort() const
+			{
+				return Port;
+			}
+
+			TSharedRef<FSocketRouter> GetRouter() const
+			{
+				return Router;
+			}
+
+			virtual uint32 Run() override
+			{
+				int32 IdleLoops = 0;
+				while (!bStopping)
+				{
+					bool bActive = AcceptConnections();
+					double Now = FPlatformTime::Seconds();
+					double KeepAliveSeconds = CVarSocketServerKeepAliveSeconds.GetValueOnAnyThread();
+					for (int32 Index = Connections.Num() - 1; Index >= 0; --Index)
+					{
+						FSocketConnection& Connection = *Connections[Index];
+						bActive |= ReadConnection(Connections[Index].ToSharedRef(), Now);
+						bActive |= WriteConnection(Connections[Index].ToSharedRef(), Now);
+						if (ShouldClose(Connection, Now, KeepAliveSeconds))
+						{
+							CloseConnection(Connection);
+							Connections.RemoveAtSwap(Index);
+						}
+					}
+
+					// the socket subsystem has no multiplexed wait, spin a while after activity then poll with short sleeps,
+					// queued responses wake the thread immediately
+					if (bActive)
+					{
+						IdleLoops = 0;
+					}
+					else if (++IdleLoops < IDLE_SPIN_LOOPS)
+					{
+						FPlatformProcess::Sleep(0);
+					}
+					else
+					{
+						WakeEvent->Wait(1);
+					}
+				}
+				return 0;
+			}
+
+			virtual void Stop() override
+			{
+				bStopping = true;
+				WakeEvent->Trigger();
+			}
+
+			/**
+			 * Queue response of a request, serialized on worker pool
+			 */
+			void QueueResponse(const FSocketConnectionWeakPtr& WeakConnection, uint64 Sequence, bool bClose, TUniquePtr<FHttpServerResponse>&& Response)
+			{
+				if (Response == nullptr)
+				{
+					Response = CreateStatusResponse(EHttpServerResponseCodes::ServerError);
+				}
+				TWeakPtr<FSocketServerRunner, ESPMode::ThreadSafe> WeakRunner = AsShared();
+				AddWork([WeakRunner, WeakConnection, Sequence, bClose, Response = MoveTemp(Response)]() mutable
+				{
+					TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> Runner = WeakRunner.Pin();
+					if (Runner.IsValid())
+					{
+						Runner->CompleteResponse(WeakConnection, Sequence, bClose, *Response);
+					}
+				});
+			}
+
+		private:
+			TSharedRef<FSocketRouter> Router;
+			FSocket* Listener = nullptr;
+			uint32 Port = 0;
+			FRunnableThread* Thread = nullptr;
+			FEvent* WakeEvent;
+			std::atomic<bool> bStopping;
+			FCriticalSection PoolMutex;
+			FQueuedThreadPool* Pool = nullptr;
+			/* I/O thread only */
+			TArray<FSocketConnectionPtr> Connections;
+
+			void AddWork(TUniqueFunction<void()>&& Task)
+			{
+				FScopeLock PoolLock(&PoolMutex);
+				if (Pool != nullptr)
+				{
+					Pool->AddQueuedWork(new FSocketServerWork(MoveTemp(Task)));
+				}
+			}
+
+			bool AcceptConnections()
+			{
+				bool bAccepted = false;
+				bool bHasPendingConnection = false;
+				while (Connections.Num() < MAX_CONNECTIONS && Listener->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+				{
+					FSocket* Socket = Listener->Accept(TEXT("UHttpSocketConnection"));
+					if (Socket == nullptr)
+					{
+						break;
+					}
+					Socket->SetNonBlocking(true);
+					Socket->SetNoDelay(true);
+					FSocketConnectionPtr Connection = MakeShared<FSocketConnection, ESPMode::ThreadSafe>();
+					Connection->Socket = Socket;
+					Connection->LastActiveSeconds = FPlatformTime::Seconds();
+					Connections.Add(Connection);
+					bAccepted = true;
+				}
+				return bAccepted;
+			}
+
+			bool ReadConnection(const TSharedRef<FSocketConnection, ESPMode::ThreadSafe>& Connection, double Now)
+			{
+				if (Connection->bPeerClosed || Connection->bCloseAfterSend)
+				{
+					return false;
+				}
+				uint8 Buffer[RECV_CHUNK_BYTES];
+				bool bReceived = false;
+				while (true)
+				{
+					// stop reading while pipelined requests are piled up, the peer is throttled by tcp window
+					{
+						FScopeLock ConnectionLock(&Connection->Lock);
+						if (Connection->Inbox.Num() >= MAX_HEADER_BYTES + MAX_BODY_BYTES)
+						{
+							break;
+						}
+					}
+					int32 BytesRead = 0;
+					if (!Connection->Socket->Recv(Buffer, RECV_CHUNK_BYTES, BytesRead))
+					{
+						Connection->bPeerClosed = true;
+						break;
+					}
+					if (BytesRead <= 0)
+					{
+						break;
+					}
+					FScopeLock ConnectionLock(&Connection->Lock);
+					Connection->Inbox.Append(Buffer, BytesRead);
+					bReceived = true;
+				}
+				if (bReceived)
+				{
+					Connection->LastActiveSeconds = Now;
+					ScheduleParse(Connection);
+				}
+				return bReceived;
+			}
+
+			bool WriteConnection(const TSharedRef<FSocketConnection, ESPMode::ThreadSafe>& Connection, double Now)
+			{
+				// take ready responses in request order
+				bool bTaken = false;
+				if (!Connection->bCloseAfterSend)
+				{
+					FScopeLock ConnectionLock(&Connection->Lock);
+					while (!Connection->bCloseAfterSend)
+					{
+						FReadyResponse* ReadyResponse = Connection->ReadyResponses.Find(Connection->NextSendSequence);
+						if (ReadyResponse == nullptr)
+						{
+							break;
+						}
+						FReadyResponse Response = MoveTemp(*ReadyResponse);
+						Connection->ReadyResponses.Remove(Connection->NextSendSequence);
+						++Connection->NextSendSequence;
+						--Connection->PendingRequests;
+						Connection->SendQueue.Add(MoveTemp(Response.Head));
+						if (Response.Body.Num() > 0)
+						{
+							Connection->SendQueue.Add(MoveTemp(Response.Body));
+						}
+						Connection->bCloseAfterSend = Response.bClose;
+						bTaken = true;
+					}
+				}
+				if (bTaken)
+				{
+					// more pipelined requests may be parsed now
+					ScheduleParse(Connection);
+				}
+
+				bool bSent = false;
+				while (Connection->SendQueue.Num() > 0)
+				{
+					TArray<uint8>& Bytes = Connection->SendQueue[0];
+					int32 BytesSent = 0;
+					if (!Connection->Socket->Send(Bytes.GetData() + Connection->SendOffset, Bytes.Num() - Connection->SendOffset, BytesSent))
+					{
+						ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+						if (SocketSubsystem->GetLastErrorCode() != SE_EWOULDBLOCK)
+						{
+							// drop unsent responses, the connection is closed as peer closed
+							Connection->bPeerClosed = true;
+							Connection->bCloseAfterSend = true;
+							Connection->SendQueue.Reset();
+							Connection->SendOffset = 0;
+						}
+						break;
+					}
+					if (BytesSent <= 0)
+					{
+						break;
+					}
+					bSent = true;
+					Connection->SendOffset += BytesSent;
+					if (Connection->SendOffset >= Bytes.Num())
+					{
+						Connection->SendQueue.RemoveAt(0, 1, false);
+						Connection->SendOffset = 0;
+					}
+				}
+				if (bSent)
+				{
+					Connection->LastActiveSeconds = Now;
+				}
+				return bTaken || bSent;
+			}
+
+			bool ShouldClose(const FSocketConnection& Connection, double Now, double KeepAliveSeconds) const
+			{
+				if (Connection.SendQueue.Num() > 0)
+				{
+					return false;
+				}
+				// responses after a close are not sent
+				if (Connection.bCloseAfterSend)
+				{
+					return true;
+				}
+				if (Connection.PendingRequests > 0)
+				{
+					return false;
+				}
+				return Connection.bPeerClosed || Now - Connection.LastActiveSeconds > KeepAliveSeconds;
+			}
+
+			void CloseConnection(FSocketConnection& Connection)
+			{
+				if (Connection.Socket == nullptr)
+				{
+					return;
+				}
+				Connection.Socket->Close();
+				ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Connection.Socket);
+				Connection.Socket = nullptr;
+			}
+
+			void ScheduleParse(const TSharedRef<FSocketConnection, ESPMode::ThreadSafe>& Connection)
+			{
+				{
+					FScopeLock ConnectionLock(&Connection->Lock);
+					if (Connection->bParsing || Connection->bParseClosed || (Connection->Inbox.Num() == 0 && Connection->ParseBuffer.Num() == 0))
+					{
+						return;
+					}
+					Connection->bParsing = true;
+				}
+				TWeakPtr<FSocketServerRunner, ESPMode::ThreadSafe> WeakRunner = AsShared();
+				AddWork([WeakRunner, Connection]()
+				{
+					TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> Runner = WeakRunner.Pin();
+					if (Runner.IsValid())
+					{
+						Runner->ParseRequests(Connection);
+					}
+				});
+			}
+
+			/**
+			 * Parse buffered requests of connection & dispatch them to game thread (worker pool)
+			 */
+			void ParseRequests(const TSharedRef<FSocketConnection, ESPMode::ThreadSafe>& Connection)
+			{
+				while (true)
+				{
+					{
+						FScopeLock ConnectionLock(&Connection->Lock);
+						Connection->ParseBuffer.Append(Connection->Inbox);
+						Connection->Inbox.Reset();
+					}
+
+					int32 Offset = 0;
+					bool bClosed = false;
+					bool bIncomplete = false;
+					while (!bClosed && Connection->PendingRequests < MAX_PIPELINED_REQUESTS)
+					{
+						FHttpServerRequestRef Request = MakeShared<FHttpServerRequest, ESPMode::ThreadSafe>();
+						int32 Consumed = 0;
+						bool bKeepAlive = false;
+						EHttpServerResponseCodes ErrorCode = EHttpServerResponseCodes::BadRequest;
+						EParseResult Result = ParseRequest(Connection->ParseBuffer.GetData() + Offset, Connection->ParseBuffer.Num() - Offset, Consumed, *Request, bKeepAlive, ErrorCode);
+						if (Result == EParseResult::Incomplete)
+						{
+							bIncomplete = true;
+							break;
+						}
+						uint64 Sequence = Connection->NextRequestSequence++;
+						++Connection->PendingRequests;
+						FSocketConnectionWeakPtr WeakConnection = Connection;
+						if (Result == EParseResult::Invalid)
+						{
+							bClosed = true;
+							UE_LOG(UHttpLog, Verbose, TEXT("socket server caught invalid request, code: %d"), (int32)ErrorCode);
+							QueueResponse(WeakConnection, Sequence, true, CreateStatusResponse(ErrorCode));
+							break;
+						}
+						Offset += Consumed;
+						bClosed = !bKeepAlive;
+						Dispatch(WeakConnection, Sequence, bClosed, Request);
+					}
+					Connection->ParseBuffer.RemoveAt(0, bClosed ? Connection->ParseBuffer.Num() : Offset, false);
+
+					FScopeLock ConnectionLock(&Connection->Lock);
+					Connection->bParseClosed |= bClosed;
+					// stopped at pipeline limit with complete requests left: responses drained meanwhile could not reschedule
+					// while parsing, so only exit if still at limit (the drain after it reschedules) or nothing is left to parse
+					if (Connection->bParseClosed || (Connection->Inbox.Num() == 0 && (bIncomplete || Connection->PendingRequests >= MAX_PIPELINED_REQUESTS)))
+					{
+						Connection->bParsing = false;
+						break;
+					}
+				}
+				WakeEvent->Trigger();
+			}
+
+			/**
+			 * Route request to bound handler on game thread
+			 */
+			void Dispatch(const FSocketConnectionWeakPtr& WeakConnection, uint64 Sequence, bool bClose, const FHttpServerRequestRef& Request)
+			{
+				TWeakPtr<FSocketServerRunner, ESPMode::ThreadSafe> WeakRunner = AsShared();
+				AsyncTask(ENamedThreads::GameThread, [WeakRunner, WeakConnection, Sequence, bClose, Request]()
+				{
+					TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> Runner = WeakRunner.Pin();
+					if (!Runner.IsValid() || !WeakConnection.IsValid())
+					{
+						return;
+					}
+					FHttpResultCallback OnComplete = [WeakRunner, WeakConnection, Sequence, bClose](TUniquePtr<FHttpServerResponse>&& Response)
+					{
+						TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> CompletedRunner = WeakRunner.Pin();
+						if (CompletedRunner.IsValid())
+						{
+							CompletedRunner->QueueResponse(WeakConnection, Sequence, bClose, MoveTemp(Response));
+						}
+					};
+					FHttpRouteHandle RouteHandle = Runner->Router->FindRoute(Request->RelativePath.GetPath());
+					if (RouteHandle == nullptr || !EnumHasAnyFlags(RouteHandle->Verbs, Request->Verb) || !RouteHandle->Handler(*Request, OnComplete))
+					{
+						OnComplete(CreateStatusResponse(EHttpServerResponseCodes::NotFound));
+					}
+				});
+			}
+
+			/**
+			 * Serialize response & hand it to I/O thread (worker pool)
+			 */
+			void CompleteResponse(const FSocketConnectionWeakPtr& WeakConnection, uint64 Sequence, bool bClose, FHttpServerResponse& Response)
+			{
+				FSocketConnectionPtr Connection = WeakConnection.Pin();
+				if (!Connection.IsValid())
+				{
+					return;
+				}
+				FReadyResponse ReadyResponse;
+				SerializeResponse(Response, bClose, ReadyResponse);
+				{
+					FScopeLock ConnectionLock(&Connection->Lock);
+					Connection->ReadyResponses.Add(Sequence, MoveTemp(ReadyResponse));
+				}
+				WakeEvent->Trigger();
+			}
+		};
+
+		TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> GRunner;
+
+		/* Standalone servers by bound port */
+		TMap<uint32, TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe>> GStandaloneRunners;
+	}
+
+	TSharedPtr<IHttpRouter> FSocketServer::Start(uint32 Port, const FString& BindAddress)
+	{
+		if (GRunner.IsValid())
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Socket server is already running on port %u!"), GRunner->GetPort());
+			return nullptr;
+		}
+		TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> Runner = MakeShared<FSocketServerRunner, ESPMode::ThreadSafe>();
+		if (!Runner->Listen(Port, BindAddress))
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Socket server failed to listen on port %u!"), Port);
+			Runner->Shutdown();
+			return nullptr;
+		}
+		GRunner = Runner;
+		UE_LOG(UHttpLog, Log, TEXT("Socket server listening on port %u"), Runner->GetPort());
+		return Runner->GetRouter();
+	}
+
+	void FSocketServer::Stop()
+	{
+		if (!GRunner.IsValid())
+		{
+			return;
+		}
+		// stop threads before releasing, pending tasks hold weak references only
+		GRunner->Shutdown();
+		GRunner.Reset();
+	}
+
+	bool FSocketServer::IsRunning()
+	{
+		return GRunner.IsValid();
+	}
+
+	uint32 FSocketServer::GetPort()
+	{
+		return GRunner.IsValid() ? GRunner->GetPort() : 0;
+	}
+
+	TSharedPtr<IHttpRouter> FSocketServer::StartStandalone(uint32 Port, uint32& OutPort)
+	{
+		TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> Runner = MakeShared<FSocketServerRunner, ESPMode::ThreadSafe>();
+		if (!Runner->Listen(Port, FString()))
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Standalone socket server failed to listen on port %u!"), Port);
+			Runner->Shutdown();
+			return nullptr;
+		}
+		OutPort = Runner->GetPort();
+		GStandaloneRunners.Add(OutPort, Runner);
+		UE_LOG(UHttpLog, Log, TEXT("Standalone socket server listening on port %u"), OutPort);
+		return Runner->GetRouter();
+	}
+
+	void FSocketServer::StopStandalone(uint32 Port)
+	{
+		TSharedPtr<FSocketServerRunner, ESPMode::ThreadSafe> Runner;
+		if (GStandaloneRunners.RemoveAndCopyValue(Port, Runner))
+		{
+			Runner->Shutdown();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Online/HTTPServer/Public/IHttpRouter.h"
+
+namespace UnrealHttpServer
+{
+	/**
+	 * HTTP/1.1 server on engine socket subsystem, an alternative transport of engine HTTPServer listeners
+	 * - persistent connections & pipelining, responses are sent in request order
+	 * - one I/O thread polls non-blocking sockets for readiness, accepts, reads & writes
+	 * - a fixed worker pool parses requests & serializes responses
+	 * - routed handlers are the same request handlers bound to engine routers, called on game thread
+	 * Tuned by UHttp.SocketServer.* console variables
+	 */
+	class FSocketServer
+	{
+	public:
+		/**
+		 * Start listening on port (0 for an ephemeral one) of bind address (empty or any for all interfaces),
+		 * returns router to bind handlers, nullptr if failed or already running
+		 */
+		static TSharedPtr<IHttpRouter> Start(uint32 Port, const FString& BindAddress = FString());
+
+		/**
+		 * Stop listening, close connections & stop threads
+		 */
+		static void Stop();
+
+		/**
+		 * Check if server is running
+		 */
+		static bool IsRunning();
+
+		/**
+		 * Get bound port of running server, 0 if not running
+		 */
+		static uint32 GetPort();
+
+		/**
+		 * Start a standalone server besides the one above (e.g. benchmark listener) on port (0 for an ephemeral one) of local interfaces,
+		 * returns router to bind handlers & outputs bound port, nullptr if failed
+		 */
+		static TSharedPtr<IHttpRouter> StartStandalone(uint32 Port, uint32& OutPort);
+
+		/**
+		 * Stop standalone server of bound port
+		 */
+		static void StopStandalone(uint32 Port);
+	};
+}
\ No newline at end of file
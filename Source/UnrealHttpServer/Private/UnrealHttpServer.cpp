@@ -1,7 +1,22 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "UnrealHttpServer.h"
+#include "Engine/Engine.h"
+#include "Misc/CoreDelegates.h"
 #include "WebServer.h"
+#include "WebSocketServer.h"
+#include "Util/MutationQueue.h"
+#include "Util/AccessLog.h"
+#include "Util/StartupTiming.h"
+#include "Service/PlayerService.h"
+#include "Service/TransformFeedService.h"
+#include "Service/TransformHistoryService.h"
+#include "Service/ActorIndexService.h"
+#include "Service/BenchmarkService.h"
+#include "Service/SnapshotService.h"
+#include "Service/TimelineService.h"
+#include "Service/StaticFileService.h"
+#include "Service/WorldStateService.h"
 
 
 #define LOCTEXT_NAMESPACE "FUnrealHttpServerModule"
@@ -9,19 +24,75 @@
 void FUnrealHttpServerModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	UnrealHttpServer::FStartupTiming::MarkModuleLoaded();
+	UnrealHttpServer::FAccessLog::Initialize();
+	UnrealHttpServer::FMutationQueue::Initialize();
+	UnrealHttpServer::FPlayerService::Initialize();
+	UnrealHttpServer::FTransformFeedService::Initialize();
+	UnrealHttpServer::FTransformHistoryService::Initialize();
+	UnrealHttpServer::FActorIndexService::Initialize();
+	UnrealHttpServer::FBenchmarkService::Initialize();
+	UnrealHttpServer::FTimelineService::Initialize();
+	UnrealHttpServer::FStaticFileService::Initialize();
+	UnrealHttpServer::FWorldStateService::Initialize();
 	UnrealHttpServer::FWebServer::Stop();
-	if (!GIsEditor)
+	Port = 0;
+	WebSocketPort = 0;
+	if (GIsEditor)
 	{
-		Port = DEFAULT_PORT;
-		UnrealHttpServer::FWebServer::Start(Port);
+		return;
 	}
+	// module is loaded before engine init, servers are started after it unless early start is configured (headless)
+	UnrealHttpServer::FServerConfig Config = UnrealHttpServer::FWebServer::LoadConfig(DEFAULT_PORT, DEFAULT_WEBSOCKET_PORT);
+	if (Config.bEarlyStart || (GEngine != nullptr && GEngine->IsInitialized()))
+	{
+		StartServers(Config);
+	}
+	else
+	{
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([this, Config]()
+		{
+			StartServers(Config);
+		});
+	}
+}
+
+void FUnrealHttpServerModule::StartServers(const UnrealHttpServer::FServerConfig& Config)
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	PostEngineInitHandle.Reset();
+	if (!UnrealHttpServer::FWebServer::Start(Config))
+	{
+		return;
+	}
+	Port = UnrealHttpServer::FWebServer::GetPort();
+	WebSocketPort = Config.WebSocketPort != 0 ? Config.WebSocketPort : UnrealHttpServer::FWebServer::FindFreePort();
+	if (!UnrealHttpServer::FWebSocketServer::Start(WebSocketPort))
+	{
+		WebSocketPort = 0;
+	}
+	UnrealHttpServer::FWebServer::WritePortFile(Config.PortFile, Port, WebSocketPort);
 }
 
 void FUnrealHttpServerModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that supporWt dynamic reloading,
 	// we call this function before unloading the module.
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	PostEngineInitHandle.Reset();
+	UnrealHttpServer::FWebSocketServer::Stop();
 	UnrealHttpServer::FWebServer::Stop();
+	UnrealHttpServer::FWorldStateService::Shutdown();
+	UnrealHttpServer::FStaticFileService::Shutdown();
+	UnrealHttpServer::FTimelineService::Shutdown();
+	UnrealHttpServer::FBenchmarkService::Shutdown();
+	UnrealHttpServer::FSnapshotService::Shutdown();
+	UnrealHttpServer::FActorIndexService::Shutdown();
+	UnrealHttpServer::FTransformHistoryService::Shutdown();
+	UnrealHttpServer::FTransformFeedService::Shutdown();
+	UnrealHttpServer::FPlayerService::Shutdown();
+	UnrealHttpServer::FMutationQueue::Shutdown();
+	UnrealHttpServer::FAccessLog::Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
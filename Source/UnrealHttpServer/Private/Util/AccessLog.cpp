@@ -0,0 +1,234 @@
+#include "Util/AccessLog.h"
+#include "Util/RouteMetrics.h"
+#include "Log.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Serialization/Archive.h"
+
+namespace UnrealHttpServer
+{
+#if UHTTP_WITH_ACCESS_LOG
+	namespace
+	{
+		TAutoConsoleVariable<int32> CVarAccessLogVerbosity(
+			TEXT("UHttp.AccessLog.Verbosity"),
+			1,
+			TEXT("Access log verbosity, 0: off, 1: errors only, 2: sampled requests, 3: sampled requests with timing breakdown"));
+
+		TAutoConsoleVariable<int32> CVarAccessLogSampleEvery(
+			TEXT("UHttp.AccessLog.SampleEvery"),
+			1,
+			TEXT("Record 1 of every N successful requests in access log (errors are always recorded)"));
+
+		/* Ring buffer capacity, power of 2 */
+		const uint32 RING_CAPACITY = 8192;
+
+		/* Writer thread wakes up at this interval if not signaled */
+		const uint32 FLUSH_INTERVAL_MS = 200;
+
+		/**
+		 * Bounded multi-producer ring buffer slot, sequence tells if the slot is writable or readable for a position
+		 */
+		struct FSlot
+		{
+			std::atomic<uint64> Sequence;
+			FAccessLogEntry Entry;
+		};
+
+		FSlot GSlots[RING_CAPACITY];
+		std::atomic<uint64> GWritePosition(0);
+		uint64 GReadPosition = 0;
+		std::atomic<uint64> GSampleCounter(0);
+		std::atomic<uint64> GDropped(0);
+
+		/**
+		 * Background writer of access log file
+		 */
+		class FAccessLogWriter : public FRunnable
+		{
+		public:
+			FAccessLogWriter(FArchive* InFile)
+				: File(InFile)
+				, WakeEvent(FPlatformProcess::GetSynchEventFromPool(false))
+				, bStopping(false)
+			{
+			}
+
+			virtual ~FAccessLogWriter()
+			{
+				FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+			}
+
+			virtual uint32 Run() override
+			{
+				while (!bStopping)
+				{
+					WakeEvent->Wait(FLUSH_INTERVAL_MS);
+					Drain();
+				}
+				Drain();
+				return 0;
+			}
+
+			virtual void Stop() override
+			{
+				bStopping = true;
+				WakeEvent->Trigger();
+			}
+
+		private:
+			FArchive* File;
+			FEvent* WakeEvent;
+			std::atomic<bool> bStopping;
+
+			/**
+			 * Write all readable entries and flush file
+			 */
+			void Drain()
+			{
+				FString Lines;
+				while (true)
+				{
+					FSlot& Slot = GSlots[GReadPosition & (RING_CAPACITY - 1)];
+					if (Slot.Sequence.load(std::memory_order_acquire) != GReadPosition + 1)
+					{
+						break;
+					}
+					AppendLine(Lines, Slot.Entry);
+					// release the slot for the position one lap ahead
+					Slot.Sequence.store(GReadPosition + RING_CAPACITY, std::memory_order_release);
+					++GReadPosition;
+				}
+				uint64 Dropped = GDropped.exchange(0);
+				if (Dropped > 0)
+				{
+					Lines += FString::Printf(TEXT("{\"time\":\"%s\",\"dropped\":%llu}\n"), *FDateTime::UtcNow().ToIso8601(), Dropped);
+				}
+				if (Lines.IsEmpty())
+				{
+					return;
+				}
+				FTCHARToUTF8 Converter(*Lines, Lines.Len());
+				File->Serialize(const_cast<ANSICHAR*>(Converter.Get()), Converter.Length());
+				File->Flush();
+			}
+
+			static void AppendLine(FString& Lines, const FAccessLogEntry& Entry)
+			{
+				Lines += FString::Printf(TEXT("{\"time\":\"%s\",\"verb\":\"%s\",\"route\":\"%s\",\"code\":%d,\"error\":%s,\"bytes_in\":%u,\"bytes_out\":%u,\"us\":%u"),
+					*FDateTime(Entry.Ticks).ToIso8601(), *Entry.Route->Verb, *Entry.Route->Path, Entry.Code,
+					Entry.bError ? TEXT("true") : TEXT("false"), Entry.BytesIn, Entry.BytesOut, Entry.TotalMicroseconds);
+				if (CVarAccessLogVerbosity.GetValueOnAnyThread() >= 3)
+				{
+					Lines += FString::Printf(TEXT(",\"parse_us\":%u,\"serialize_us\":%u"), Entry.ParseMicroseconds, Entry.SerializeMicroseconds);
+				}
+				Lines += TEXT("}\n");
+			}
+		};
+
+		FArchive* GFile = nullptr;
+		FAccessLogWriter* GWriter = nullptr;
+		FRunnableThread* GWriterThread = nullptr;
+	}
+#endif
+
+	void FAccessLog::Initialize()
+	{
+#if UHTTP_WITH_ACCESS_LOG
+		for (uint32 Index = 0; Index < RING_CAPACITY; ++Index)
+		{
+			GSlots[Index].Sequence.store(Index, std::memory_order_relaxed);
+		}
+		GWritePosition = 0;
+		GReadPosition = 0;
+		FString Path = FPaths::Combine(FPaths::ProjectLogDir(), TEXT("UnrealHttpServer-access.log"));
+		GFile = IFileManager::Get().CreateFileWriter(*Path, FILEWRITE_Append | FILEWRITE_AllowRead);
+		if (GFile == nullptr)
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Failed to open access log: %s"), *Path);
+			return;
+		}
+		GWriter = new FAccessLogWriter(GFile);
+		GWriterThread = FRunnableThread::Create(GWriter, TEXT("UHttpAccessLog"), 0, TPri_BelowNormal);
+#endif
+	}
+
+	void FAccessLog::Shutdown()
+	{
+#if UHTTP_WITH_ACCESS_LOG
+		if (GWriterThread != nullptr)
+		{
+			GWriterThread->Kill(true);
+			delete GWriterThread;
+			GWriterThread = nullptr;
+		}
+		delete GWriter;
+		GWriter = nullptr;
+		delete GFile;
+		GFile = nullptr;
+#endif
+	}
+
+	void FAccessLog::Record(const FAccessLogEntry& Entry)
+	{
+#if UHTTP_WITH_ACCESS_LOG
+		if (GWriter == nullptr)
+		{
+			return;
+		}
+		// claim a position whose slot has been released by the writer, drop the entry if the ring is full
+		uint64 Position = GWritePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			FSlot& Slot = GSlots[Position & (RING_CAPACITY - 1)];
+			uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+			if (Sequence == Position)
+			{
+				if (GWritePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+				{
+					Slot.Entry = Entry;
+					Slot.Sequence.store(Position + 1, std::memory_order_release);
+					return;
+				}
+			}
+			else if (Sequence < Position)
+			{
+				GDropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+			{
+				Position = GWritePosition.load(std::memory_order_relaxed);
+			}
+		}
+#endif
+	}
+
+	bool FAccessLog::ShouldRecord(bool bError)
+	{
+#if UHTTP_WITH_ACCESS_LOG
+		int32 Verbosity = CVarAccessLogVerbosity.GetValueOnAnyThread();
+		if (Verbosity <= 0 || GWriter == nullptr)
+		{
+			return false;
+		}
+		if (bError)
+		{
+			return true;
+		}
+		if (Verbosity < 2)
+		{
+			return false;
+		}
+		int32 SampleEvery = FMath::Max(1, CVarAccessLogSampleEvery.GetValueOnAnyThread());
+		return GSampleCounter.fetch_add(1, std::memory_order_relaxed) % SampleEvery == 0;
+#else
+		return false;
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+/* Access log is compiled out in shipping builds */
+#ifndef UHTTP_WITH_ACCESS_LOG
+#define UHTTP_WITH_ACCESS_LOG !UE_BUILD_SHIPPING
+#endif
+
+
+namespace UnrealHttpServer
+{
+	struct FRouteMetrics;
+
+	/**
+	 * Access log entry of one request (plain data, so that recording does not allocate)
+	 */
+	struct FAccessLogEntry
+	{
+		/* UTC ticks of completion */
+		int64 Ticks;
+		/* Registered routes live until shutdown */
+		const FRouteMetrics* Route;
+		int32 Code;
+		bool bError;
+		uint32 BytesIn;
+		uint32 BytesOut;
+		uint32 TotalMicroseconds;
+		uint32 ParseMicroseconds;
+		uint32 SerializeMicroseconds;
+	};
+
+	/**
+	 * Structured access log, one json line per sampled request in Saved/Logs/UnrealHttpServer-access.log
+	 * Entries are recorded into a bounded lock-free ring buffer (dropped when full) and written by a background thread
+	 * Tuned by UHttp.AccessLog.* console variables, compiled out in shipping builds
+	 */
+	class FAccessLog
+	{
+	public:
+		/**
+		 * Open log file & start writer thread
+		 */
+		static void Initialize();
+
+		/**
+		 * Stop writer thread, flush pending entries & close log file
+		 */
+		static void Shutdown();
+
+		/**
+		 * Record entry of a completed request (any thread, lock free)
+		 */
+		static void Record(const FAccessLogEntry& Entry);
+
+		/**
+		 * Check if entry of a request will be recorded, by verbosity & sampling
+		 */
+		static bool ShouldRecord(bool bError);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "Util/BodyWriter.h"
+#include "Util/JsonStreamWriter.h"
+#include "Util/MsgPack.h"
+
+namespace UnrealHttpServer
+{
+	TUniquePtr<FBodyWriter> FBodyWriter::Create(EBodyFormat Format, int32 InitialCapacity)
+	{
+		switch (Format)
+		{
+		case EBodyFormat::MsgPack:
+			return MakeUnique<FMsgPackWriter>(InitialCapacity);
+		default:
+			return MakeUnique<FJsonStreamWriter>(InitialCapacity);
+		}
+	}
+
+	void FBodyWriter::WriteIdentifier(const TCHAR* Identifier)
+	{
+		WriteIdentifier(Identifier, FCString::Strlen(Identifier));
+	}
+
+	void FBodyWriter::WriteIdentifier(const FString& Identifier)
+	{
+		WriteIdentifier(*Identifier, Identifier.Len());
+	}
+
+	void FBodyWriter::WriteValue(const TCHAR* Value)
+	{
+		WriteValue(Value, FCString::Strlen(Value));
+	}
+
+	void FBodyWriter::WriteValue(const FString& Value)
+	{
+		WriteValue(*Value, Value.Len());
+	}
+
+	void FBodyWriter::WriteJsonValue(const TSharedPtr<FJsonValue>& Value)
+	{
+		if (!Value.IsValid())
+		{
+			WriteNull();
+			return;
+		}
+		switch (Value->Type)
+		{
+		case EJson::String:
+			WriteValue(Value->AsString());
+			break;
+		case EJson::Number:
+			WriteValue(Value->AsNumber());
+			break;
+		case EJson::Boolean:
+			WriteValue(Value->AsBool());
+			break;
+		case EJson::Array:
+		{
+			const TArray<TSharedPtr<FJsonValue>>& Elements = Value->AsArray();
+			WriteArrayStart(Elements.Num());
+			for (const TSharedPtr<FJsonValue>& Element : Elements)
+			{
+				WriteJsonValue(Element);
+			}
+			WriteArrayEnd();
+			break;
+		}
+		case EJson::Object:
+			WriteJsonObject(Value->AsObject());
+			break;
+		default:
+			WriteNull();
+			break;
+		}
+	}
+
+	void FBodyWriter::WriteJsonObject(const TSharedPtr<FJsonObject>& Object)
+	{
+		if (!Object.IsValid())
+		{
+			WriteNull();
+			return;
+		}
+		WriteObjectStart(Object->Values.Num());
+		for (const auto& Field : Object->Values)
+		{
+			WriteIdentifier(Field.Key);
+			WriteJsonValue(Field.Value);
+		}
+		WriteObjectEnd();
+	}
+}
\ No newline at end of file
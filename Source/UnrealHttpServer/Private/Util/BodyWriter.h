@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Body format of request & response
+	 */
+	enum class EBodyFormat : uint8
+	{
+		Json,
+		MsgPack,
+	};
+
+	/**
+	 * Streaming body writer, encodes json-like values directly into response bytes
+	 * Container sizes are required up front as binary formats encode them in headers
+	 */
+	class FBodyWriter
+	{
+	public:
+		virtual ~FBodyWriter() {}
+
+		/**
+		 * Create writer of format with pre-sized buffer
+		 */
+		static TUniquePtr<FBodyWriter> Create(EBodyFormat Format, int32 InitialCapacity = 256);
+
+		/**
+		 * Begin/end object with given field count
+		 */
+		virtual void WriteObjectStart(int32 NumFields) = 0;
+		virtual void WriteObjectEnd() = 0;
+
+		/**
+		 * Begin/end array with given element count
+		 */
+		virtual void WriteArrayStart(int32 NumElements) = 0;
+		virtual void WriteArrayEnd() = 0;
+
+		/**
+		 * Write field name of the next value (in object only)
+		 */
+		virtual void WriteIdentifier(const TCHAR* Identifier, int32 Len) = 0;
+		void WriteIdentifier(const TCHAR* Identifier);
+		void WriteIdentifier(const FString& Identifier);
+
+		/**
+		 * Write values
+		 */
+		virtual void WriteValue(double Value) = 0;
+		virtual void WriteValue(bool Value) = 0;
+		virtual void WriteValue(const TCHAR* Value, int32 Len) = 0;
+		virtual void WriteNull() = 0;
+		void WriteValue(const TCHAR* Value);
+		void WriteValue(const FString& Value);
+
+		/**
+		 * Write json dom value/object (null pointer is written as null)
+		 */
+		void WriteJsonValue(const TSharedPtr<FJsonValue>& Value);
+		void WriteJsonObject(const TSharedPtr<FJsonObject>& Object);
+
+		/**
+		 * Move written bytes out of the writer
+		 */
+		virtual TArray<uint8> ConsumeBytes() = 0;
+
+		/**
+		 * Get content type of written bytes
+		 */
+		virtual const TCHAR* GetContentType() const = 0;
+	};
+}
\ No newline at end of file
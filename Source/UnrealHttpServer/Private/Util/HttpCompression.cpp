@@ -0,0 +1,208 @@
+#include "Util/HttpCompression.h"
+#include "Log.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Compression.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<int32> CVarCompressionMinBytes(
+			TEXT("UHttp.Compression.MinBytes"),
+			1024,
+			TEXT("Min response body size to compress with accepted encoding, negative to disable response compression"));
+
+		TAutoConsoleVariable<int32> CVarCompressionMaxRequestBytes(
+			TEXT("UHttp.Compression.MaxRequestBytes"),
+			16 * 1024 * 1024,
+			TEXT("Max decoded size of gzip request body"));
+
+		TAutoConsoleVariable<int32> CVarCompressionMaxBytes(
+			TEXT("UHttp.Compression.MaxBytes"),
+			8 * 1024 * 1024,
+			TEXT("Max response body size to compress, larger bodies are sent as is"));
+
+		/**
+		 * Check if header of response contains a token (case insensitive)
+		 */
+		bool HeaderContains(const FHttpServerResponse& Response, const TCHAR* Name, const TCHAR* Token)
+		{
+			const TArray<FString>* Values = Response.Headers.Find(Name);
+			if (Values != nullptr)
+			{
+				for (const FString& Value : *Values)
+				{
+					if (Value.Contains(Token))
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Check if content type is compressed already (images, media & archives), compressing it again gains nothing
+		 */
+		bool IsCompressedContentType(const FHttpServerResponse& Response)
+		{
+			const TArray<FString>* Values = Response.Headers.Find(TEXT("content-type"));
+			if (Values == nullptr || Values->Num() == 0)
+			{
+				return false;
+			}
+			const FString& ContentType = (*Values)[0];
+			if (ContentType.StartsWith(TEXT("image/")) && !ContentType.StartsWith(TEXT("image/svg")))
+			{
+				return true;
+			}
+			static const TCHAR* const COMPRESSED_TYPES[] = {
+				TEXT("video/"), TEXT("audio/"), TEXT("font/woff"), TEXT("application/zip"), TEXT("application/gzip"),
+				TEXT("application/x-gzip"), TEXT("application/x-7z-compressed"), TEXT("application/x-rar"), TEXT("application/x-bzip2"),
+				TEXT("application/x-xz"), TEXT("application/zstd"), TEXT("application/pdf"),
+			};
+			for (const TCHAR* Type : COMPRESSED_TYPES)
+			{
+				if (ContentType.StartsWith(Type))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Get quality of a coding in Accept-Encoding values (-1 if not listed)
+		 */
+		float GetCodingQuality(const TArray<FString>& Values, const TCHAR* Coding)
+		{
+			float Quality = -1;
+			for (const FString& Value : Values)
+			{
+				TArray<FString> Codings;
+				Value.ParseIntoArray(Codings, TEXT(","));
+				for (const FString& Item : Codings)
+				{
+					FString Name = Item;
+					FString Parameters;
+					Item.Split(TEXT(";"), &Name, &Parameters);
+					Name.TrimStartAndEndInline();
+					if (Name != Coding && Name != TEXT("*"))
+					{
+						continue;
+					}
+					float ItemQuality = 1;
+					FString QualityValue;
+					if (Parameters.Split(TEXT("q="), nullptr, &QualityValue))
+					{
+						ItemQuality = FCString::Atof(*QualityValue);
+					}
+					// explicit coding overrides wildcard
+					if (Name == Coding || Quality < 0)
+					{
+						Quality = ItemQuality;
+					}
+				}
+			}
+			return Quality;
+		}
+	}
+
+	FName FHttpCompression::NegotiateEncoding(const FHttpServerRequest& Request)
+	{
+		if (CVarCompressionMinBytes.GetValueOnAnyThread() < 0)
+		{
+			return NAME_None;
+		}
+		const TArray<FString>* AcceptEncodingValues = Request.Headers.Find(TEXT("accept-encoding"));
+		if (AcceptEncodingValues == nullptr)
+		{
+			return NAME_None;
+		}
+		float GzipQuality = GetCodingQuality(*AcceptEncodingValues, TEXT("gzip"));
+		float DeflateQuality = GetCodingQuality(*AcceptEncodingValues, TEXT("deflate"));
+		if (GzipQuality > 0 && GzipQuality >= DeflateQuality)
+		{
+			return NAME_Gzip;
+		}
+		if (DeflateQuality > 0)
+		{
+			return NAME_Zlib;
+		}
+		return NAME_None;
+	}
+
+	bool FHttpCompression::ShouldCompress(const FHttpServerResponse& Response, FName Encoding)
+	{
+		// ranges are of identity body
+		if (Encoding.IsNone() || Response.Headers.Contains(TEXT("content-encoding")) || Response.Headers.Contains(TEXT("content-range")))
+		{
+			return false;
+		}
+		// no-transform responses (static files) keep their identity body & strong entity tag
+		if (HeaderContains(Response, TEXT("cache-control"), TEXT("no-transform")) || IsCompressedContentType(Response))
+		{
+			return false;
+		}
+		int32 MinBytes = CVarCompressionMinBytes.GetValueOnAnyThread();
+		return MinBytes >= 0 && Response.Body.Num() >= MinBytes && Response.Body.Num() <= CVarCompressionMaxBytes.GetValueOnAnyThread();
+	}
+
+	void FHttpCompression::CompressResponse(FHttpServerResponse& Response, FName Encoding)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(Encoding, Response.Body.Num());
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (!FCompression::CompressMemory(Encoding, Compressed.GetData(), CompressedSize, Response.Body.GetData(), Response.Body.Num())
+			|| CompressedSize >= Response.Body.Num())
+		{
+			return;
+		}
+		Compressed.SetNum(CompressedSize, false);
+		Response.Body = MoveTemp(Compressed);
+		Response.Headers.Add(TEXT("content-encoding"), { Encoding == NAME_Gzip ? TEXT("gzip") : TEXT("deflate") });
+		Response.Headers.Add(TEXT("content-length"), { FString::FromInt(Response.Body.Num()) });
+		Response.Headers.Add(TEXT("vary"), { TEXT("Accept-Encoding") });
+		// encoded bytes differ from identity body, downgrade to weak tag which still matches on If-None-Match
+		TArray<FString>* ETagValues = Response.Headers.Find(TEXT("etag"));
+		if (ETagValues != nullptr && ETagValues->Num() > 0 && !(*ETagValues)[0].StartsWith(TEXT("W/")))
+		{
+			(*ETagValues)[0] = TEXT("W/") + (*ETagValues)[0];
+		}
+	}
+
+	const TArray<uint8>* FHttpCompression::GetDecodedBody(const FHttpServerRequest& Request, TArray<uint8>& DecodedStorage)
+	{
+		const TArray<FString>* ContentEncodingValues = Request.Headers.Find(TEXT("content-encoding"));
+		if (ContentEncodingValues == nullptr || ContentEncodingValues->Num() == 0 || (*ContentEncodingValues)[0] == TEXT("identity"))
+		{
+			return &Request.Body;
+		}
+		if (ContentEncodingValues->Num() != 1 || (*ContentEncodingValues)[0].TrimStartAndEnd() != TEXT("gzip"))
+		{
+			UE_LOG(UHttpLog, Verbose, TEXT("unsupported request content encoding: %s"), *FString::Join(*ContentEncodingValues, TEXT(",")));
+			return nullptr;
+		}
+
+		// decoded size is in gzip trailer (ISIZE, little endian), bounded against decompression bombs
+		const TArray<uint8>& Body = Request.Body;
+		if (Body.Num() < 18)
+		{
+			return nullptr;
+		}
+		const uint8* Trailer = Body.GetData() + Body.Num() - 4;
+		uint32 DecodedSize = Trailer[0] | (Trailer[1] << 8) | (Trailer[2] << 16) | ((uint32)Trailer[3] << 24);
+		if (DecodedSize > (uint32)FMath::Max(0, CVarCompressionMaxRequestBytes.GetValueOnAnyThread()))
+		{
+			UE_LOG(UHttpLog, Verbose, TEXT("gzip request body too large: %u"), DecodedSize);
+			return nullptr;
+		}
+		DecodedStorage.SetNumUninitialized(DecodedSize);
+		if (!FCompression::UncompressMemory(NAME_Gzip, DecodedStorage.GetData(), DecodedSize, Body.GetData(), Body.Num()))
+		{
+			UE_LOG(UHttpLog, Verbose, TEXT("failed to decode gzip request body!"));
+			return nullptr;
+		}
+		return &DecodedStorage;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerResponse.h"
+
+namespace UnrealHttpServer
+{
+	/**
+	 * HTTP content encoding: gzip/deflate responses negotiated from Accept-Encoding, gzip request bodies from Content-Encoding
+	 * Tuned by UHttp.Compression.* console variables
+	 */
+	class FHttpCompression
+	{
+	public:
+		/**
+		 * Select response encoding accepted by request, NAME_Gzip, NAME_Zlib (deflate) or NAME_None
+		 */
+		static FName NegotiateEncoding(const FHttpServerRequest& Request);
+
+		/**
+		 * Check if response should be compressed in encoding (body size in thresholds & not encoded yet)
+		 * Responses with Cache-Control: no-transform or of compressed content types are not compressed
+		 */
+		static bool ShouldCompress(const FHttpServerResponse& Response, FName Encoding);
+
+		/**
+		 * Compress response body in place and set encoding headers, kept uncompressed if compression does not shrink it
+		 * CPU heavy on large bodies, call on worker thread
+		 */
+		static void CompressResponse(FHttpServerResponse& Response, FName Encoding);
+
+		/**
+		 * Get request body decoded by Content-Encoding, returns the request body itself if not encoded,
+		 * decoded body in storage if gzip encoded, or nullptr if encoding is not supported or body is corrupted
+		 */
+		static const TArray<uint8>* GetDecodedBody(const FHttpServerRequest& Request, TArray<uint8>& DecodedStorage);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "Util/JsonStreamWriter.h"
+
+namespace UnrealHttpServer
+{
+	/** ========================== Public Methods ======================= */
+
+	FJsonStreamWriter::FJsonStreamWriter(int32 InitialCapacity)
+		: bAfterIdentifier(false)
+	{
+		Bytes.Reserve(InitialCapacity);
+	}
+
+	void FJsonStreamWriter::WriteObjectStart(int32 NumFields)
+	{
+		WriteValueSeparator();
+		Bytes.Add('{');
+		NeedsComma.Push(false);
+	}
+
+	void FJsonStreamWriter::WriteObjectEnd()
+	{
+		NeedsComma.Pop(false);
+		Bytes.Add('}');
+	}
+
+	void FJsonStreamWriter::WriteArrayStart(int32 NumElements)
+	{
+		WriteValueSeparator();
+		Bytes.Add('[');
+		NeedsComma.Push(false);
+	}
+
+	void FJsonStreamWriter::WriteArrayEnd()
+	{
+		NeedsComma.Pop(false);
+		Bytes.Add(']');
+	}
+
+	void FJsonStreamWriter::WriteIdentifier(const TCHAR* Identifier, int32 Len)
+	{
+		WriteValueSeparator();
+		WriteEscapedString(Identifier, Len);
+		Bytes.Add(':');
+		bAfterIdentifier = true;
+	}
+
+	void FJsonStreamWriter::WriteValue(double Value)
+	{
+		WriteValueSeparator();
+		if (!FMath::IsFinite(Value))
+		{
+			// nan & inf are not representable in json
+			WriteRaw("null", 4);
+			return;
+		}
+		// 17 significant digits so that doubles & large integers round trip, same as engine json writer
+		ANSICHAR Buffer[32];
+		int32 Len = FCStringAnsi::Snprintf(Buffer, sizeof(Buffer), "%.17g", Value);
+		WriteRaw(Buffer, Len);
+	}
+
+	void FJsonStreamWriter::WriteValue(bool Value)
+	{
+		WriteValueSeparator();
+		if (Value)
+		{
+			WriteRaw("true", 4);
+		}
+		else
+		{
+			WriteRaw("false", 5);
+		}
+	}
+
+	void FJsonStreamWriter::WriteValue(const TCHAR* Value, int32 Len)
+	{
+		WriteValueSeparator();
+		WriteEscapedString(Value, Len);
+	}
+
+	void FJsonStreamWriter::WriteNull()
+	{
+		WriteValueSeparator();
+		WriteRaw("null", 4);
+	}
+
+	TArray<uint8> FJsonStreamWriter::ConsumeBytes()
+	{
+		NeedsComma.Reset();
+		bAfterIdentifier = false;
+		return MoveTemp(Bytes);
+	}
+
+	const TCHAR* FJsonStreamWriter::GetContentType() const
+	{
+		return TEXT("application/json");
+	}
+
+	/** ========================== Private Methods ======================= */
+
+	void FJsonStreamWriter::WriteValueSeparator()
+	{
+		if (bAfterIdentifier)
+		{
+			bAfterIdentifier = false;
+			return;
+		}
+		if (NeedsComma.Num() > 0)
+		{
+			if (NeedsComma.Last())
+			{
+				Bytes.Add(',');
+			}
+			NeedsComma.Last() = true;
+		}
+	}
+
+	void FJsonStreamWriter::WriteRaw(const ANSICHAR* Chars, int32 Len)
+	{
+		Bytes.Append(reinterpret_cast<const uint8*>(Chars), Len);
+	}
+
+	void FJsonStreamWriter::WriteEscapedString(const TCHAR* Chars, int32 Len)
+	{
+		static const ANSICHAR HexDigits[] = "0123456789abcdef";
+		Bytes.Add('"');
+		for (int32 Index = 0; Index < Len; ++Index)
+		{
+			uint32 CodePoint = static_cast<uint32>(Chars[Index]);
+			// escape
+			switch (CodePoint)
+			{
+			case '"': WriteRaw("\\\"", 2); continue;
+			case '\\': WriteRaw("\\\\", 2); continue;
+			case '\b': WriteRaw("\\b", 2); continue;
+			case '\f': WriteRaw("\\f", 2); continue;
+			case '\n': WriteRaw("\\n", 2); continue;
+			case '\r': WriteRaw("\\r", 2); continue;
+			case '\t': WriteRaw("\\t", 2); continue;
+			default: break;
+			}
+			if (CodePoint < 0x20)
+			{
+				const ANSICHAR Escaped[] = { '\\', 'u', '0', '0', HexDigits[CodePoint >> 4], HexDigits[CodePoint & 0xF] };
+				WriteRaw(Escaped, 6);
+				continue;
+			}
+			// combine utf-16 surrogate pair (TCHAR is utf-16 on windows)
+			if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && Index + 1 < Len)
+			{
+				uint32 LowSurrogate = static_cast<uint32>(Chars[Index + 1]);
+				if (LowSurrogate >= 0xDC00 && LowSurrogate <= 0xDFFF)
+				{
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+					++Index;
+				}
+			}
+			// utf-8 encode
+			if (CodePoint < 0x80)
+			{
+				Bytes.Add(static_cast<uint8>(CodePoint));
+			}
+			else if (CodePoint < 0x800)
+			{
+				Bytes.Add(static_cast<uint8>(0xC0 | (CodePoint >> 6)));
+				Bytes.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+			}
+			else if (CodePoint < 0x10000)
+			{
+				Bytes.Add(static_cast<uint8>(0xE0 | (CodePoint >> 12)));
+				Bytes.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+				Bytes.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+			}
+			else
+			{
+				Bytes.Add(static_cast<uint8>(0xF0 | (CodePoint >> 18)));
+				Bytes.Add(static_cast<uint8>(0x80 | ((CodePoint >> 12) & 0x3F)));
+				Bytes.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+				Bytes.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+			}
+		}
+		Bytes.Add('"');
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Util/BodyWriter.h"
+
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Condensed json writer that encodes directly into a UTF-8 byte buffer
+	 * Used to build response bodies without an intermediate TCHAR string
+	 */
+	class FJsonStreamWriter : public FBodyWriter
+	{
+	public:
+		/**
+		 * Create writer with pre-sized buffer
+		 */
+		explicit FJsonStreamWriter(int32 InitialCapacity = 256);
+
+		using FBodyWriter::WriteIdentifier;
+		using FBodyWriter::WriteValue;
+
+		/** FBodyWriter implementation */
+		virtual void WriteObjectStart(int32 NumFields) override;
+		virtual void WriteObjectEnd() override;
+		virtual void WriteArrayStart(int32 NumElements) override;
+		virtual void WriteArrayEnd() override;
+		virtual void WriteIdentifier(const TCHAR* Identifier, int32 Len) override;
+		virtual void WriteValue(double Value) override;
+		virtual void WriteValue(bool Value) override;
+		virtual void WriteValue(const TCHAR* Value, int32 Len) override;
+		virtual void WriteNull() override;
+		virtual TArray<uint8> ConsumeBytes() override;
+		virtual const TCHAR* GetContentType() const override;
+
+	private:
+		/* Output UTF-8 bytes */
+		TArray<uint8> Bytes;
+
+		/* For each open container, whether a comma is required before the next element */
+		TArray<bool, TInlineAllocator<16>> NeedsComma;
+
+		/* Whether an identifier is just written, so that the next value should not be prefixed by comma */
+		bool bAfterIdentifier;
+
+		/**
+		 * Write comma before value if needed
+		 */
+		void WriteValueSeparator();
+
+		/**
+		 * Write raw ansi chars
+		 */
+		void WriteRaw(const ANSICHAR* Chars, int32 Len);
+
+		/**
+		 * Write quoted, escaped and UTF-8 encoded string
+		 */
+		void WriteEscapedString(const TCHAR* Chars, int32 Len);
+	};
+}
\ No newline at end of file
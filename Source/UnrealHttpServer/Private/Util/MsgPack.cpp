@@ -0,0 +1,454 @@
+#include "Util/MsgPack.h"
+#include "Util/WebUtil.h"
+
+namespace UnrealHttpServer
+{
+	/** ========================== FMsgPackWriter ======================= */
+
+	FMsgPackWriter::FMsgPackWriter(int32 InitialCapacity)
+	{
+		Bytes.Reserve(InitialCapacity);
+	}
+
+	void FMsgPackWriter::WriteObjectStart(int32 NumFields)
+	{
+		if (NumFields < 16)
+		{
+			Bytes.Add(static_cast<uint8>(0x80 | NumFields));
+		}
+		else if (NumFields <= MAX_uint16)
+		{
+			WriteTyped(0xde, NumFields, 2);
+		}
+		else
+		{
+			WriteTyped(0xdf, NumFields, 4);
+		}
+	}
+
+	void FMsgPackWriter::WriteObjectEnd()
+	{
+	}
+
+	void FMsgPackWriter::WriteArrayStart(int32 NumElements)
+	{
+		if (NumElements < 16)
+		{
+			Bytes.Add(static_cast<uint8>(0x90 | NumElements));
+		}
+		else if (NumElements <= MAX_uint16)
+		{
+			WriteTyped(0xdc, NumElements, 2);
+		}
+		else
+		{
+			WriteTyped(0xdd, NumElements, 4);
+		}
+	}
+
+	void FMsgPackWriter::WriteArrayEnd()
+	{
+	}
+
+	void FMsgPackWriter::WriteIdentifier(const TCHAR* Identifier, int32 Len)
+	{
+		WriteString(Identifier, Len);
+	}
+
+	void FMsgPackWriter::WriteValue(double Value)
+	{
+		// integers, within the range doubles represent exactly
+		if (Value == FMath::FloorToDouble(Value) && FMath::Abs(Value) <= 9007199254740992.0)
+		{
+			int64 IntValue = static_cast<int64>(Value);
+			if (IntValue >= 0)
+			{
+				if (IntValue < 128)
+				{
+					Bytes.Add(static_cast<uint8>(IntValue));
+				}
+				else if (IntValue <= MAX_uint8)
+				{
+					WriteTyped(0xcc, IntValue, 1);
+				}
+				else if (IntValue <= MAX_uint16)
+				{
+					WriteTyped(0xcd, IntValue, 2);
+				}
+				else if (IntValue <= MAX_uint32)
+				{
+					WriteTyped(0xce, IntValue, 4);
+				}
+				else
+				{
+					WriteTyped(0xcf, IntValue, 8);
+				}
+			}
+			else
+			{
+				if (IntValue >= -32)
+				{
+					Bytes.Add(static_cast<uint8>(IntValue));
+				}
+				else if (IntValue >= MIN_int8)
+				{
+					WriteTyped(0xd0, static_cast<uint8>(IntValue), 1);
+				}
+				else if (IntValue >= MIN_int16)
+				{
+					WriteTyped(0xd1, static_cast<uint16>(IntValue), 2);
+				}
+				else if (IntValue >= MIN_int32)
+				{
+					WriteTyped(0xd2, static_cast<uint32>(IntValue), 4);
+				}
+				else
+				{
+					WriteTyped(0xd3, static_cast<uint64>(IntValue), 8);
+				}
+			}
+			return;
+		}
+		// float32 when lossless (e.g. float components of engine vectors), otherwise float64
+		float FloatValue = static_cast<float>(Value);
+		if (static_cast<double>(FloatValue) == Value || FMath::IsNaN(Value))
+		{
+			uint32 Bits;
+			FMemory::Memcpy(&Bits, &FloatValue, sizeof(Bits));
+			WriteTyped(0xca, Bits, 4);
+			return;
+		}
+		uint64 Bits;
+		FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+		WriteTyped(0xcb, Bits, 8);
+	}
+
+	void FMsgPackWriter::WriteValue(bool Value)
+	{
+		Bytes.Add(Value ? 0xc3 : 0xc2);
+	}
+
+	void FMsgPackWriter::WriteValue(const TCHAR* Value, int32 Len)
+	{
+		WriteString(Value, Len);
+	}
+
+	void FMsgPackWriter::WriteNull()
+	{
+		Bytes.Add(0xc0);
+	}
+
+	TArray<uint8> FMsgPackWriter::ConsumeBytes()
+	{
+		return MoveTemp(Bytes);
+	}
+
+	const TCHAR* FMsgPackWriter::GetContentType() const
+	{
+		return TEXT("application/msgpack");
+	}
+
+	void FMsgPackWriter::WriteTyped(uint8 Type, uint64 Value, int32 Size)
+	{
+		Bytes.Add(Type);
+		for (int32 Shift = (Size - 1) * 8; Shift >= 0; Shift -= 8)
+		{
+			Bytes.Add(static_cast<uint8>(Value >> Shift));
+		}
+	}
+
+	void FMsgPackWriter::WriteString(const TCHAR* Chars, int32 Len)
+	{
+		FTCHARToUTF8 Converter(Chars, Len);
+		int32 Size = Converter.Length();
+		if (Size < 32)
+		{
+			Bytes.Add(static_cast<uint8>(0xa0 | Size));
+		}
+		else if (Size <= MAX_uint8)
+		{
+			WriteTyped(0xd9, Size, 1);
+		}
+		else if (Size <= MAX_uint16)
+		{
+			WriteTyped(0xda, Size, 2);
+		}
+		else
+		{
+			WriteTyped(0xdb, Size, 4);
+		}
+		Bytes.Append(reinterpret_cast<const uint8*>(Converter.Get()), Size);
+	}
+
+	/** ========================== FMsgPackReader ======================= */
+
+	FMsgPackReader::FMsgPackReader(const uint8* InData, int32 InNum)
+		: Data(InData)
+		, Num(InNum)
+		, Offset(0)
+	{
+	}
+
+	bool FMsgPackReader::ReadJsonObject(TSharedPtr<FJsonObject>& OutObject)
+	{
+		TSharedPtr<FJsonValue> Value;
+		if (Offset >= Num || ((Data[Offset] & 0xf0) != 0x80 && Data[Offset] != 0xde && Data[Offset] != 0xdf))
+		{
+			return false;
+		}
+		if (!ReadValue(Value, 0))
+		{
+			return false;
+		}
+		OutObject = Value->AsObject();
+		return OutObject.IsValid();
+	}
+
+	bool FMsgPackReader::ReadNumberFields(TArrayView<const FJsonNumberField> Fields)
+	{
+		uint32 Count;
+		if (!ReadMapHeader(Count))
+		{
+			return false;
+		}
+		for (uint32 Index = 0; Index < Count; ++Index)
+		{
+			FString Key;
+			TSharedPtr<FJsonValue> Value;
+			if (!ReadString(Key) || !ReadValue(Value, 1))
+			{
+				return false;
+			}
+			if (Value->Type != EJson::Number)
+			{
+				continue;
+			}
+			for (const FJsonNumberField& Field : Fields)
+			{
+				if (Key == Field.Name)
+				{
+					*Field.Value = Value->AsNumber();
+					break;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool FMsgPackReader::ReadUnsigned(int32 Size, uint64& OutValue)
+	{
+		if (Offset + Size > Num)
+		{
+			return false;
+		}
+		OutValue = 0;
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			OutValue = (OutValue << 8) | Data[Offset++];
+		}
+		return true;
+	}
+
+	bool FMsgPackReader::ReadMapHeader(uint32& OutCount)
+	{
+		if (Offset >= Num)
+		{
+			return false;
+		}
+		uint8 Type = Data[Offset++];
+		uint64 Count;
+		if ((Type & 0xf0) == 0x80)
+		{
+			OutCount = Type & 0x0f;
+			return true;
+		}
+		if ((Type == 0xde && ReadUnsigned(2, Count)) || (Type == 0xdf && ReadUnsigned(4, Count)))
+		{
+			OutCount = static_cast<uint32>(Count);
+			return true;
+		}
+		return false;
+	}
+
+	bool FMsgPackReader::ReadString(FString& OutString)
+	{
+		if (Offset >= Num)
+		{
+			return false;
+		}
+		uint8 Type = Data[Offset++];
+		uint64 Size;
+		if ((Type & 0xe0) == 0xa0)
+		{
+			Size = Type & 0x1f;
+		}
+		else if (!((Type == 0xd9 && ReadUnsigned(1, Size)) || (Type == 0xda && ReadUnsigned(2, Size)) || (Type == 0xdb && ReadUnsigned(4, Size))))
+		{
+			return false;
+		}
+		if (Size > static_cast<uint64>(Num - Offset))
+		{
+			return false;
+		}
+		FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Data + Offset), static_cast<int32>(Size));
+		OutString = FString(Converter.Length(), Converter.Get());
+		Offset += static_cast<int32>(Size);
+		return true;
+	}
+
+	bool FMsgPackReader::ReadValue(TSharedPtr<FJsonValue>& OutValue, int32 Depth)
+	{
+		if (Offset >= Num || Depth > MAX_DEPTH)
+		{
+			return false;
+		}
+		uint8 Type = Data[Offset];
+		uint64 Raw;
+
+		// positive & negative fixint
+		if (Type < 0x80 || Type >= 0xe0)
+		{
+			++Offset;
+			double Value = Type < 0x80 ? Type : static_cast<int8>(Type);
+			OutValue = MakeShareable(new FJsonValueNumber(Value));
+			return true;
+		}
+		// strings
+		if ((Type & 0xe0) == 0xa0 || Type == 0xd9 || Type == 0xda || Type == 0xdb)
+		{
+			FString String;
+			if (!ReadString(String))
+			{
+				return false;
+			}
+			OutValue = MakeShareable(new FJsonValueString(String));
+			return true;
+		}
+		// maps
+		if ((Type & 0xf0) == 0x80 || Type == 0xde || Type == 0xdf)
+		{
+			uint32 Count;
+			if (!ReadMapHeader(Count))
+			{
+				return false;
+			}
+			TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject());
+			for (uint32 Index = 0; Index < Count; ++Index)
+			{
+				FString Key;
+				TSharedPtr<FJsonValue> Value;
+				if (!ReadString(Key) || !ReadValue(Value, Depth + 1))
+				{
+					return false;
+				}
+				Object->SetField(Key, Value);
+			}
+			OutValue = MakeShareable(new FJsonValueObject(Object));
+			return true;
+		}
+		// arrays
+		if ((Type & 0xf0) == 0x90 || Type == 0xdc || Type == 0xdd)
+		{
+			++Offset;
+			uint64 Count = Type & 0x0f;
+			if ((Type == 0xdc && !ReadUnsigned(2, Count)) || (Type == 0xdd && !ReadUnsigned(4, Count)))
+			{
+				return false;
+			}
+			// every element takes at least one byte
+			if (Count > static_cast<uint64>(Num - Offset))
+			{
+				return false;
+			}
+			TArray<TSharedPtr<FJsonValue>> Elements;
+			Elements.Reserve(static_cast<int32>(Count));
+			for (uint64 Index = 0; Index < Count; ++Index)
+			{
+				TSharedPtr<FJsonValue> Element;
+				if (!ReadValue(Element, Depth + 1))
+				{
+					return false;
+				}
+				Elements.Add(Element);
+			}
+			OutValue = MakeShareable(new FJsonValueArray(Elements));
+			return true;
+		}
+
+		++Offset;
+		switch (Type)
+		{
+		case 0xc0:
+			OutValue = MakeShareable(new FJsonValueNull());
+			return true;
+		case 0xc2:
+		case 0xc3:
+			OutValue = MakeShareable(new FJsonValueBoolean(Type == 0xc3));
+			return true;
+		case 0xca:
+		{
+			if (!ReadUnsigned(4, Raw))
+			{
+				return false;
+			}
+			uint32 Bits = static_cast<uint32>(Raw);
+			float Value;
+			FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+			OutValue = MakeShareable(new FJsonValueNumber(Value));
+			return true;
+		}
+		case 0xcb:
+		{
+			if (!ReadUnsigned(8, Raw))
+			{
+				return false;
+			}
+			double Value;
+			FMemory::Memcpy(&Value, &Raw, sizeof(Value));
+			OutValue = MakeShareable(new FJsonValueNumber(Value));
+			return true;
+		}
+		case 0xcc:
+		case 0xcd:
+		case 0xce:
+		case 0xcf:
+			if (!ReadUnsigned(1 << (Type - 0xcc), Raw))
+			{
+				return false;
+			}
+			OutValue = MakeShareable(new FJsonValueNumber(static_cast<double>(Raw)));
+			return true;
+		case 0xd0:
+			if (!ReadUnsigned(1, Raw))
+			{
+				return false;
+			}
+			OutValue = MakeShareable(new FJsonValueNumber(static_cast<int8>(Raw)));
+			return true;
+		case 0xd1:
+			if (!ReadUnsigned(2, Raw))
+			{
+				return false;
+			}
+			OutValue = MakeShareable(new FJsonValueNumber(static_cast<int16>(Raw)));
+			return true;
+		case 0xd2:
+			if (!ReadUnsigned(4, Raw))
+			{
+				return false;
+			}
+			OutValue = MakeShareable(new FJsonValueNumber(static_cast<int32>(Raw)));
+			return true;
+		case 0xd3:
+			if (!ReadUnsigned(8, Raw))
+			{
+				return false;
+			}
+			OutValue = MakeShareable(new FJsonValueNumber(static_cast<double>(static_cast<int64>(Raw))));
+			return true;
+		default:
+			// bin, ext & reserved types are not supported
+			return false;
+		}
+	}
+}
\ No newline at end of file
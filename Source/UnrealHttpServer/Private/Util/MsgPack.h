@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Util/BodyWriter.h"
+
+
+namespace UnrealHttpServer
+{
+	struct FJsonNumberField;
+
+	/**
+	 * MessagePack writer, encodes json-like values directly into a byte buffer
+	 * Integral numbers are written as integers and numbers exactly representable by float as float32
+	 */
+	class FMsgPackWriter : public FBodyWriter
+	{
+	public:
+		/**
+		 * Create writer with pre-sized buffer
+		 */
+		explicit FMsgPackWriter(int32 InitialCapacity = 256);
+
+		using FBodyWriter::WriteIdentifier;
+		using FBodyWriter::WriteValue;
+
+		/** FBodyWriter implementation */
+		virtual void WriteObjectStart(int32 NumFields) override;
+		virtual void WriteObjectEnd() override;
+		virtual void WriteArrayStart(int32 NumElements) override;
+		virtual void WriteArrayEnd() override;
+		virtual void WriteIdentifier(const TCHAR* Identifier, int32 Len) override;
+		virtual void WriteValue(double Value) override;
+		virtual void WriteValue(bool Value) override;
+		virtual void WriteValue(const TCHAR* Value, int32 Len) override;
+		virtual void WriteNull() override;
+		virtual TArray<uint8> ConsumeBytes() override;
+		virtual const TCHAR* GetContentType() const override;
+
+	private:
+		/* Output bytes */
+		TArray<uint8> Bytes;
+
+		/**
+		 * Write type byte and big-endian value of Size bytes
+		 */
+		void WriteTyped(uint8 Type, uint64 Value, int32 Size);
+
+		/**
+		 * Write UTF-8 encoded string
+		 */
+		void WriteString(const TCHAR* Chars, int32 Len);
+	};
+
+	/**
+	 * Bounded MessagePack reader, decodes a map body into json dom or reads its number fields in place
+	 */
+	class FMsgPackReader
+	{
+	public:
+		FMsgPackReader(const uint8* InData, int32 InNum);
+
+		/**
+		 * Decode root map into json object
+		 */
+		bool ReadJsonObject(TSharedPtr<FJsonObject>& OutObject);
+
+		/**
+		 * Read top-level number fields of root map into bound variables, other values are skipped
+		 */
+		bool ReadNumberFields(TArrayView<const FJsonNumberField> Fields);
+
+	private:
+		/* Max nesting depth, to bound recursion on malicious input */
+		static const int32 MAX_DEPTH = 64;
+
+		const uint8* Data;
+		int32 Num;
+		int32 Offset;
+
+		/**
+		 * Read big-endian unsigned value of Size bytes
+		 */
+		bool ReadUnsigned(int32 Size, uint64& OutValue);
+
+		/**
+		 * Read map header, returns false if next value is not a map
+		 */
+		bool ReadMapHeader(uint32& OutCount);
+
+		/**
+		 * Read string value
+		 */
+		bool ReadString(FString& OutString);
+
+		/**
+		 * Read any value into json value
+		 */
+		bool ReadValue(TSharedPtr<FJsonValue>& OutValue, int32 Depth);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "Util/MutationQueue.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		TAutoConsoleVariable<int32> CVarMutationQueueCapacity(
+			TEXT("UHttp.Mutation.QueueCapacity"),
+			1024,
+			TEXT("Max queued mutations, further mutating requests are rejected with 429 & Retry-After"));
+
+		TAutoConsoleVariable<float> CVarMutationBudgetMs(
+			TEXT("UHttp.Mutation.BudgetMs"),
+			2.0f,
+			TEXT("Game thread time budget per frame for applying queued mutations (at least one is applied per frame)"));
+	}
+
+	TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> FMutationQueue::Commands;
+	std::atomic<int32> FMutationQueue::NumQueued(0);
+	std::atomic<float> FMutationQueue::ExecutedPerFrame(0);
+	std::atomic<float> FMutationQueue::FrameSeconds(1.0f / 30);
+	FDelegateHandle FMutationQueue::TickerHandle;
+	TMap<FString, FMutationQueue::FPendingWrite> FMutationQueue::PendingWrites;
+	FCriticalSection FMutationQueue::PendingWritesLock;
+	uint64 FMutationQueue::WriteSequence = 0;
+	std::atomic<uint64> FMutationQueue::NumPlainEnqueued(0);
+
+	/* ================= Public Methods ==================== */
+
+	void FMutationQueue::Initialize()
+	{
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FMutationQueue::Tick));
+	}
+
+	void FMutationQueue::Shutdown()
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TUniqueFunction<void()> Command;
+		while (Commands.Dequeue(Command))
+		{
+			--NumQueued;
+		}
+		FScopeLock Lock(&PendingWritesLock);
+		PendingWrites.Empty();
+	}
+
+	bool FMutationQueue::Enqueue(TUniqueFunction<void()> Command)
+	{
+		// counted before queueing, so that a coalesced write seeing the same count is not ordered before this command
+		++NumPlainEnqueued;
+		return Push(MoveTemp(Command));
+	}
+
+	bool FMutationQueue::Push(TUniqueFunction<void()> Command)
+	{
+		int32 Capacity = CVarMutationQueueCapacity.GetValueOnAnyThread();
+		if (NumQueued.fetch_add(1) >= Capacity)
+		{
+			NumQueued.fetch_sub(1);
+			return false;
+		}
+		Commands.Enqueue(MoveTemp(Command));
+		return true;
+	}
+
+	bool FMutationQueue::EnqueueCoalesced(const FString& Key, TUniqueFunction<void()> Command, TUniqueFunction<void()> OnSuperseded)
+	{
+		TUniqueFunction<void()> Superseded;
+		{
+			FScopeLock Lock(&PendingWritesLock);
+			uint64 PlainEnqueued = NumPlainEnqueued.load();
+			FPendingWrite* Pending = PendingWrites.Find(Key);
+			// no other command is queued after the flush of pending write, replace it in place without taking another slot
+			if (Pending != nullptr && Pending->PlainEnqueued == PlainEnqueued)
+			{
+				Superseded = MoveTemp(Pending->OnSuperseded);
+				Pending->Command = MoveTemp(Command);
+				Pending->OnSuperseded = MoveTemp(OnSuperseded);
+			}
+			else
+			{
+				// flush waits for the lock, so the write is always added before it runs
+				uint64 Sequence = ++WriteSequence;
+				if (!Push([Key, Sequence]() { FlushWrite(Key, Sequence); }))
+				{
+					return false;
+				}
+				// commands were queued after the pending write (e.g. a batch), so the superseded write drops its slot:
+				// its flush sees a newer sequence and does nothing, the new write is applied at the tail (last writer wins)
+				if (Pending != nullptr)
+				{
+					Superseded = MoveTemp(Pending->OnSuperseded);
+					*Pending = FPendingWrite{ MoveTemp(Command), MoveTemp(OnSuperseded), Sequence, PlainEnqueued };
+				}
+				else
+				{
+					PendingWrites.Add(Key, FPendingWrite{ MoveTemp(Command), MoveTemp(OnSuperseded), Sequence, PlainEnqueued });
+				}
+			}
+		}
+		if (Superseded)
+		{
+			// superseding caller may be a worker, callbacks reply through game thread state (e.g. websocket connections)
+			if (IsInGameThread())
+			{
+				Superseded();
+			}
+			else
+			{
+				AsyncTask(ENamedThreads::GameThread, MoveTemp(Superseded));
+			}
+		}
+		return true;
+	}
+
+	int32 FMutationQueue::GetRetryAfterSeconds()
+	{
+		// frames to drain current queue at the recent rate
+		float Frames = NumQueued.load() / FMath::Max(1.0f, ExecutedPerFrame.load());
+		return FMath::Max(1, FMath::CeilToInt(Frames * FrameSeconds.load()));
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FMutationQueue::Tick(float DeltaTime)
+	{
+		double Deadline = FPlatformTime::Seconds() + CVarMutationBudgetMs.GetValueOnGameThread() / 1000.0;
+		int32 Executed = 0;
+		TUniqueFunction<void()> Command;
+		// always apply one command, so that the queue progresses even if a single command exceeds the budget
+		while ((Executed == 0 || FPlatformTime::Seconds() < Deadline) && Commands.Dequeue(Command))
+		{
+			--NumQueued;
+			Command();
+			++Executed;
+		}
+		if (Executed > 0 || NumQueued.load() > 0)
+		{
+			ExecutedPerFrame = FMath::Lerp(ExecutedPerFrame.load(), (float)Executed, 0.1f);
+		}
+		FrameSeconds = FMath::Lerp(FrameSeconds.load(), FMath::Max(DeltaTime, 0.001f), 0.1f);
+		return true;
+	}
+
+	void FMutationQueue::FlushWrite(const FString& Key, uint64 Sequence)
+	{
+		FPendingWrite Write;
+		{
+			FScopeLock Lock(&PendingWritesLock);
+			FPendingWrite* Pending = PendingWrites.Find(Key);
+			if (Pending == nullptr || Pending->Sequence != Sequence)
+			{
+				return;
+			}
+			Write = MoveTemp(*Pending);
+			PendingWrites.Remove(Key);
+		}
+		Write.Command();
+	}
+}
\ No newline at end of file
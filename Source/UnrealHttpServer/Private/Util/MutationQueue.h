@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+
+#include <atomic>
+
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Bounded queue of game state mutations, drained once per frame on core ticker within a time budget
+	 * Commands can be enqueued from any thread, enqueue fails when the queue is full so that callers can apply backpressure
+	 */
+	class FMutationQueue
+	{
+	public:
+		/**
+		 * Register ticker
+		 */
+		static void Initialize();
+
+		/**
+		 * Unregister ticker and drop queued commands
+		 */
+		static void Shutdown();
+
+		/**
+		 * Enqueue command executed on game thread, returns false if the queue is full
+		 */
+		static bool Enqueue(TUniqueFunction<void()> Command);
+
+		/**
+		 * Enqueue command keyed by written target & property, last writer wins:
+		 * if a command of the key is still queued, it is replaced and its OnSuperseded is invoked on game thread,
+		 * in place if nothing was enqueued after it, otherwise the new command is moved to the tail so that it applies
+		 * after commands enqueued in between (a queue slot is only taken then)
+		 * Returns false if the queue is full, a queued command of the key is kept then
+		 */
+		static bool EnqueueCoalesced(const FString& Key, TUniqueFunction<void()> Command, TUniqueFunction<void()> OnSuperseded);
+
+		/**
+		 * Estimated seconds until the queue has room, for Retry-After
+		 */
+		static int32 GetRetryAfterSeconds();
+
+	private:
+		static TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> Commands;
+		/* Queued commands count, reserved before enqueueing to bound the queue */
+		static std::atomic<int32> NumQueued;
+		/* Smoothed commands executed per frame & frame seconds, for Retry-After estimation */
+		static std::atomic<float> ExecutedPerFrame;
+		static std::atomic<float> FrameSeconds;
+		static FDelegateHandle TickerHandle;
+
+		/**
+		 * Latest queued write of a key
+		 */
+		struct FPendingWrite
+		{
+			TUniqueFunction<void()> Command;
+			TUniqueFunction<void()> OnSuperseded;
+			/* Sequence of its flush command, flushes of superseded writes are no-op */
+			uint64 Sequence = 0;
+			/* Count of plain commands enqueued when its flush was queued */
+			uint64 PlainEnqueued = 0;
+		};
+
+		/* Latest writes by key, flushed by the queued command of the same sequence */
+		static TMap<FString, FPendingWrite> PendingWrites;
+		static FCriticalSection PendingWritesLock;
+		static uint64 WriteSequence;
+		/* Count of commands enqueued by Enqueue (not coalesced), to tell if a pending write is still at the tail */
+		static std::atomic<uint64> NumPlainEnqueued;
+
+		/**
+		 * Queue command if the queue has room
+		 */
+		static bool Push(TUniqueFunction<void()> Command);
+
+		/**
+		 * Execute queued commands within budget
+		 */
+		static bool Tick(float DeltaTime);
+
+		/**
+		 * Apply latest write of key if it is still of sequence
+		 */
+		static void FlushWrite(const FString& Key, uint64 Sequence);
+	};
+}
\ No newline at end of file
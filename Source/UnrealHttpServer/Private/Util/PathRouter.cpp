@@ -0,0 +1,513 @@
+#include "Util/PathRouter.h"
+#include "Log.h"
+#include "Algo/BinarySearch.h"
+#include "Runtime/Online/HTTPServer/Public/HttpPath.h"
+
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		/* Parameters being dispatched on current thread */
+		thread_local const FPathParams* GPathParams = nullptr;
+
+		/* Verbs dispatched by routes, in order of verb indices */
+		const EHttpServerRequestVerbs DISPATCHED_VERBS[] = { EHttpServerRequestVerbs::VERB_GET, EHttpServerRequestVerbs::VERB_POST, EHttpServerRequestVerbs::VERB_PUT,
+			EHttpServerRequestVerbs::VERB_DELETE, EHttpServerRequestVerbs::VERB_PATCH, EHttpServerRequestVerbs::VERB_OPTIONS };
+
+		/**
+		 * Set parameters being dispatched on current thread in scope
+		 */
+		class FPathParamsScope
+		{
+		public:
+			explicit FPathParamsScope(const FPathParams* Params)
+				: PreviousParams(GPathParams)
+			{
+				GPathParams = Params;
+			}
+
+			~FPathParamsScope()
+			{
+				GPathParams = PreviousParams;
+			}
+
+		private:
+			const FPathParams* PreviousParams;
+		};
+
+		/**
+		 * Compare segment of path with literal, ordered like FString comparison of same case
+		 */
+		int32 CompareSegment(const TCHAR* Segment, int32 Len, const FString& Literal)
+		{
+			int32 Result = FCString::Strncmp(Segment, *Literal, FMath::Min(Len, Literal.Len()));
+			return Result != 0 ? Result : Len - Literal.Len();
+		}
+
+		bool ParseInt(const TCHAR* Segment, int32 Len, int64& OutValue)
+		{
+			int32 Index = 0;
+			bool bNegative = Len > 1 && Segment[0] == TEXT('-');
+			if (bNegative)
+			{
+				++Index;
+			}
+			if (Len - Index > 18 || Index == Len)
+			{
+				// more than 18 digits may overflow, not worth a slower exact check
+				return false;
+			}
+			int64 Value = 0;
+			for (; Index < Len; ++Index)
+			{
+				if (!FChar::IsDigit(Segment[Index]))
+				{
+					return false;
+				}
+				Value = Value * 10 + (Segment[Index] - TEXT('0'));
+			}
+			OutValue = bNegative ? -Value : Value;
+			return true;
+		}
+
+		bool ParseFloat(const TCHAR* Segment, int32 Len, double& OutValue)
+		{
+			// validate the whole segment is a number, then convert in place (conversion stops at the following slash)
+			int32 Index = 0;
+			if (Index < Len && (Segment[Index] == TEXT('-') || Segment[Index] == TEXT('+')))
+			{
+				++Index;
+			}
+			int32 Digits = 0;
+			bool bDot = false;
+			for (; Index < Len; ++Index)
+			{
+				if (FChar::IsDigit(Segment[Index]))
+				{
+					++Digits;
+				}
+				else if (Segment[Index] == TEXT('.') && !bDot)
+				{
+					bDot = true;
+				}
+				else
+				{
+					break;
+				}
+			}
+			if (Digits == 0)
+			{
+				return false;
+			}
+			if (Index < Len && (Segment[Index] == TEXT('e') || Segment[Index] == TEXT('E')))
+			{
+				++Index;
+				if (Index < Len && (Segment[Index] == TEXT('-') || Segment[Index] == TEXT('+')))
+				{
+					++Index;
+				}
+				int32 ExponentStart = Index;
+				while (Index < Len && FChar::IsDigit(Segment[Index]))
+				{
+					++Index;
+				}
+				if (Index == ExponentStart)
+				{
+					return false;
+				}
+			}
+			if (Index != Len)
+			{
+				return false;
+			}
+			OutValue = FCString::Atod(Segment);
+			return true;
+		}
+
+		/**
+		 * Parse parameter segment of pattern ({name}, {name:type} or {*name}), returns false if not a parameter
+		 */
+		bool ParseParamSegment(const FString& Segment, FString& OutName, EPathParamType& OutType, bool& bOutValid)
+		{
+			bOutValid = false;
+			if (!Segment.StartsWith(TEXT("{")) || !Segment.EndsWith(TEXT("}")))
+			{
+				return false;
+			}
+			FString Body = Segment.Mid(1, Segment.Len() - 2);
+			FString TypeName;
+			OutType = EPathParamType::String;
+			if (Body.StartsWith(TEXT("*")))
+			{
+				OutType = EPathParamType::CatchAll;
+				Body.RightChopInline(1, false);
+			}
+			else if (Body.Split(TEXT(":"), &OutName, &TypeName))
+			{
+				Body = OutName;
+				if (TypeName == TEXT("int"))
+				{
+					OutType = EPathParamType::Int;
+				}
+				else if (TypeName == TEXT("float"))
+				{
+					OutType = EPathParamType::Float;
+				}
+				else if (TypeName != TEXT("str"))
+				{
+					return true;
+				}
+			}
+			OutName = Body;
+			bOutValid = !OutName.IsEmpty();
+			return true;
+		}
+	}
+
+	/** ========================== Path Params ======================= */
+
+	const FPathParams* FPathParams::GetCurrent()
+	{
+		return GPathParams;
+	}
+
+	const FPathParams::FParam* FPathParams::Find(const TCHAR* Name) const
+	{
+		for (int32 Index = 0; Index < NumParams; ++Index)
+		{
+			if (FCString::Strcmp(Params[Index].Name, Name) == 0)
+			{
+				return &Params[Index];
+			}
+		}
+		return nullptr;
+	}
+
+	bool FPathParams::GetInt(const TCHAR* Name, int64& OutValue) const
+	{
+		const FParam* Param = Find(Name);
+		if (Param == nullptr || Param->Type != EPathParamType::Int)
+		{
+			return false;
+		}
+		OutValue = Param->Int;
+		return true;
+	}
+
+	bool FPathParams::GetFloat(const TCHAR* Name, double& OutValue) const
+	{
+		const FParam* Param = Find(Name);
+		if (Param == nullptr || (Param->Type != EPathParamType::Int && Param->Type != EPathParamType::Float))
+		{
+			return false;
+		}
+		OutValue = Param->Type == EPathParamType::Int ? (double)Param->Int : Param->Float;
+		return true;
+	}
+
+	bool FPathParams::GetString(const TCHAR* Name, FString& OutValue) const
+	{
+		const FParam* Param = Find(Name);
+		if (Param == nullptr || Path == nullptr)
+		{
+			return false;
+		}
+		OutValue = FString(Param->Len, Path + Param->Start);
+		return true;
+	}
+
+	/** ========================== Path Router ======================= */
+
+	FPathRouter::FPathRouter(const FString& InPrefix)
+		: Prefix(InPrefix)
+		, bBound(false)
+	{
+		Nodes.AddDefaulted();
+		NotFoundHandler = FWebUtil::CreateHandler([](const FHttpServerRequest& Request)
+		{
+			TUniquePtr<FHttpServerResponse> Response = FWebUtil::ErrorResponse(FString::Printf(TEXT("Route not found: %s"), *Request.RelativePath.GetPath()), static_cast<int32>(EHttpServerResponseCodes::NotFound));
+			Response->Code = EHttpServerResponseCodes::NotFound;
+			return Response;
+		});
+	}
+
+	bool FPathRouter::AddRoute(const FString& Pattern, const EHttpServerRequestVerbs& Verb, const FPathResponser& Responser)
+	{
+		TSharedRef<FRouteMetrics, ESPMode::ThreadSafe> RouteMetrics = FRouteMetrics::Register(Pattern, FWebUtil::GetHttpVerbStringFromEnum(Verb));
+		return AddHandler(Pattern, Verb, FWebUtil::CreateHandler([Responser](const FHttpServerRequest& Request)
+		{
+			const FPathParams* Params = FPathParams::GetCurrent();
+			check(Params != nullptr);
+			return Responser(Request, *Params);
+		}, RouteMetrics));
+	}
+
+	bool FPathRouter::AddAsyncRoute(const FString& Pattern, const EHttpServerRequestVerbs& Verb, const FAsyncPathResponser& Responser)
+	{
+		TSharedRef<FRouteMetrics, ESPMode::ThreadSafe> RouteMetrics = FRouteMetrics::Register(Pattern, FWebUtil::GetHttpVerbStringFromEnum(Verb));
+		return AddHandler(Pattern, Verb, FWebUtil::CreateAsyncHandler([Responser](const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+		{
+			const FPathParams* CurrentParams = FPathParams::GetCurrent();
+			check(CurrentParams != nullptr);
+			// values are ranges of path, refer them to the shared copy of request
+			FPathParams Params = *CurrentParams;
+			Params.Path = *Request->RelativePath.GetPath();
+			Responser(Request, Params, Respond);
+		}, RouteMetrics));
+	}
+
+	bool FPathRouter::AddHandler(const FString& Pattern, const EHttpServerRequestVerbs& Verb, const FHttpRequestHandler& Handler)
+	{
+		int32 VerbIndex = GetVerbIndex(Verb);
+		if (bBound || VerbIndex == INDEX_NONE)
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Cannot add path route: %s\t%s"), *FWebUtil::GetHttpVerbStringFromEnum(Verb), *Pattern);
+			return false;
+		}
+		if (Pattern != Prefix && !Pattern.StartsWith(Prefix + TEXT("/")))
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Path route %s is out of prefix %s"), *Pattern, *Prefix);
+			return false;
+		}
+
+		TArray<FString> Segments;
+		Pattern.ParseIntoArray(Segments, TEXT("/"));
+		int32 NumParams = 0;
+		int32 Node = 0;
+		for (int32 Index = 0; Index < Segments.Num(); ++Index)
+		{
+			const FString& Segment = Segments[Index];
+			FString ParamName;
+			EPathParamType ParamType;
+			bool bValid;
+			if (!ParseParamSegment(Segment, ParamName, ParamType, bValid))
+			{
+				int32 EdgeIndex = Algo::LowerBoundBy(Nodes[Node].Literals, Segment, &FLiteralEdge::Segment, [](const FString& A, const FString& B) { return A.Compare(B, ESearchCase::CaseSensitive) < 0; });
+				if (EdgeIndex < Nodes[Node].Literals.Num() && Nodes[Node].Literals[EdgeIndex].Segment.Equals(Segment, ESearchCase::CaseSensitive))
+				{
+					Node = Nodes[Node].Literals[EdgeIndex].Node;
+					continue;
+				}
+				int32 Child = Nodes.AddDefaulted();
+				Nodes[Node].Literals.Insert(FLiteralEdge{ Segment, Child }, EdgeIndex);
+				Node = Child;
+				continue;
+			}
+			if (!bValid || ++NumParams > FPathParams::MAX_PARAMS || (ParamType == EPathParamType::CatchAll && Index != Segments.Num() - 1))
+			{
+				UE_LOG(UHttpLog, Warning, TEXT("Invalid path route pattern: %s"), *Pattern);
+				return false;
+			}
+			int32 Child = Nodes[Node].ParamChildren[(int32)ParamType];
+			if (Child == INDEX_NONE)
+			{
+				Child = Nodes.AddDefaulted();
+				Nodes[Child].ParamName = ParamName;
+				Nodes[Node].ParamChildren[(int32)ParamType] = Child;
+			}
+			else if (Nodes[Child].ParamName != ParamName)
+			{
+				UE_LOG(UHttpLog, Warning, TEXT("Path route %s renames parameter %s"), *Pattern, *Nodes[Child].ParamName);
+				return false;
+			}
+			Node = Child;
+		}
+
+		if (Nodes[Node].Route == INDEX_NONE)
+		{
+			Nodes[Node].Route = Routes.AddDefaulted();
+			Routes[Nodes[Node].Route].Pattern = Pattern;
+		}
+		FRoute& Route = Routes[Nodes[Node].Route];
+		if (Route.Handlers[VerbIndex])
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Path route is already bound: %s\t%s"), *FWebUtil::GetHttpVerbStringFromEnum(Verb), *Pattern);
+			return false;
+		}
+		Route.Handlers[VerbIndex] = Handler;
+		Route.Verbs |= Verb;
+		return true;
+	}
+
+	FHttpRouteHandle FPathRouter::Bind(const TSharedPtr<IHttpRouter>& HttpRouter)
+	{
+		if (bBound || Routes.Num() == 0)
+		{
+			return nullptr;
+		}
+		bBound = true;
+		Nodes.Shrink();
+		Routes.Shrink();
+		// every dispatched verb is bound, so that a verb no route handles is answered with 405 instead of 404 of engine router
+		EHttpServerRequestVerbs Verbs = EHttpServerRequestVerbs::VERB_NONE;
+		for (EHttpServerRequestVerbs Verb : DISPATCHED_VERBS)
+		{
+			Verbs |= Verb;
+		}
+		TSharedRef<const FPathRouter, ESPMode::ThreadSafe> Router = AsShared();
+		return FWebUtil::BindRouteHandler(HttpRouter, Prefix, Verbs, [Router](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+		{
+			return Router->Dispatch(Request, OnComplete);
+		});
+	}
+
+	int32 FPathRouter::Match(const FString& Path, FPathParams& OutParams) const
+	{
+		const TCHAR* Data = *Path;
+		const int32 Len = Path.Len();
+		OutParams.Path = Data;
+		OutParams.NumParams = 0;
+
+		int32 Node = 0;
+		int32 Pos = 0;
+		while (Pos < Len)
+		{
+			// next segment, empty segments (duplicated or trailing slashes) are skipped
+			if (Data[Pos] == TEXT('/'))
+			{
+				++Pos;
+				continue;
+			}
+			int32 End = Pos;
+			while (End < Len && Data[End] != TEXT('/'))
+			{
+				++End;
+			}
+			const TCHAR* Segment = Data + Pos;
+			const int32 SegmentLen = End - Pos;
+			const FNode& Current = Nodes[Node];
+
+			// literal children by binary search
+			int32 Low = 0;
+			int32 High = Current.Literals.Num();
+			int32 Next = INDEX_NONE;
+			while (Low < High)
+			{
+				int32 Mid = (Low + High) / 2;
+				int32 Result = CompareSegment(Segment, SegmentLen, Current.Literals[Mid].Segment);
+				if (Result == 0)
+				{
+					Next = Current.Literals[Mid].Node;
+					break;
+				}
+				if (Result < 0)
+				{
+					High = Mid;
+				}
+				else
+				{
+					Low = Mid + 1;
+				}
+			}
+			if (Next != INDEX_NONE)
+			{
+				Node = Next;
+				Pos = End;
+				continue;
+			}
+
+			// parameter children by type
+			FPathParams::FParam& Param = OutParams.Params[OutParams.NumParams];
+			Param.Start = Pos;
+			Param.Len = SegmentLen;
+			Param.Int = 0;
+			Param.Float = 0;
+			if (Current.ParamChildren[(int32)EPathParamType::Int] != INDEX_NONE && ParseInt(Segment, SegmentLen, Param.Int))
+			{
+				Param.Type = EPathParamType::Int;
+			}
+			else if (Current.ParamChildren[(int32)EPathParamType::Float] != INDEX_NONE && ParseFloat(Segment, SegmentLen, Param.Float))
+			{
+				Param.Type = EPathParamType::Float;
+			}
+			else if (Current.ParamChildren[(int32)EPathParamType::String] != INDEX_NONE)
+			{
+				Param.Type = EPathParamType::String;
+			}
+			else if (Current.ParamChildren[(int32)EPathParamType::CatchAll] != INDEX_NONE)
+			{
+				Param.Type = EPathParamType::CatchAll;
+				Param.Len = Len - Pos;
+				End = Len;
+			}
+			else
+			{
+				return INDEX_NONE;
+			}
+			Node = Current.ParamChildren[(int32)Param.Type];
+			Param.Name = *Nodes[Node].ParamName;
+			++OutParams.NumParams;
+			Pos = End;
+		}
+
+		// catch-all matches empty rest
+		int32 CatchAll = Nodes[Node].ParamChildren[(int32)EPathParamType::CatchAll];
+		if (Nodes[Node].Route == INDEX_NONE && CatchAll != INDEX_NONE)
+		{
+			FPathParams::FParam& Param = OutParams.Params[OutParams.NumParams++];
+			Param.Name = *Nodes[CatchAll].ParamName;
+			Param.Type = EPathParamType::CatchAll;
+			Param.Start = Len;
+			Param.Len = 0;
+			Param.Int = 0;
+			Param.Float = 0;
+			Node = CatchAll;
+		}
+		return Nodes[Node].Route;
+	}
+
+	bool FPathRouter::Dispatch(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete) const
+	{
+		const FString& Path = Request.RelativePath.GetPath();
+		FPathParams Params;
+		int32 RouteIndex = Match(Path, Params);
+		if (RouteIndex == INDEX_NONE)
+		{
+			return NotFoundHandler(Request, OnComplete);
+		}
+		const FRoute& Route = Routes[RouteIndex];
+		int32 VerbIndex = GetVerbIndex(Request.Verb);
+		if (VerbIndex == INDEX_NONE || !Route.Handlers[VerbIndex])
+		{
+			FString Allow;
+			for (EHttpServerRequestVerbs Verb : DISPATCHED_VERBS)
+			{
+				if (EnumHasAnyFlags(Route.Verbs, Verb))
+				{
+					Allow += Allow.IsEmpty() ? FWebUtil::GetHttpVerbStringFromEnum(Verb) : TEXT(", ") + FWebUtil::GetHttpVerbStringFromEnum(Verb);
+				}
+			}
+			return FWebUtil::CreateHandler([&Route, Allow](const FHttpServerRequest&)
+			{
+				TUniquePtr<FHttpServerResponse> Response = FWebUtil::ErrorResponse(FString::Printf(TEXT("Method not allowed: %s"), *Route.Pattern), static_cast<int32>(EHttpServerResponseCodes::BadMethod));
+				Response->Code = EHttpServerResponseCodes::BadMethod;
+				Response->Headers.Add(TEXT("allow"), { Allow });
+				return Response;
+			})(Request, OnComplete);
+		}
+		FPathParamsScope ParamsScope(&Params);
+		return Route.Handlers[VerbIndex](Request, OnComplete);
+	}
+
+	int32 FPathRouter::GetVerbIndex(const EHttpServerRequestVerbs& Verb)
+	{
+		switch (Verb)
+		{
+		case EHttpServerRequestVerbs::VERB_GET:
+			return 0;
+		case EHttpServerRequestVerbs::VERB_POST:
+			return 1;
+		case EHttpServerRequestVerbs::VERB_PUT:
+			return 2;
+		case EHttpServerRequestVerbs::VERB_DELETE:
+			return 3;
+		case EHttpServerRequestVerbs::VERB_PATCH:
+			return 4;
+		case EHttpServerRequestVerbs::VERB_OPTIONS:
+			return 5;
+		default:
+			return INDEX_NONE;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Util/WebUtil.h"
+
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Type of path parameter, a segment is matched by the first type it parses as
+	 */
+	enum class EPathParamType : uint8
+	{
+		/* {name:int}, signed 64-bit integer */
+		Int,
+		/* {name:float}, decimal number */
+		Float,
+		/* {name}, any non-empty segment */
+		String,
+		/* {*name}, rest of the path (may be empty), only as last segment */
+		CatchAll,
+	};
+
+	/**
+	 * Path parameters extracted by matching, fixed size & without allocation
+	 * Values refer to the path of the matched request, so they are valid as long as the request is
+	 */
+	class FPathParams
+	{
+	public:
+		/* Max parameters in one route pattern */
+		static const int32 MAX_PARAMS = 8;
+
+		/**
+		 * Get parameters being dispatched on current thread, nullptr if not in a path routed request
+		 */
+		static const FPathParams* GetCurrent();
+
+		int32 Num() const { return NumParams; }
+
+		/**
+		 * Get integer parameter, returns false if not found or not an int parameter
+		 */
+		bool GetInt(const TCHAR* Name, int64& OutValue) const;
+
+		/**
+		 * Get number parameter (int or float), returns false if not found
+		 */
+		bool GetFloat(const TCHAR* Name, double& OutValue) const;
+
+		/**
+		 * Get raw (url decoded) text of parameter, returns false if not found
+		 */
+		bool GetString(const TCHAR* Name, FString& OutValue) const;
+
+	private:
+		friend class FPathRouter;
+
+		struct FParam
+		{
+			/* Name owned by route trie */
+			const TCHAR* Name;
+			EPathParamType Type;
+			/* Range of value in path */
+			int32 Start;
+			int32 Len;
+			int64 Int;
+			double Float;
+		};
+
+		const FParam* Find(const TCHAR* Name) const;
+
+		/* Path the values refer to */
+		const TCHAR* Path = nullptr;
+		FParam Params[MAX_PARAMS];
+		int32 NumParams = 0;
+	};
+
+	/**
+	 * Path responser function, handles request with path parameters on game thread
+	 */
+	typedef TFunction<TUniquePtr<FHttpServerResponse>(const FHttpServerRequest& Request, const FPathParams& Params)> FPathResponser;
+
+	/**
+	 * Async path responser function, params refer to the shared request & can be copied along with it
+	 */
+	typedef TFunction<void(const FHttpServerRequestRef& Request, const FPathParams& Params, const FHttpResponseCallback& Respond)> FAsyncPathResponser;
+
+	/**
+	 * Sub-router bound to engine router as one catch-all prefix, dispatching the rest of the path by a prefix trie
+	 * Patterns are full paths with segments of literal text or parameters, e.g. /actors/{id:int}/transform
+	 * - a segment matches literal children first, then parameter children by type (int, float, string), then catch-all
+	 *   without backtracking, so matching is O(path length) and never allocates
+	 * - each pattern dispatches by verb to its own handler & route metrics, 405 with allow header if verb is not bound
+	 * Routes should be added before binding, the trie is read only after
+	 */
+	class FPathRouter : public TSharedFromThis<FPathRouter, ESPMode::ThreadSafe>
+	{
+	public:
+		explicit FPathRouter(const FString& InPrefix);
+
+		/**
+		 * Add route of pattern & verb with handler, returns false if pattern is invalid, out of prefix or already bound
+		 */
+		bool AddRoute(const FString& Pattern, const EHttpServerRequestVerbs& Verb, const FPathResponser& Responser);
+
+		/**
+		 * Add route of pattern & verb with async handler
+		 */
+		bool AddAsyncRoute(const FString& Pattern, const EHttpServerRequestVerbs& Verb, const FAsyncPathResponser& Responser);
+
+		/**
+		 * Bind prefix to engine router with all dispatched verbs (verbs not added are answered with 405)
+		 */
+		FHttpRouteHandle Bind(const TSharedPtr<IHttpRouter>& HttpRouter);
+
+		/**
+		 * Match path, returns matched route index (INDEX_NONE if no match) & outputs params
+		 */
+		int32 Match(const FString& Path, FPathParams& OutParams) const;
+
+		const FString& GetPrefix() const { return Prefix; }
+
+	private:
+		/* Verbs dispatched by routes, same order as verb indices */
+		static const int32 NUM_VERBS = 6;
+
+		/**
+		 * Literal edge of trie node, sorted by segment
+		 */
+		struct FLiteralEdge
+		{
+			FString Segment;
+			int32 Node;
+		};
+
+		/**
+		 * Trie node, a path segment
+		 */
+		struct FNode
+		{
+			TArray<FLiteralEdge> Literals;
+			/* Parameter children by EPathParamType */
+			int32 ParamChildren[4] = { INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+			/* Parameter name if the node is a parameter segment */
+			FString ParamName;
+			/* Route ending at this node */
+			int32 Route = INDEX_NONE;
+		};
+
+		/**
+		 * Route of a pattern, handlers by verb index
+		 */
+		struct FRoute
+		{
+			FString Pattern;
+			FHttpRequestHandler Handlers[NUM_VERBS];
+			EHttpServerRequestVerbs Verbs = EHttpServerRequestVerbs::VERB_NONE;
+		};
+
+		/**
+		 * Add handler of pattern & verb into trie
+		 */
+		bool AddHandler(const FString& Pattern, const EHttpServerRequestVerbs& Verb, const FHttpRequestHandler& Handler);
+
+		/**
+		 * Dispatch request to handler of matched route & verb
+		 */
+		bool Dispatch(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete) const;
+
+		static int32 GetVerbIndex(const EHttpServerRequestVerbs& Verb);
+
+		const FString Prefix;
+		TArray<FNode> Nodes;
+		TArray<FRoute> Routes;
+		bool bBound;
+		FHttpRequestHandler NotFoundHandler;
+	};
+}
\ No newline at end of file
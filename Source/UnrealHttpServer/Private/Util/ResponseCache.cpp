@@ -0,0 +1,142 @@
+#include "Util/ResponseCache.h"
+#include "Util/HttpCompression.h"
+#include "Util/WebUtil.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeLock.h"
+
+namespace UnrealHttpServer
+{
+	TUniquePtr<FHttpServerResponse> FResponseCache::Find(const FHttpServerRequest& Request, uint64 InFrame)
+	{
+		FString Key = MakeKey(Request);
+		FName Encoding = FHttpCompression::NegotiateEncoding(Request);
+		TUniquePtr<FHttpServerResponse> Response;
+		{
+			FScopeLock CacheLock(&Lock);
+			if (Frame != InFrame)
+			{
+				return nullptr;
+			}
+			const FEntry* Entry = Entries.Find(Key);
+			if (Entry == nullptr)
+			{
+				return nullptr;
+			}
+			Response = CreateResponse(Request, *Entry, Encoding);
+		}
+		return Encode(Key, InFrame, Encoding, MoveTemp(Response));
+	}
+
+	TUniquePtr<FHttpServerResponse> FResponseCache::Add(const FHttpServerRequest& Request, uint64 InFrame, TUniquePtr<FHttpServerResponse> Response, bool bSucceeded)
+	{
+		if (Response == nullptr || Response->Code != EHttpServerResponseCodes::Ok || !bSucceeded)
+		{
+			return Response;
+		}
+		FEntry Entry;
+		Entry.Code = Response->Code;
+		Entry.Headers = MoveTemp(Response->Headers);
+		Entry.Body = MoveTemp(Response->Body);
+		Entry.ETag = FString::Printf(TEXT("\"%016llx\""), CityHash64(reinterpret_cast<const char*>(Entry.Body.GetData()), Entry.Body.Num()));
+		Entry.Headers.Add(TEXT("etag"), { Entry.ETag });
+
+		FString Key = MakeKey(Request);
+		FName Encoding = FHttpCompression::NegotiateEncoding(Request);
+		{
+			FScopeLock CacheLock(&Lock);
+			// a newer frame drops responses of previous frames, a reader that raced with publishing does not cache its older state
+			if (Frame == MAX_uint64 || InFrame > Frame)
+			{
+				Frame = InFrame;
+				Entries.Reset();
+			}
+			if (InFrame != Frame || Entries.Num() >= MAX_ENTRIES_PER_FRAME)
+			{
+				Response = CreateResponse(Request, Entry, Encoding);
+			}
+			else
+			{
+				Response = CreateResponse(Request, Entries.Add(Key, MoveTemp(Entry)), Encoding);
+			}
+		}
+		return Encode(Key, InFrame, Encoding, MoveTemp(Response));
+	}
+
+	TUniquePtr<FHttpServerResponse> FResponseCache::Encode(const FString& Key, uint64 InFrame, FName Encoding, TUniquePtr<FHttpServerResponse> Response)
+	{
+		// compressed out of lock, so that readers of other queries are not blocked by it
+		if (!FHttpCompression::ShouldCompress(*Response, Encoding))
+		{
+			return Response;
+		}
+		FHttpCompression::CompressResponse(*Response, Encoding);
+		if (!Response->Headers.Contains(TEXT("content-encoding")))
+		{
+			return Response;
+		}
+		FScopeLock CacheLock(&Lock);
+		FEntry* Entry = Frame == InFrame ? Entries.Find(Key) : nullptr;
+		if (Entry != nullptr && !Entry->Encoded.Contains(Encoding))
+		{
+			Entry->Encoded.Add(Encoding, { Response->Headers, Response->Body });
+		}
+		return Response;
+	}
+
+	FString FResponseCache::MakeKey(const FHttpServerRequest& Request)
+	{
+		TArray<FString> QueryKeys;
+		Request.QueryParams.GetKeys(QueryKeys);
+		QueryKeys.Sort();
+		FString Key = FWebUtil::GetResponseFormat() == EBodyFormat::MsgPack ? TEXT("msgpack?") : TEXT("json?");
+		for (const FString& QueryKey : QueryKeys)
+		{
+			Key += QueryKey;
+			Key += TEXT("=");
+			Key += Request.QueryParams[QueryKey];
+			Key += TEXT("&");
+		}
+		return Key;
+	}
+
+	bool FResponseCache::MatchesETag(const FHttpServerRequest& Request, const FString& ETag)
+	{
+		const TArray<FString>* IfNoneMatchValues = Request.Headers.Find(TEXT("if-none-match"));
+		if (IfNoneMatchValues == nullptr)
+		{
+			return false;
+		}
+		for (const FString& Value : *IfNoneMatchValues)
+		{
+			TArray<FString> Tags;
+			Value.ParseIntoArray(Tags, TEXT(","));
+			for (FString& Tag : Tags)
+			{
+				Tag.TrimStartAndEndInline();
+				// weak comparison, as the body is same for W/ prefixed tag
+				Tag.RemoveFromStart(TEXT("W/"));
+				if (Tag == TEXT("*") || Tag == ETag)
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	TUniquePtr<FHttpServerResponse> FResponseCache::CreateResponse(const FHttpServerRequest& Request, const FEntry& Entry, FName Encoding)
+	{
+		TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+		if (MatchesETag(Request, Entry.ETag))
+		{
+			Response->Code = EHttpServerResponseCodes::NotModified;
+			Response->Headers.Add(TEXT("etag"), { Entry.ETag });
+			return Response;
+		}
+		Response->Code = Entry.Code;
+		const FEncodedBody* EncodedBody = Entry.Encoded.Find(Encoding);
+		Response->Headers = EncodedBody != nullptr ? EncodedBody->Headers : Entry.Headers;
+		Response->Body = EncodedBody != nullptr ? EncodedBody->Body : Entry.Body;
+		return Response;
+	}
+}
\ No newline at end of file
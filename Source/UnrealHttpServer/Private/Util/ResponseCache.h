@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerRequest.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerResponse.h"
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Frame-coherent response cache of a read route, thread safe for routes served on worker threads
+	 * Responses are kept for the frame of the state they are read at, keyed by query & response format,
+	 * and tagged with a hash of the body so that If-None-Match is answered with 304 when the body has not changed
+	 * Bodies are compressed once per accepted encoding, cached responses are sent as is
+	 */
+	class FResponseCache
+	{
+	public:
+		/**
+		 * Get cached response of request at frame (304 if request already has it), nullptr if not cached
+		 */
+		TUniquePtr<FHttpServerResponse> Find(const FHttpServerRequest& Request, uint64 Frame);
+
+		/**
+		 * Cache response of request read at frame if it succeeded, returns response to send (tagged, 304 if request already has it)
+		 * Failed responses are returned as is, so that the next query retries
+		 */
+		TUniquePtr<FHttpServerResponse> Add(const FHttpServerRequest& Request, uint64 Frame, TUniquePtr<FHttpServerResponse> Response, bool bSucceeded);
+
+		/**
+		 * Check if If-None-Match header of request matches entity tag (weak comparison)
+		 */
+		static bool MatchesETag(const FHttpServerRequest& Request, const FString& ETag);
+
+	private:
+		/* Max cached responses in one frame, further queries are not cached */
+		static const int32 MAX_ENTRIES_PER_FRAME = 256;
+
+		/**
+		 * Compressed body of cached response
+		 */
+		struct FEncodedBody
+		{
+			TMap<FString, TArray<FString>> Headers;
+			TArray<uint8> Body;
+		};
+
+		/**
+		 * Cached response
+		 */
+		struct FEntry
+		{
+			EHttpServerResponseCodes Code;
+			TMap<FString, TArray<FString>> Headers;
+			TArray<uint8> Body;
+			FString ETag;
+			TMap<FName, FEncodedBody> Encoded;
+		};
+
+		/**
+		 * Make cache key from query params (order independent) & response format
+		 */
+		static FString MakeKey(const FHttpServerRequest& Request);
+
+		/**
+		 * Create response from cache entry in encoding (304 if request already has it), identity body if not compressed in encoding yet
+		 */
+		static TUniquePtr<FHttpServerResponse> CreateResponse(const FHttpServerRequest& Request, const FEntry& Entry, FName Encoding);
+
+		/**
+		 * Compress identity response in encoding if it should be, and keep the compressed body in entry of key if it is still cached at frame
+		 */
+		TUniquePtr<FHttpServerResponse> Encode(const FString& Key, uint64 InFrame, FName Encoding, TUniquePtr<FHttpServerResponse> Response);
+
+		FCriticalSection Lock;
+		/* Frame of cached responses */
+		uint64 Frame = MAX_uint64;
+		TMap<FString, FEntry> Entries;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "Util/RouteMetrics.h"
+#include "Util/AccessLog.h"
+#include "Util/StartupTiming.h"
+#include "Misc/DateTime.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		/* Current request metrics of thread */
+		thread_local FRequestMetrics* GRequestMetrics = nullptr;
+
+		/* Registered route metrics, only appended on binding */
+		TArray<TSharedRef<FRouteMetrics, ESPMode::ThreadSafe>> GRouteMetrics;
+		FCriticalSection GRouteMetricsLock;
+
+		/* Quantiles exported for each histogram */
+		const double EXPORTED_QUANTILES[] = { 0.5, 0.9, 0.99 };
+
+		uint64 CyclesToMicroseconds(uint64 Cycles)
+		{
+			return (uint64)(FPlatformTime::ToSeconds64(Cycles) * 1000000.0);
+		}
+
+		void AppendCounter(FString& Out, const TCHAR* Name, const TCHAR* Help, const TArray<TSharedRef<FRouteMetrics, ESPMode::ThreadSafe>>& Routes, TFunctionRef<uint64(const FRouteMetrics&)> GetValue)
+		{
+			Out += FString::Printf(TEXT("# HELP %s %s\n# TYPE %s counter\n"), Name, Help, Name);
+			for (const auto& Route : Routes)
+			{
+				Out += FString::Printf(TEXT("%s{route=\"%s\",verb=\"%s\"} %llu\n"), Name, *Route->Path, *Route->Verb, GetValue(*Route));
+			}
+		}
+
+		void AppendSummary(FString& Out, const TCHAR* Name, const TCHAR* Help, const TArray<TSharedRef<FRouteMetrics, ESPMode::ThreadSafe>>& Routes, TFunctionRef<const FLatencyHistogram&(const FRouteMetrics&)> GetHistogram)
+		{
+			Out += FString::Printf(TEXT("# HELP %s %s\n# TYPE %s summary\n"), Name, Help, Name);
+			for (const auto& Route : Routes)
+			{
+				const FLatencyHistogram& Histogram = GetHistogram(*Route);
+				for (double Quantile : EXPORTED_QUANTILES)
+				{
+					Out += FString::Printf(TEXT("%s{route=\"%s\",verb=\"%s\",quantile=\"%g\"} %.9g\n"),
+						Name, *Route->Path, *Route->Verb, Quantile, Histogram.GetQuantile(Quantile));
+				}
+				Out += FString::Printf(TEXT("%s_sum{route=\"%s\",verb=\"%s\"} %.9g\n"), Name, *Route->Path, *Route->Verb, Histogram.GetSumSeconds());
+				Out += FString::Printf(TEXT("%s_count{route=\"%s\",verb=\"%s\"} %llu\n"), Name, *Route->Path, *Route->Verb, Histogram.GetCount());
+			}
+		}
+	}
+
+	/* ================= Latency Histogram ==================== */
+
+	FLatencyHistogram::FLatencyHistogram()
+		: Count(0)
+		, SumMicroseconds(0)
+	{
+		for (std::atomic<uint64>& Bucket : Buckets)
+		{
+			Bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void FLatencyHistogram::Record(uint64 Cycles)
+	{
+		uint64 Microseconds = CyclesToMicroseconds(Cycles);
+		int32 Bucket = Microseconds == 0 ? 0 : FMath::Min<int32>(NUM_BUCKETS - 1, FMath::FloorLog2_64(Microseconds) + 1);
+		Buckets[Bucket].fetch_add(1, std::memory_order_relaxed);
+		Count.fetch_add(1, std::memory_order_relaxed);
+		SumMicroseconds.fetch_add(Microseconds, std::memory_order_relaxed);
+	}
+
+	double FLatencyHistogram::GetQuantile(double Quantile) const
+	{
+		// snapshot buckets, count is summed from the snapshot to keep it consistent
+		uint64 Snapshot[NUM_BUCKETS];
+		uint64 Total = 0;
+		for (int32 Index = 0; Index < NUM_BUCKETS; ++Index)
+		{
+			Snapshot[Index] = Buckets[Index].load(std::memory_order_relaxed);
+			Total += Snapshot[Index];
+		}
+		if (Total == 0)
+		{
+			return 0;
+		}
+		double Rank = FMath::Clamp(Quantile, 0.0, 1.0) * Total;
+		uint64 Cumulative = 0;
+		for (int32 Index = 0; Index < NUM_BUCKETS; ++Index)
+		{
+			if (Snapshot[Index] == 0 || Cumulative + Snapshot[Index] < Rank)
+			{
+				Cumulative += Snapshot[Index];
+				continue;
+			}
+			double Lower = Index == 0 ? 0 : (double)(1ull << (Index - 1));
+			double Upper = (double)(1ull << Index);
+			double Microseconds = Lower + (Upper - Lower) * (Rank - Cumulative) / Snapshot[Index];
+			return Microseconds / 1000000.0;
+		}
+		return (double)(1ull << (NUM_BUCKETS - 1)) / 1000000.0;
+	}
+
+	uint64 FLatencyHistogram::GetCount() const
+	{
+		return Count.load(std::memory_order_relaxed);
+	}
+
+	double FLatencyHistogram::GetSumSeconds() const
+	{
+		return SumMicroseconds.load(std::memory_order_relaxed) / 1000000.0;
+	}
+
+	/* ================= Route Metrics ==================== */
+
+	FRouteMetrics::FRouteMetrics(const FString& InPath, const FString& InVerb)
+		: Path(InPath)
+		, Verb(InVerb)
+		, Requests(0)
+		, Errors(0)
+		, BytesIn(0)
+		, BytesOut(0)
+	{
+	}
+
+	TSharedRef<FRouteMetrics, ESPMode::ThreadSafe> FRouteMetrics::Register(const FString& Path, const FString& Verb)
+	{
+		FScopeLock Lock(&GRouteMetricsLock);
+		for (const auto& Route : GRouteMetrics)
+		{
+			// rebinding a route (server restarted) keeps its metrics
+			if (Route->Path == Path && Route->Verb == Verb)
+			{
+				return Route;
+			}
+		}
+		return GRouteMetrics.Add_GetRef(MakeShared<FRouteMetrics, ESPMode::ThreadSafe>(Path, Verb));
+	}
+
+	FString FRouteMetrics::ExportPrometheusText()
+	{
+		TArray<TSharedRef<FRouteMetrics, ESPMode::ThreadSafe>> Routes;
+		{
+			FScopeLock Lock(&GRouteMetricsLock);
+			Routes = GRouteMetrics;
+		}
+		FString Out;
+		Out.Reserve(Routes.Num() * 2048);
+		AppendCounter(Out, TEXT("uhttp_requests_total"), TEXT("Requests handled."), Routes,
+			[](const FRouteMetrics& Route) { return Route.Requests.load(std::memory_order_relaxed); });
+		AppendCounter(Out, TEXT("uhttp_errors_total"), TEXT("Requests responded with error or no response."), Routes,
+			[](const FRouteMetrics& Route) { return Route.Errors.load(std::memory_order_relaxed); });
+		AppendCounter(Out, TEXT("uhttp_request_bytes_total"), TEXT("Request body bytes received."), Routes,
+			[](const FRouteMetrics& Route) { return Route.BytesIn.load(std::memory_order_relaxed); });
+		AppendCounter(Out, TEXT("uhttp_response_bytes_total"), TEXT("Response body bytes sent."), Routes,
+			[](const FRouteMetrics& Route) { return Route.BytesOut.load(std::memory_order_relaxed); });
+		AppendSummary(Out, TEXT("uhttp_parse_seconds"), TEXT("Request body parsing time."), Routes,
+			[](const FRouteMetrics& Route) -> const FLatencyHistogram& { return Route.Parse; });
+		AppendSummary(Out, TEXT("uhttp_handler_seconds"), TEXT("Request time excluding parsing and serializing."), Routes,
+			[](const FRouteMetrics& Route) -> const FLatencyHistogram& { return Route.Handler; });
+		AppendSummary(Out, TEXT("uhttp_serialize_seconds"), TEXT("Response body serializing time."), Routes,
+			[](const FRouteMetrics& Route) -> const FLatencyHistogram& { return Route.Serialize; });
+		return Out;
+	}
+
+	/* ================= Request Metrics ==================== */
+
+	FRequestMetrics::FRequestMetrics(const TSharedRef<FRouteMetrics, ESPMode::ThreadSafe>& InRoute, int32 InBytesIn)
+		: Route(InRoute)
+		, StartCycles(FPlatformTime::Cycles64())
+		, ParseCycles(0)
+		, SerializeCycles(0)
+		, bError(false)
+		, BytesIn(InBytesIn)
+	{
+		Route->BytesIn.fetch_add(BytesIn, std::memory_order_relaxed);
+	}
+
+	FRequestMetrics* FRequestMetrics::GetCurrent()
+	{
+		return GRequestMetrics;
+	}
+
+	void FRequestMetrics::AddParseCycles(uint64 Cycles)
+	{
+		ParseCycles.fetch_add(Cycles, std::memory_order_relaxed);
+	}
+
+	void FRequestMetrics::AddSerializeCycles(uint64 Cycles)
+	{
+		SerializeCycles.fetch_add(Cycles, std::memory_order_relaxed);
+	}
+
+	void FRequestMetrics::MarkError()
+	{
+		bError.store(true, std::memory_order_relaxed);
+	}
+
+	void FRequestMetrics::Complete(const FHttpServerResponse* Response)
+	{
+		uint64 TotalCycles = FPlatformTime::Cycles64() - StartCycles;
+		uint64 Parse = ParseCycles.load(std::memory_order_relaxed);
+		uint64 Serialize = SerializeCycles.load(std::memory_order_relaxed);
+		bool bFailed = Response == nullptr || bError.load(std::memory_order_relaxed);
+		Route->Requests.fetch_add(1, std::memory_order_relaxed);
+		if (bFailed)
+		{
+			Route->Errors.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (Response != nullptr)
+		{
+			Route->BytesOut.fetch_add(Response->Body.Num(), std::memory_order_relaxed);
+		}
+		// phases without work (no body parsed) are not recorded, to keep their quantiles meaningful
+		if (Parse > 0)
+		{
+			Route->Parse.Record(Parse);
+		}
+		if (Serialize > 0)
+		{
+			Route->Serialize.Record(Serialize);
+		}
+		Route->Handler.Record(TotalCycles > Parse + Serialize ? TotalCycles - Parse - Serialize : 0);
+		if (Response != nullptr)
+		{
+			FStartupTiming::MarkRequestServed();
+		}
+
+		if (FAccessLog::ShouldRecord(bFailed))
+		{
+			FAccessLogEntry Entry;
+			Entry.Ticks = FDateTime::UtcNow().GetTicks();
+			Entry.Route = &Route.Get();
+			Entry.Code = Response != nullptr ? (int32)Response->Code : (int32)EHttpServerResponseCodes::ServerError;
+			Entry.bError = bFailed;
+			Entry.BytesIn = BytesIn;
+			Entry.BytesOut = Response != nullptr ? Response->Body.Num() : 0;
+			Entry.TotalMicroseconds = CyclesToMicroseconds(TotalCycles);
+			Entry.ParseMicroseconds = CyclesToMicroseconds(Parse);
+			Entry.SerializeMicroseconds = CyclesToMicroseconds(Serialize);
+			FAccessLog::Record(Entry);
+		}
+	}
+
+	FRequestMetricsScope::FRequestMetricsScope(FRequestMetrics* Metrics)
+		: PreviousMetrics(GRequestMetrics)
+	{
+		GRequestMetrics = Metrics;
+	}
+
+	FRequestMetricsScope::~FRequestMetricsScope()
+	{
+		GRequestMetrics = PreviousMetrics;
+	}
+
+	FRequestPhaseTimer::FRequestPhaseTimer(EPhase InPhase)
+		: Phase(InPhase)
+		, StartCycles(FPlatformTime::Cycles64())
+	{
+	}
+
+	FRequestPhaseTimer::~FRequestPhaseTimer()
+	{
+		FRequestMetrics* Metrics = GRequestMetrics;
+		if (Metrics == nullptr)
+		{
+			return;
+		}
+		uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+		if (Phase == EPhase::Parse)
+		{
+			Metrics->AddParseCycles(Cycles);
+		}
+		else
+		{
+			Metrics->AddSerializeCycles(Cycles);
+		}
+	}
+}
\ No newline at end of file
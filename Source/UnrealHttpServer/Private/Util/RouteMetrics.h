@@ -0,0 +1,146 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Online/HTTPServer/Public/HttpServerResponse.h"
+
+#include <atomic>
+
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Latency histogram with log2 buckets of microseconds, recorded with relaxed atomics (lock free)
+	 */
+	class FLatencyHistogram
+	{
+	public:
+		/* Bucket N counts latencies in [2^(N-1), 2^N) microseconds, bucket 0 counts latencies under 1 microsecond */
+		static const int32 NUM_BUCKETS = 32;
+
+		FLatencyHistogram();
+
+		/**
+		 * Record a latency in cycles
+		 */
+		void Record(uint64 Cycles);
+
+		/**
+		 * Estimate quantile (0~1) in seconds, interpolated in bucket
+		 */
+		double GetQuantile(double Quantile) const;
+
+		uint64 GetCount() const;
+
+		double GetSumSeconds() const;
+
+	private:
+		std::atomic<uint64> Buckets[NUM_BUCKETS];
+		std::atomic<uint64> Count;
+		std::atomic<uint64> SumMicroseconds;
+	};
+
+	/**
+	 * Metrics of one bound route
+	 */
+	struct FRouteMetrics
+	{
+		FRouteMetrics(const FString& InPath, const FString& InVerb);
+
+		const FString Path;
+		const FString Verb;
+
+		std::atomic<uint64> Requests;
+		std::atomic<uint64> Errors;
+		std::atomic<uint64> BytesIn;
+		std::atomic<uint64> BytesOut;
+
+		/* Request body parsing time */
+		FLatencyHistogram Parse;
+		/* Request time excluding parsing & serializing (including worker & game thread hops of async handlers) */
+		FLatencyHistogram Handler;
+		/* Response body serializing time */
+		FLatencyHistogram Serialize;
+
+		/**
+		 * Register metrics of a route, should be called on binding
+		 */
+		static TSharedRef<FRouteMetrics, ESPMode::ThreadSafe> Register(const FString& Path, const FString& Verb);
+
+		/**
+		 * Export metrics of all registered routes in Prometheus text format
+		 */
+		static FString ExportPrometheusText();
+	};
+
+	/**
+	 * Metrics of a request in flight, shared by the tasks of an async request
+	 * Set as current request of thread by FRequestMetricsScope, so that parsing & serializing helpers can add their time to it
+	 */
+	class FRequestMetrics : public TSharedFromThis<FRequestMetrics, ESPMode::ThreadSafe>
+	{
+	public:
+		FRequestMetrics(const TSharedRef<FRouteMetrics, ESPMode::ThreadSafe>& InRoute, int32 InBytesIn);
+
+		/**
+		 * Get current request metrics of thread, nullptr if not in a request
+		 */
+		static FRequestMetrics* GetCurrent();
+
+		void AddParseCycles(uint64 Cycles);
+
+		void AddSerializeCycles(uint64 Cycles);
+
+		/**
+		 * Mark the request as failed (error response created)
+		 */
+		void MarkError();
+
+		bool HasError() const { return bError.load(std::memory_order_relaxed); }
+
+		/**
+		 * Record request into route metrics & access log, call once on responding (response can be nullptr if handler failed)
+		 */
+		void Complete(const FHttpServerResponse* Response);
+
+	private:
+		TSharedRef<FRouteMetrics, ESPMode::ThreadSafe> Route;
+		uint64 StartCycles;
+		std::atomic<uint64> ParseCycles;
+		std::atomic<uint64> SerializeCycles;
+		std::atomic<bool> bError;
+		int32 BytesIn;
+	};
+
+	/**
+	 * Set current request metrics of thread in scope
+	 */
+	class FRequestMetricsScope
+	{
+	public:
+		explicit FRequestMetricsScope(FRequestMetrics* Metrics);
+		~FRequestMetricsScope();
+
+	private:
+		FRequestMetrics* PreviousMetrics;
+	};
+
+	/**
+	 * Measure cycles in scope and add them to parse or serialize time of current request
+	 */
+	class FRequestPhaseTimer
+	{
+	public:
+		enum class EPhase : uint8
+		{
+			Parse,
+			Serialize,
+		};
+
+		explicit FRequestPhaseTimer(EPhase InPhase);
+		~FRequestPhaseTimer();
+
+	private:
+		EPhase Phase;
+		uint64 StartCycles;
+	};
+}
\ No newline at end of file
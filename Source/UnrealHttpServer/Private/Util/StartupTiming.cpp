@@ -0,0 +1,70 @@
+#include "Util/StartupTiming.h"
+#include "Log.h"
+#include "HAL/PlatformTime.h"
+
+#include <atomic>
+
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		/* Milestones in seconds since process start, negative if not reached */
+		std::atomic<double> GModuleLoadedSeconds(-1.0);
+		std::atomic<double> GListeningSeconds(-1.0);
+		std::atomic<double> GFirstRequestSeconds(-1.0);
+		std::atomic<bool> bRequestServed(false);
+
+		double GetSecondsSinceProcessStart()
+		{
+			return FPlatformTime::Seconds() - GStartTime;
+		}
+
+		void AppendGauge(FString& Out, const TCHAR* Phase, double Seconds)
+		{
+			if (Seconds >= 0)
+			{
+				Out += FString::Printf(TEXT("uhttp_startup_seconds{phase=\"%s\"} %.6f\n"), Phase, Seconds);
+			}
+		}
+	}
+
+	void FStartupTiming::MarkModuleLoaded()
+	{
+		GModuleLoadedSeconds.store(GetSecondsSinceProcessStart());
+		GListeningSeconds.store(-1.0);
+		GFirstRequestSeconds.store(-1.0);
+		bRequestServed.store(false);
+	}
+
+	void FStartupTiming::MarkListening()
+	{
+		double Seconds = GetSecondsSinceProcessStart();
+		GListeningSeconds.store(Seconds);
+		UE_LOG(UHttpLog, Log, TEXT("UnrealHttpServer listening %.3fs after module load (%.3fs after process start)"),
+			Seconds - GModuleLoadedSeconds.load(), Seconds);
+	}
+
+	void FStartupTiming::MarkRequestServed()
+	{
+		if (bRequestServed.load(std::memory_order_relaxed) || bRequestServed.exchange(true))
+		{
+			return;
+		}
+		double Seconds = GetSecondsSinceProcessStart();
+		GFirstRequestSeconds.store(Seconds);
+		UE_LOG(UHttpLog, Log, TEXT("UnrealHttpServer served first request %.3fs after module load (%.3fs after process start)"),
+			Seconds - GModuleLoadedSeconds.load(), Seconds);
+	}
+
+	FString FStartupTiming::ExportPrometheusText()
+	{
+		FString Out;
+		Out += TEXT("# HELP uhttp_startup_seconds Startup milestones in seconds since process start.\n");
+		Out += TEXT("# TYPE uhttp_startup_seconds gauge\n");
+		AppendGauge(Out, TEXT("module_load"), GModuleLoadedSeconds.load());
+		AppendGauge(Out, TEXT("listening"), GListeningSeconds.load());
+		AppendGauge(Out, TEXT("first_request"), GFirstRequestSeconds.load());
+		return Out;
+	}
+}
\ No newline at end of file
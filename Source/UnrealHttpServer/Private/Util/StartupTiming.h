@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Startup milestones of server, in seconds since process start
+	 * Logged once on first request served & exported as gauges to /metrics
+	 */
+	class FStartupTiming
+	{
+	public:
+		/**
+		 * Mark module loaded, should be called first on module startup
+		 */
+		static void MarkModuleLoaded();
+
+		/**
+		 * Mark listener started & routes bound
+		 */
+		static void MarkListening();
+
+		/**
+		 * Mark a request served, only the first one is recorded, thread safe & cheap after the first call
+		 */
+		static void MarkRequestServed();
+
+		/**
+		 * Export milestones reached in Prometheus text format
+		 */
+		static FString ExportPrometheusText();
+	};
+}
\ No newline at end of file
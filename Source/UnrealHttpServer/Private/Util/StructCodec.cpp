@@ -0,0 +1,416 @@
+#include "Util/StructCodec.h"
+#include "Log.h"
+#include "Misc/ScopeLock.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		/* Codecs by struct type */
+		TMap<const UScriptStruct*, TUniquePtr<FStructCodec>> GCodecs;
+		FCriticalSection GCodecsLock;
+	}
+
+	/* ================= Public Methods ==================== */
+
+	const FStructCodec& FStructCodec::Get(const UScriptStruct* Struct)
+	{
+		check(Struct != nullptr);
+		FScopeLock Lock(&GCodecsLock);
+		const TUniquePtr<FStructCodec>* Found = GCodecs.Find(Struct);
+		if (Found != nullptr)
+		{
+			return **Found;
+		}
+		// build before adding, nested codecs are added to the map (lock is recursive)
+		TUniquePtr<FStructCodec> Codec(new FStructCodec(Struct));
+		return *GCodecs.Add(Struct, MoveTemp(Codec));
+	}
+
+	bool FStructCodec::ReadQueryParams(const TMap<FString, FString>& QueryParams, void* Data, FString& OutMessage) const
+	{
+		for (const FField& Field : Fields)
+		{
+			const FString* Value = QueryParams.Find(Field.Name);
+			if (Value == nullptr || Field.Kind == EFieldKind::Struct)
+			{
+				continue;
+			}
+			if (!SetFromString(Field, Field.Property->ContainerPtrToValuePtr<void>(Data), *Value))
+			{
+				OutMessage = FString::Printf(TEXT("Invalid value of %s: %s"), *Field.Name, **Value);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool FStructCodec::ReadJson(TJsonReader<UTF8CHAR>& Reader, void* Data, FString& OutMessage) const
+	{
+		// object being read & its codec, codec is nullptr for skipped containers
+		struct FFrame
+		{
+			const FStructCodec* Codec;
+			void* Data;
+		};
+		TArray<FFrame, TInlineAllocator<8>> Stack;
+		EJsonNotation Notation;
+		while (Reader.ReadNext(Notation))
+		{
+			if (Notation == EJsonNotation::Error)
+			{
+				OutMessage = FString::Printf(TEXT("Failed to read request json body: %s"), *Reader.GetErrorMessage());
+				return false;
+			}
+			if (Notation == EJsonNotation::ObjectEnd || Notation == EJsonNotation::ArrayEnd)
+			{
+				Stack.Pop(false);
+				// stop at the end of root object, trailing bytes are ignored like the dom parser does
+				if (Stack.Num() == 0)
+				{
+					return true;
+				}
+				continue;
+			}
+			if (Stack.Num() == 0)
+			{
+				if (Notation != EJsonNotation::ObjectStart)
+				{
+					OutMessage = TEXT("Request json body is not an object!");
+					return false;
+				}
+				Stack.Add({ this, Data });
+				continue;
+			}
+
+			const FFrame Top = Stack.Last();
+			const FField* Field = Top.Codec != nullptr ? Top.Codec->FindField(Reader.GetIdentifier()) : nullptr;
+			void* FieldData = Field != nullptr ? Field->Property->ContainerPtrToValuePtr<void>(Top.Data) : nullptr;
+			bool bValid = true;
+			switch (Notation)
+			{
+			case EJsonNotation::ObjectStart:
+				if (Field != nullptr && Field->Kind == EFieldKind::Struct)
+				{
+					Stack.Add({ Field->Nested, FieldData });
+				}
+				else
+				{
+					bValid = Field == nullptr;
+					Stack.Add({ nullptr, nullptr });
+				}
+				break;
+			case EJsonNotation::ArrayStart:
+				bValid = Field == nullptr;
+				Stack.Add({ nullptr, nullptr });
+				break;
+			case EJsonNotation::Number:
+				bValid = Field == nullptr || SetFromNumber(*Field, FieldData, Reader.GetValueAsNumber(), OutMessage);
+				break;
+			case EJsonNotation::String:
+				bValid = Field == nullptr || SetFromString(*Field, FieldData, Reader.GetValueAsString());
+				break;
+			case EJsonNotation::Boolean:
+				bValid = Field == nullptr || SetFromBool(*Field, FieldData, Reader.GetValueAsBoolean());
+				break;
+			default:
+				break;
+			}
+			if (!bValid)
+			{
+				if (OutMessage.IsEmpty())
+				{
+					OutMessage = FString::Printf(TEXT("Invalid value type of %s"), *Field->Name);
+				}
+				return false;
+			}
+		}
+		OutMessage = TEXT("Request json body is not a complete object!");
+		return false;
+	}
+
+	bool FStructCodec::ReadJsonObject(const TSharedPtr<FJsonObject>& Object, void* Data, FString& OutMessage) const
+	{
+		if (!Object.IsValid())
+		{
+			return true;
+		}
+		for (const FField& Field : Fields)
+		{
+			const TSharedPtr<FJsonValue>* Value = Object->Values.Find(Field.Name);
+			if (Value == nullptr || !Value->IsValid())
+			{
+				continue;
+			}
+			void* FieldData = Field.Property->ContainerPtrToValuePtr<void>(Data);
+			bool bValid;
+			switch ((*Value)->Type)
+			{
+			case EJson::Number:
+				bValid = SetFromNumber(Field, FieldData, (*Value)->AsNumber(), OutMessage);
+				break;
+			case EJson::String:
+				bValid = SetFromString(Field, FieldData, (*Value)->AsString());
+				break;
+			case EJson::Boolean:
+				bValid = SetFromBool(Field, FieldData, (*Value)->AsBool());
+				break;
+			case EJson::Object:
+				bValid = Field.Kind == EFieldKind::Struct && Field.Nested->ReadJsonObject((*Value)->AsObject(), FieldData, OutMessage);
+				break;
+			case EJson::Null:
+				bValid = true;
+				break;
+			default:
+				bValid = false;
+				break;
+			}
+			if (!bValid)
+			{
+				if (OutMessage.IsEmpty())
+				{
+					OutMessage = FString::Printf(TEXT("Invalid value type of %s"), *Field.Name);
+				}
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void FStructCodec::Write(FBodyWriter& Writer, const void* Data) const
+	{
+		Writer.WriteObjectStart(Fields.Num());
+		for (const FField& Field : Fields)
+		{
+			const void* FieldData = Field.Property->ContainerPtrToValuePtr<void>(Data);
+			Writer.WriteIdentifier(Field.Name);
+			switch (Field.Kind)
+			{
+			case EFieldKind::Number:
+			{
+				FNumericProperty* NumericProperty = CastFieldChecked<FNumericProperty>(Field.Property);
+				Writer.WriteValue(NumericProperty->IsFloatingPoint()
+					? NumericProperty->GetFloatingPointPropertyValue(FieldData)
+					: (double)NumericProperty->GetSignedIntPropertyValue(FieldData));
+				break;
+			}
+			case EFieldKind::Bool:
+				Writer.WriteValue(CastFieldChecked<FBoolProperty>(Field.Property)->GetPropertyValue(FieldData));
+				break;
+			case EFieldKind::String:
+				Writer.WriteValue(*static_cast<const FString*>(FieldData));
+				break;
+			case EFieldKind::Name:
+				Writer.WriteValue(static_cast<const FName*>(FieldData)->ToString());
+				break;
+			case EFieldKind::Struct:
+				Field.Nested->Write(Writer, FieldData);
+				break;
+			}
+		}
+		Writer.WriteObjectEnd();
+	}
+
+	TSharedPtr<FJsonObject> FStructCodec::WriteJsonObject(const void* Data) const
+	{
+		TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject());
+		for (const FField& Field : Fields)
+		{
+			const void* FieldData = Field.Property->ContainerPtrToValuePtr<void>(Data);
+			switch (Field.Kind)
+			{
+			case EFieldKind::Number:
+			{
+				FNumericProperty* NumericProperty = CastFieldChecked<FNumericProperty>(Field.Property);
+				Object->SetNumberField(Field.Name, NumericProperty->IsFloatingPoint()
+					? NumericProperty->GetFloatingPointPropertyValue(FieldData)
+					: (double)NumericProperty->GetSignedIntPropertyValue(FieldData));
+				break;
+			}
+			case EFieldKind::Bool:
+				Object->SetBoolField(Field.Name, CastFieldChecked<FBoolProperty>(Field.Property)->GetPropertyValue(FieldData));
+				break;
+			case EFieldKind::String:
+				Object->SetStringField(Field.Name, *static_cast<const FString*>(FieldData));
+				break;
+			case EFieldKind::Name:
+				Object->SetStringField(Field.Name, static_cast<const FName*>(FieldData)->ToString());
+				break;
+			case EFieldKind::Struct:
+				Object->SetObjectField(Field.Name, Field.Nested->WriteJsonObject(FieldData));
+				break;
+			}
+		}
+		return Object;
+	}
+
+	int32 FStructCodec::GetSizeHint() const
+	{
+		int32 Size = 2;
+		for (const FField& Field : Fields)
+		{
+			Size += Field.Name.Len() + (Field.Kind == EFieldKind::Struct ? Field.Nested->GetSizeHint() : 24);
+		}
+		return Size;
+	}
+
+	/* ================= Private Methods ==================== */
+
+	FStructCodec::FStructCodec(const UScriptStruct* Struct)
+	{
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			FProperty* Property = *It;
+			FField Field;
+			Field.Name = Property->GetName();
+			Field.Name[0] = FChar::ToLower(Field.Name[0]);
+			Field.Property = Property;
+			Field.Nested = nullptr;
+			if (Property->ArrayDim != 1)
+			{
+				UE_LOG(UHttpLog, Warning, TEXT("Static array field %s of %s is not supported by struct codec"), *Field.Name, *Struct->GetName());
+				continue;
+			}
+			if (Property->IsA<FNumericProperty>())
+			{
+				Field.Kind = EFieldKind::Number;
+			}
+			else if (Property->IsA<FBoolProperty>())
+			{
+				Field.Kind = EFieldKind::Bool;
+			}
+			else if (Property->IsA<FStrProperty>())
+			{
+				Field.Kind = EFieldKind::String;
+			}
+			else if (Property->IsA<FNameProperty>())
+			{
+				Field.Kind = EFieldKind::Name;
+			}
+			else if (FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+			{
+				Field.Kind = EFieldKind::Struct;
+				Field.Nested = &Get(StructProperty->Struct);
+			}
+			else
+			{
+				UE_LOG(UHttpLog, Warning, TEXT("Field %s of %s is not supported by struct codec"), *Field.Name, *Struct->GetName());
+				continue;
+			}
+			Fields.Add(MoveTemp(Field));
+		}
+	}
+
+	const FStructCodec::FField* FStructCodec::FindField(const FString& Name) const
+	{
+		for (const FField& Field : Fields)
+		{
+			if (Field.Name == Name)
+			{
+				return &Field;
+			}
+		}
+		return nullptr;
+	}
+
+	bool FStructCodec::SetFromNumber(const FField& Field, void* Data, double Value, FString& OutMessage) const
+	{
+		switch (Field.Kind)
+		{
+		case EFieldKind::Number:
+		{
+			FNumericProperty* NumericProperty = CastFieldChecked<FNumericProperty>(Field.Property);
+			if (!FMath::IsFinite(Value))
+			{
+				OutMessage = FString::Printf(TEXT("Value of %s is not a finite number"), *Field.Name);
+				return false;
+			}
+			if (NumericProperty->IsFloatingPoint())
+			{
+				if (NumericProperty->ElementSize == sizeof(float) && FMath::Abs(Value) > TNumericLimits<float>::Max())
+				{
+					OutMessage = FString::Printf(TEXT("Value of %s is out of range: %g"), *Field.Name, Value);
+					return false;
+				}
+				NumericProperty->SetFloatingPointPropertyValue(Data, Value);
+				return true;
+			}
+			// casting out of range doubles to integers is undefined, bounds are powers of two which are exact in double
+			const bool bUnsigned = NumericProperty->IsA<FByteProperty>() || NumericProperty->IsA<FUInt16Property>()
+				|| NumericProperty->IsA<FUInt32Property>() || NumericProperty->IsA<FUInt64Property>();
+			const double HalfRange = (double)(1ull << (NumericProperty->ElementSize * 8 - 1));
+			const double Min = bUnsigned ? 0 : -HalfRange;
+			const double Max = bUnsigned ? HalfRange * 2 : HalfRange;
+			if (Value < Min || Value >= Max)
+			{
+				OutMessage = FString::Printf(TEXT("Value of %s is out of range: %.0f"), *Field.Name, Value);
+				return false;
+			}
+			if (bUnsigned)
+			{
+				NumericProperty->SetIntPropertyValue(Data, (uint64)Value);
+			}
+			else
+			{
+				NumericProperty->SetIntPropertyValue(Data, (int64)Value);
+			}
+			return true;
+		}
+		case EFieldKind::Bool:
+			CastFieldChecked<FBoolProperty>(Field.Property)->SetPropertyValue(Data, Value != 0);
+			return true;
+		case EFieldKind::String:
+			*static_cast<FString*>(Data) = FMath::IsNearlyEqual(Value, FMath::RoundToDouble(Value)) && FMath::Abs(Value) < 1e15
+				? FString::Printf(TEXT("%lld"), (int64)Value)
+				: FString::SanitizeFloat(Value);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool FStructCodec::SetFromString(const FField& Field, void* Data, const FString& Value) const
+	{
+		switch (Field.Kind)
+		{
+		case EFieldKind::Number:
+			if (!Value.IsNumeric())
+			{
+				return false;
+			}
+			CastFieldChecked<FNumericProperty>(Field.Property)->SetNumericPropertyValueFromString(Data, *Value);
+			return true;
+		case EFieldKind::Bool:
+			if (Value == TEXT("true") || Value == TEXT("1"))
+			{
+				CastFieldChecked<FBoolProperty>(Field.Property)->SetPropertyValue(Data, true);
+				return true;
+			}
+			if (Value == TEXT("false") || Value == TEXT("0"))
+			{
+				CastFieldChecked<FBoolProperty>(Field.Property)->SetPropertyValue(Data, false);
+				return true;
+			}
+			return false;
+		case EFieldKind::String:
+			*static_cast<FString*>(Data) = Value;
+			return true;
+		case EFieldKind::Name:
+			*static_cast<FName*>(Data) = FName(*Value);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool FStructCodec::SetFromBool(const FField& Field, void* Data, bool bValue) const
+	{
+		if (Field.Kind != EFieldKind::Bool)
+		{
+			return false;
+		}
+		CastFieldChecked<FBoolProperty>(Field.Property)->SetPropertyValue(Data, bValue);
+		return true;
+	}
+}
\ No newline at end of file
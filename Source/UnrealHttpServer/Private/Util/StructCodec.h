@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Class.h"
+#include "UObject/UnrealType.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Serialization/JsonReader.h"
+#include "Util/BodyWriter.h"
+
+namespace UnrealHttpServer
+{
+	/**
+	 * Reflection-driven codec of a USTRUCT, built once per struct type from its properties
+	 * Field names are property names with lower-cased first letter (same as FJsonObjectConverter), matched case insensitively
+	 * Supported properties: numbers, bool, FString, FName and nested USTRUCTs, others are ignored
+	 */
+	class FStructCodec
+	{
+	public:
+		/**
+		 * Get cached codec of struct type (thread safe, codecs live until shutdown)
+		 */
+		static const FStructCodec& Get(const UScriptStruct* Struct);
+
+		/**
+		 * Read top-level fields of struct from query params
+		 */
+		bool ReadQueryParams(const TMap<FString, FString>& QueryParams, void* Data, FString& OutMessage) const;
+
+		/**
+		 * Read struct from json stream, without building json dom (unknown fields are skipped)
+		 */
+		bool ReadJson(TJsonReader<UTF8CHAR>& Reader, void* Data, FString& OutMessage) const;
+
+		/**
+		 * Read struct from json dom
+		 */
+		bool ReadJsonObject(const TSharedPtr<FJsonObject>& Object, void* Data, FString& OutMessage) const;
+
+		/**
+		 * Write struct as object into body writer
+		 */
+		void Write(FBodyWriter& Writer, const void* Data) const;
+
+		/**
+		 * Write struct into json dom
+		 */
+		TSharedPtr<FJsonObject> WriteJsonObject(const void* Data) const;
+
+		/**
+		 * Estimated size of written struct in bytes
+		 */
+		int32 GetSizeHint() const;
+
+	private:
+		enum class EFieldKind : uint8
+		{
+			Number,
+			Bool,
+			String,
+			Name,
+			Struct,
+		};
+
+		/**
+		 * Codec field bound to struct property
+		 */
+		struct FField
+		{
+			FString Name;
+			FProperty* Property;
+			EFieldKind Kind;
+			/* Codec of nested struct field */
+			const FStructCodec* Nested;
+		};
+
+		TArray<FField> Fields;
+
+		explicit FStructCodec(const UScriptStruct* Struct);
+
+		const FField* FindField(const FString& Name) const;
+
+		bool SetFromNumber(const FField& Field, void* Data, double Value, FString& OutMessage) const;
+
+		bool SetFromString(const FField& Field, void* Data, const FString& Value) const;
+
+		bool SetFromBool(const FField& Field, void* Data, bool bValue) const;
+	};
+}
\ No newline at end of file
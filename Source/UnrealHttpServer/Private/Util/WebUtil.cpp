@@ -1,118 +1,314 @@
 #include "Util/WebUtil.h"
+#include "Util/MsgPack.h"
+#include "Util/MutationQueue.h"
+#include "Util/HttpCompression.h"
+#include "WebServer.h"
+#include "Service/WorldStateService.h"
 #include "Log.h"
 #include "Engine.h"
+#include "Async/Async.h"
 #include "Runtime/Json/Public/Serialization/JsonTypes.h"
 #include "Runtime/Json/Public/Dom/JsonValue.h"
-#include "Runtime/Json/Public/Serialization/JsonWriter.h"
 #include "Runtime/Json/Public/Serialization/JsonSerializer.h"
+#include "Serialization/MemoryReader.h"
 
 namespace UnrealHttpServer
 {
-	/** ========================== Public Methods ======================= */
+	namespace
+	{
+		/* Response body format of current thread */
+		thread_local EBodyFormat GResponseFormat = EBodyFormat::Json;
 
-	FHttpRouteHandle FWebUtil::BindRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FHttpResponser& HttpResponser)
+		/* Handles of routes bound on current thread, collected by FRouteBindingScope */
+		thread_local TArray<FHttpRouteHandle>* GBoundRouteHandles = nullptr;
+	}
+
+	FResponseFormatScope::FResponseFormatScope(EBodyFormat Format)
+		: PreviousFormat(GResponseFormat)
 	{
-		// VERB_NONE not supported!
-		if (HttpRouter == nullptr || Verb == EHttpServerRequestVerbs::VERB_NONE)
-		{
-			return nullptr;
-		}
+		GResponseFormat = Format;
+	}
 
-		FString VerbString = GetHttpVerbStringFromEnum(Verb);
-		UE_LOG(UHttpLog, Log, TEXT("Binding router: %s\t%s"), *VerbString, *Path);
+	FResponseFormatScope::~FResponseFormatScope()
+	{
+		GResponseFormat = PreviousFormat;
+	}
 
-		// check if HTTP path is valid
-		FHttpPath HttpPath(Path);
-		if (!HttpPath.IsValidPath())
-		{	
-			UE_LOG(UHttpLog, Warning, TEXT("Invalid http path: %s"), *Path);
-#if WITH_EDITOR
-			if (GEngine != nullptr)
-			{
-				GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red,
-					FString::Printf(TEXT("Bind HTTP router failed! invalid path: %s"), *Path));
-			}
-#endif
-			return nullptr;
-		}
+	FRouteBindingScope::FRouteBindingScope(TArray<FHttpRouteHandle>& Handles)
+		: PreviousHandles(GBoundRouteHandles)
+	{
+		GBoundRouteHandles = &Handles;
+	}
 
-		// bind router
-		auto RouteHandle = HttpRouter->BindRoute(HttpPath, Verb, FWebUtil::CreateHandler(HttpResponser));
-		if (RouteHandle == nullptr)
-		{
-			UE_LOG(UHttpLog, Warning, TEXT("Bind failed: %s\t%s"), *VerbString, *Path);
-			return nullptr;
-		}
-#if WITH_EDITOR
-		if (GEngine != nullptr)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Cyan,
-				FString::Printf(TEXT("Bind HTTP router: %s\t%s"), *VerbString, *Path));
-		}
-#endif
-		return RouteHandle;
+	FRouteBindingScope::~FRouteBindingScope()
+	{
+		GBoundRouteHandles = PreviousHandles;
+	}
+
+	/** ========================== Public Methods ======================= */
+
+	FHttpRouteHandle FWebUtil::BindRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FHttpResponser& HttpResponser)
+	{
+		TSharedRef<FRouteMetrics, ESPMode::ThreadSafe> RouteMetrics = FRouteMetrics::Register(Path, GetHttpVerbStringFromEnum(Verb));
+		return BindRouteHandler(HttpRouter, Path, Verb, FWebUtil::CreateHandler(HttpResponser, RouteMetrics));
+	}
+
+	FHttpRouteHandle FWebUtil::BindAsyncRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FAsyncHttpResponser& AsyncHttpResponser)
+	{
+		TSharedRef<FRouteMetrics, ESPMode::ThreadSafe> RouteMetrics = FRouteMetrics::Register(Path, GetHttpVerbStringFromEnum(Verb));
+		return BindRouteHandler(HttpRouter, Path, Verb, FWebUtil::CreateAsyncHandler(AsyncHttpResponser, RouteMetrics));
 	}
 
-	FHttpRequestHandler FWebUtil::CreateHandler(const FHttpResponser& HttpResponser)
+	FHttpRequestHandler FWebUtil::CreateHandler(const FHttpResponser& HttpResponser, const TSharedPtr<FRouteMetrics, ESPMode::ThreadSafe>& RouteMetrics)
 	{
-		return [HttpResponser](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+		return [HttpResponser, RouteMetrics](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
 		{
+			FResponseFormatScope FormatScope(GetAcceptedFormat(Request));
+			TSharedPtr<FRequestMetrics, ESPMode::ThreadSafe> Metrics;
+			if (RouteMetrics.IsValid())
+			{
+				Metrics = MakeShared<FRequestMetrics, ESPMode::ThreadSafe>(RouteMetrics.ToSharedRef(), Request.Body.Num());
+			}
+			FRequestMetricsScope MetricsScope(Metrics.Get());
 			auto Response = HttpResponser(Request);
 			if (Response == nullptr)
 			{
+				if (Metrics.IsValid())
+				{
+					Metrics->Complete(nullptr);
+				}
 				return false;
 			}
-			OnComplete(MoveTemp(Response));
+			CompleteResponse(OnComplete, MoveTemp(Response), FHttpCompression::NegotiateEncoding(Request), Metrics);
+			return true;
+		};
+	}
+
+	FHttpRequestHandler FWebUtil::CreateAsyncHandler(const FAsyncHttpResponser& AsyncHttpResponser, const TSharedPtr<FRouteMetrics, ESPMode::ThreadSafe>& RouteMetrics)
+	{
+		return [AsyncHttpResponser, RouteMetrics](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+		{
+			FResponseFormatScope FormatScope(GetAcceptedFormat(Request));
+			TSharedPtr<FRequestMetrics, ESPMode::ThreadSafe> Metrics;
+			if (RouteMetrics.IsValid())
+			{
+				Metrics = MakeShared<FRequestMetrics, ESPMode::ThreadSafe>(RouteMetrics.ToSharedRef(), Request.Body.Num());
+			}
+			FRequestMetricsScope MetricsScope(Metrics.Get());
+			// the request is owned by the connection, copy it so that workers can read it after this call returns
+			FHttpServerRequestRef RequestRef = MakeShared<FHttpServerRequest, ESPMode::ThreadSafe>(Request);
+			TSharedRef<FThreadSafeBool, ESPMode::ThreadSafe> bResponded = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+			FName Encoding = FHttpCompression::NegotiateEncoding(Request);
+			FHttpResponseCallback Respond = [OnComplete, bResponded, Metrics, Encoding](TUniquePtr<FHttpServerResponse>&& Response)
+			{
+				if (bResponded->AtomicSet(true))
+				{
+					UE_LOG(UHttpLog, Warning, TEXT("async responser responded more than once!"));
+					return;
+				}
+				if (Response == nullptr)
+				{
+					Response = ErrorResponse(TEXT("Async responser returned no response!"));
+					if (Metrics.IsValid())
+					{
+						Metrics->MarkError();
+					}
+				}
+				CompleteResponse(OnComplete, MoveTemp(Response), Encoding, Metrics);
+			};
+			AsyncHttpResponser(RequestRef, Respond);
 			return true;
 		};
 	}
 
+	void FWebUtil::RunOnGameThread(TUniqueFunction<void()> Task)
+	{
+		AsyncTask(ENamedThreads::GameThread, WrapTaskContext(MoveTemp(Task)));
+	}
+
+	void FWebUtil::RunOnWorkerThread(TUniqueFunction<void()> Task)
+	{
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, WrapTaskContext(MoveTemp(Task)));
+	}
+
+	bool FWebUtil::EnqueueMutation(TUniqueFunction<void()> Task)
+	{
+		return FMutationQueue::Enqueue(WrapTaskContext(MoveTemp(Task)));
+	}
+
+	bool FWebUtil::EnqueueCoalescedMutation(const FString& Key, TUniqueFunction<void()> Task, TUniqueFunction<void()> OnSuperseded)
+	{
+		return FMutationQueue::EnqueueCoalesced(Key, WrapTaskContext(MoveTemp(Task)), WrapTaskContext(MoveTemp(OnSuperseded)));
+	}
+
+	EBodyFormat FWebUtil::GetResponseFormat()
+	{
+		return GResponseFormat;
+	}
+
+	uint64 FWebUtil::GetPublishedFrame()
+	{
+		FWorldStateReader Reader;
+		return Reader.Get() != nullptr ? Reader.Get()->Frame : 0;
+	}
+
+	EBodyFormat FWebUtil::GetAcceptedFormat(const FHttpServerRequest& Request)
+	{
+		const TArray<FString>* AcceptValues = Request.Headers.Find(TEXT("accept"));
+		if (AcceptValues != nullptr)
+		{
+			for (const FString& Value : *AcceptValues)
+			{
+				if (IsMsgPackMediaType(Value))
+				{
+					return EBodyFormat::MsgPack;
+				}
+			}
+		}
+		return EBodyFormat::Json;
+	}
+
 	TSharedPtr<FJsonObject> FWebUtil::GetRequestJsonBody(const FHttpServerRequest& Request)
 	{
+		FRequestPhaseTimer ParseTimer(FRequestPhaseTimer::EPhase::Parse);
+		TArray<uint8> DecodedStorage;
+		const TArray<uint8>* Body = FHttpCompression::GetDecodedBody(Request, DecodedStorage);
+		if (Body == nullptr)
+		{
+			return nullptr;
+		}
+		if (IsMsgPackRequestContent(Request))
+		{
+			TSharedPtr<FJsonObject> RequestBody;
+			FMsgPackReader MsgPackReader(Body->GetData(), Body->Num());
+			if (!MsgPackReader.ReadJsonObject(RequestBody))
+			{
+				UE_LOG(UHttpLog, Verbose, TEXT("failed to decode msgpack request body!"));
+				return nullptr;
+			}
+			return RequestBody;
+		}
+
 		// check if content type is application/json
 		bool IsUTF8JsonContent = IsUTF8JsonRequestContent(Request);
 		if (!IsUTF8JsonContent)
 		{
-			UE_LOG(UHttpLog, Warning, TEXT("caught request not in utf-8 application/json body content!"));
+			UE_LOG(UHttpLog, Verbose, TEXT("caught request not in utf-8 application/json body content!"));
 			return nullptr;
 		}
 		
-		// body to utf8 string
-		TArray<uint8> RequestBodyBytes = Request.Body;
-		FString RequestBodyString = FString(UTF8_TO_TCHAR(RequestBodyBytes.GetData()));
-#if WITH_EDITOR
-		if (GEngine != nullptr)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Green, RequestBodyString);
-		}
-#endif
+		// body to utf8 string, converted in place with bounded length as the body is not NUL terminated
+		FUTF8ToTCHAR RequestBodyConverter(reinterpret_cast<const ANSICHAR*>(Body->GetData()), Body->Num());
+		FString RequestBodyString = FString(RequestBodyConverter.Length(), RequestBodyConverter.Get());
 
 		// string to json
 		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(RequestBodyString);
 		TSharedPtr<FJsonObject> RequestBody;
 		if (!FJsonSerializer::Deserialize(JsonReader, RequestBody))
 		{
-			UE_LOG(UHttpLog, Warning, TEXT("failed to parse request string to json: %s"), *RequestBodyString);
+			UE_LOG(UHttpLog, Verbose, TEXT("failed to parse request string to json: %s"), *RequestBodyString);
 			return nullptr;
 		}
 		return RequestBody;
 	}
 
-	template <typename UStructType>
-	static UStructType* FWebUtil::GetRequestUStructBody(const FHttpServerRequest& Request)
+	bool FWebUtil::ReadRequestNumberFields(const FHttpServerRequest& Request, TArrayView<const FJsonNumberField> Fields)
 	{
-		TSharedPtr<FJsonObject> JsonBody = FWebUtil::GetRequestJsonBody(Request);
-		if (JsonBody == nullptr)
+		FRequestPhaseTimer ParseTimer(FRequestPhaseTimer::EPhase::Parse);
+		TArray<uint8> DecodedStorage;
+		const TArray<uint8>* Body = FHttpCompression::GetDecodedBody(Request, DecodedStorage);
+		if (Body == nullptr)
 		{
-			return nullptr;
+			return false;
 		}
-		UStructType* UStructBody;
-		if (!FJsonObjectConverter::JsonObjectToUStruct(JsonBody, UStructBody))
+		if (IsMsgPackRequestContent(Request))
 		{
-			UE_LOG(UHttpLog, Warning, TEXT("failed to parse json body to ustruct!"))
-			return nullptr;
+			FMsgPackReader MsgPackReader(Body->GetData(), Body->Num());
+			return MsgPackReader.ReadNumberFields(Fields);
+		}
+
+		if (!IsUTF8JsonRequestContent(Request))
+		{
+			UE_LOG(UHttpLog, Verbose, TEXT("caught request not in utf-8 application/json body content!"));
+			return false;
+		}
+
+		// stream utf-8 bytes directly, the memory reader stops at body size
+		FMemoryReader BodyReader(*Body);
+		TSharedRef<TJsonReader<UTF8CHAR>> JsonReader = TJsonReaderFactory<UTF8CHAR>::Create(&BodyReader);
+		EJsonNotation Notation;
+		int32 Depth = 0;
+		while (JsonReader->ReadNext(Notation))
+		{
+			switch (Notation)
+			{
+			case EJsonNotation::ObjectStart:
+			case EJsonNotation::ArrayStart:
+				++Depth;
+				break;
+			case EJsonNotation::ObjectEnd:
+			case EJsonNotation::ArrayEnd:
+				// stop at the end of root object, trailing bytes are ignored like the dom parser does
+				if (--Depth == 0)
+				{
+					return true;
+				}
+				break;
+			case EJsonNotation::Number:
+				if (Depth == 1)
+				{
+					const FString& Identifier = JsonReader->GetIdentifier();
+					for (const FJsonNumberField& Field : Fields)
+					{
+						if (Identifier == Field.Name)
+						{
+							*Field.Value = JsonReader->GetValueAsNumber();
+							break;
+						}
+					}
+				}
+				break;
+			case EJsonNotation::Error:
+				UE_LOG(UHttpLog, Verbose, TEXT("failed to read request json body: %s"), *JsonReader->GetErrorMessage());
+				return false;
+			default:
+				break;
+			}
+		}
+		UE_LOG(UHttpLog, Verbose, TEXT("request json body is not a complete object!"));
+		return false;
+	}
+
+	bool FWebUtil::ReadRequestStructBody(const FHttpServerRequest& Request, const FStructCodec& Codec, void* Data, FString& OutMessage)
+	{
+		if (IsMsgPackRequestContent(Request))
+		{
+			TSharedPtr<FJsonObject> RequestBody = GetRequestJsonBody(Request);
+			if (RequestBody == nullptr)
+			{
+				OutMessage = TEXT("Failed to decode msgpack request body!");
+				return false;
+			}
+			return Codec.ReadJsonObject(RequestBody, Data, OutMessage);
+		}
+
+		FRequestPhaseTimer ParseTimer(FRequestPhaseTimer::EPhase::Parse);
+		if (!IsUTF8JsonRequestContent(Request))
+		{
+			OutMessage = TEXT("Failed to parse request body to json!");
+			return false;
 		}
-		return UStructBody;
+		TArray<uint8> DecodedStorage;
+		const TArray<uint8>* Body = FHttpCompression::GetDecodedBody(Request, DecodedStorage);
+		if (Body == nullptr)
+		{
+			OutMessage = TEXT("Failed to decode request body content encoding!");
+			return false;
+		}
+		// stream utf-8 bytes directly into struct fields, the memory reader stops at body size
+		FMemoryReader BodyReader(*Body);
+		TSharedRef<TJsonReader<UTF8CHAR>> JsonReader = TJsonReaderFactory<UTF8CHAR>::Create(&BodyReader);
+		return Codec.ReadJson(*JsonReader, Data, OutMessage);
 	}
 
 	TUniquePtr<FHttpServerResponse> FWebUtil::SuccessResponse(TSharedPtr<FJsonObject> Data, FString Message)
@@ -130,6 +326,16 @@ namespace UnrealHttpServer
 		return SuccessResponse(MakeShareable(new FJsonObject()), Message);
 	}
 
+	TUniquePtr<FHttpServerResponse> FWebUtil::SuccessResponse(const FBodyDataWriter& DataWriter, int32 DataSizeHint)
+	{
+		return BodyResponse(DataWriter, DataSizeHint, TEXT(""), true, SUCCESS_CODE);
+	}
+
+	TUniquePtr<FHttpServerResponse> FWebUtil::SuccessResponse(const FBodyDataWriter& DataWriter, int32 DataSizeHint, FString Message)
+	{
+		return BodyResponse(DataWriter, DataSizeHint, Message, true, SUCCESS_CODE);
+	}
+
 	TUniquePtr<FHttpServerResponse> FWebUtil::ErrorResponse(TSharedPtr<FJsonObject> Data, FString Message, int32 Code)
 	{
 		if (Code == SUCCESS_CODE)
@@ -154,8 +360,81 @@ namespace UnrealHttpServer
 		return ErrorResponse(MakeShareable(new FJsonObject()), Message, DEFAULT_ERROR_CODE);
 	}
 
+	TUniquePtr<FHttpServerResponse> FWebUtil::TooManyRequestsResponse()
+	{
+		int32 RetryAfterSeconds = FMutationQueue::GetRetryAfterSeconds();
+		TUniquePtr<FHttpServerResponse> Response = ErrorResponse(FString::Printf(TEXT("Server is busy, retry after %d seconds!"), RetryAfterSeconds));
+		Response->Code = EHttpServerResponseCodes::TooManyRequests;
+		Response->Headers.Add(TEXT("Retry-After"), { FString::FromInt(RetryAfterSeconds) });
+		return Response;
+	}
+
+	TUniquePtr<FHttpServerResponse> FWebUtil::CoalescedResponse()
+	{
+		TSharedPtr<FJsonObject> Data = MakeShareable(new FJsonObject());
+		Data->SetBoolField(TEXT("coalesced"), true);
+		return SuccessResponse(Data, TEXT("Superseded by a later write in the same frame!"));
+	}
+
 	/** ========================== Private Methods ======================= */
 
+	TUniqueFunction<void()> FWebUtil::WrapTaskContext(TUniqueFunction<void()> Task)
+	{
+		FRequestMetrics* CurrentMetrics = FRequestMetrics::GetCurrent();
+		TSharedPtr<FRequestMetrics, ESPMode::ThreadSafe> Metrics = CurrentMetrics != nullptr ? CurrentMetrics->AsShared() : nullptr;
+		return [Format = GResponseFormat, Metrics, Task = MoveTemp(Task)]() mutable
+		{
+			FResponseFormatScope FormatScope(Format);
+			FRequestMetricsScope MetricsScope(Metrics.Get());
+			Task();
+		};
+	}
+
+	void FWebUtil::CompleteResponse(const FHttpResultCallback& OnComplete, TUniquePtr<FHttpServerResponse>&& Response, FName Encoding, const TSharedPtr<FRequestMetrics, ESPMode::ThreadSafe>& Metrics)
+	{
+		if (FHttpCompression::ShouldCompress(*Response, Encoding))
+		{
+			auto CompressAndComplete = [OnComplete, Encoding, Metrics, Response = MoveTemp(Response)]() mutable
+			{
+				FHttpCompression::CompressResponse(*Response, Encoding);
+				// bytes out are of the body sent, after compression
+				if (Metrics.IsValid())
+				{
+					Metrics->Complete(Response.Get());
+				}
+				RunOnGameThread([OnComplete, Response = MoveTemp(Response)]() mutable
+				{
+					OnComplete(MoveTemp(Response));
+				});
+			};
+			// keep compression off game thread
+			if (IsInGameThread())
+			{
+				RunOnWorkerThread(MoveTemp(CompressAndComplete));
+			}
+			else
+			{
+				CompressAndComplete();
+			}
+			return;
+		}
+
+		if (Metrics.IsValid())
+		{
+			Metrics->Complete(Response.Get());
+		}
+		// the connection is not thread safe, complete it on game thread
+		if (IsInGameThread())
+		{
+			OnComplete(MoveTemp(Response));
+			return;
+		}
+		RunOnGameThread([OnComplete, Response = MoveTemp(Response)]() mutable
+		{
+			OnComplete(MoveTemp(Response));
+		});
+	}
+
 	FString FWebUtil::GetHttpVerbStringFromEnum(const EHttpServerRequestVerbs& Verb)
 	{
 		switch (Verb)
@@ -173,57 +452,144 @@ namespace UnrealHttpServer
 		case EHttpServerRequestVerbs::VERB_OPTIONS:
 			return TEXT("OPTIONS");
 		default:
-			return TEXT("UNKNOWN_VERB");
+			break;
+		}
+		// combined verbs of path routers
+		FString VerbString;
+		for (EHttpServerRequestVerbs Flag : { EHttpServerRequestVerbs::VERB_GET, EHttpServerRequestVerbs::VERB_POST, EHttpServerRequestVerbs::VERB_PUT,
+			EHttpServerRequestVerbs::VERB_DELETE, EHttpServerRequestVerbs::VERB_PATCH, EHttpServerRequestVerbs::VERB_OPTIONS })
+		{
+			if (EnumHasAnyFlags(Verb, Flag))
+			{
+				VerbString += VerbString.IsEmpty() ? GetHttpVerbStringFromEnum(Flag) : TEXT("|") + GetHttpVerbStringFromEnum(Flag);
+			}
+		}
+		return VerbString.IsEmpty() ? TEXT("UNKNOWN_VERB") : VerbString;
+	}
+
+	FHttpRouteHandle FWebUtil::BindRouteHandler(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FHttpRequestHandler& Handler)
+	{
+		// VERB_NONE not supported!
+		if (HttpRouter == nullptr || Verb == EHttpServerRequestVerbs::VERB_NONE)
+		{
+			return nullptr;
 		}
+
+		FString VerbString = GetHttpVerbStringFromEnum(Verb);
+		UE_LOG(UHttpLog, Log, TEXT("Binding router: %s\t%s"), *VerbString, *Path);
+
+		// check if HTTP path is valid
+		FHttpPath HttpPath(Path);
+		if (!HttpPath.IsValidPath())
+		{	
+			UE_LOG(UHttpLog, Warning, TEXT("Invalid http path: %s"), *Path);
+#if WITH_EDITOR
+			if (GEngine != nullptr && !FWebServer::IsHeadless())
+			{
+				GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red,
+					FString::Printf(TEXT("Bind HTTP router failed! invalid path: %s"), *Path));
+			}
+#endif
+			return nullptr;
+		}
+
+		// bind router
+		auto RouteHandle = HttpRouter->BindRoute(HttpPath, Verb, Handler);
+		if (RouteHandle == nullptr)
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Bind failed: %s\t%s"), *VerbString, *Path);
+			return nullptr;
+		}
+		if (GBoundRouteHandles != nullptr)
+		{
+			GBoundRouteHandles->Add(RouteHandle);
+			return RouteHandle;
+		}
+#if WITH_EDITOR
+		if (GEngine != nullptr && !FWebServer::IsHeadless())
+		{
+			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Cyan,
+				FString::Printf(TEXT("Bind HTTP router: %s\t%s"), *VerbString, *Path));
+		}
+#endif
+		return RouteHandle;
 	}
 
 	TUniquePtr<FHttpServerResponse> FWebUtil::JsonResponse(TSharedPtr<FJsonObject> Data, FString Message, bool Success, int32 Code)
 	{
-		TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
-		JsonObject->SetObjectField(TEXT("data"), Data);
-		JsonObject->SetStringField(TEXT("message"), Message);
-		JsonObject->SetBoolField(TEXT("success"), Success);
-		JsonObject->SetNumberField(TEXT("code"), (double)Code);
-		FString JsonString;
-		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
-		FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
-		return FHttpServerResponse::Create(JsonString, TEXT("application/json"));
+		// pre-sized by a rough estimation of data size
+		int32 DataFieldCount = Data.IsValid() ? Data->Values.Num() : 0;
+		return BodyResponse([&Data](FBodyWriter& Writer)
+		{
+			Writer.WriteJsonObject(Data);
+		}, DataFieldCount * 32, Message, Success, Code);
+	}
+
+	TUniquePtr<FHttpServerResponse> FWebUtil::BodyResponse(const FBodyDataWriter& DataWriter, int32 DataSizeHint, const FString& Message, bool Success, int32 Code)
+	{
+		FRequestPhaseTimer SerializeTimer(FRequestPhaseTimer::EPhase::Serialize);
+		FRequestMetrics* Metrics = FRequestMetrics::GetCurrent();
+		if (!Success && Metrics != nullptr)
+		{
+			Metrics->MarkError();
+		}
+
+		// write envelope & data straight into body
+		TUniquePtr<FBodyWriter> Writer = FBodyWriter::Create(GResponseFormat, 64 + Message.Len() + DataSizeHint);
+		Writer->WriteObjectStart(4);
+		Writer->WriteIdentifier(TEXT("data"));
+		DataWriter(*Writer);
+		Writer->WriteIdentifier(TEXT("message"));
+		Writer->WriteValue(Message);
+		Writer->WriteIdentifier(TEXT("success"));
+		Writer->WriteValue(Success);
+		Writer->WriteIdentifier(TEXT("code"));
+		Writer->WriteValue((double)Code);
+		Writer->WriteObjectEnd();
+		return FHttpServerResponse::Create(Writer->ConsumeBytes(), Writer->GetContentType());
 	}
 
 	bool FWebUtil::IsUTF8JsonRequestContent(const FHttpServerRequest& Request)
 	{
+		const TArray<FString>* ContentTypeValues = Request.Headers.Find(TEXT("content-type"));
+		if (ContentTypeValues == nullptr)
+		{
+			return false;
+		}
 		bool bIsUTF8JsonContent = false;
-		for (auto& HeaderElem : Request.Headers)
+		for (const FString& Value : *ContentTypeValues)
 		{
-			auto LowerKey = HeaderElem.Key.ToLower();
-			if (LowerKey == TEXT("content-type"))
+			// not strict check
+			if (Value.Contains(TEXT("charset=")) && !Value.Contains(TEXT("charset=utf-8")))
 			{
-				for (auto& Value : HeaderElem.Value)
-				{
-					auto LowerValue = Value.ToLower();
-					// not strict check
-					if (LowerValue.Contains(TEXT("charset=")) && !LowerValue.Contains(TEXT("charset=utf-8")))
-					{
-						return false;
-					}
-					if (LowerValue.Contains(TEXT("application/json")) || LowerValue.Contains(TEXT("text/json")))
-					{
-						bIsUTF8JsonContent = true;
-					}
-				}
+				return false;
 			}
-#if WITH_EDITOR
-			auto Value = FString::Join(HeaderElem.Value, TEXT(","));
-			FString Message;
-			Message.Append(HeaderElem.Key);
-			Message.AppendChars(TEXT(": "), 2);
-			Message.Append(Value);
-			if (GEngine != nullptr)
-			{
-				GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Yellow, Message);
+			if (Value.Contains(TEXT("application/json")) || Value.Contains(TEXT("text/json")))
+			{
+				bIsUTF8JsonContent = true;
 			}
-#endif
 		}
 		return bIsUTF8JsonContent;
 	}
+
+	bool FWebUtil::IsMsgPackRequestContent(const FHttpServerRequest& Request)
+	{
+		const TArray<FString>* ContentTypeValues = Request.Headers.Find(TEXT("content-type"));
+		if (ContentTypeValues != nullptr)
+		{
+			for (const FString& Value : *ContentTypeValues)
+			{
+				if (IsMsgPackMediaType(Value))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	bool FWebUtil::IsMsgPackMediaType(const FString& Value)
+	{
+		return Value.Contains(TEXT("application/msgpack")) || Value.Contains(TEXT("application/x-msgpack"));
+	}
 }
\ No newline at end of file
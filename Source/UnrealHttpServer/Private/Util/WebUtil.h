@@ -8,6 +8,11 @@
 #include "Runtime/Online/HTTPServer/Public/HttpServerResponse.h"
 #include "Runtime/Online/HTTPServer/Public/HttpRouteHandle.h"
 #include "Runtime/Online/HTTPServer/Public/IHttpRouter.h"
+#include "Util/BodyWriter.h"
+#include "Util/ResponseCache.h"
+#include "Util/RouteMetrics.h"
+#include "Util/StructCodec.h"
+#include "Log.h"
 
 
 namespace UnrealHttpServer
@@ -17,6 +22,87 @@ namespace UnrealHttpServer
 	 */
 	typedef TFunction<TUniquePtr<FHttpServerResponse>(const FHttpServerRequest& Request)> FHttpResponser;
 
+	/**
+	 * HTTP request shared between threads (copied from the connection-owned request)
+	 */
+	typedef TSharedRef<const FHttpServerRequest, ESPMode::ThreadSafe> FHttpServerRequestRef;
+
+	/**
+	 * HTTP response callback, delivers the response of an async responser (can be invoked on any thread, only the first call takes effect)
+	 */
+	typedef TFunction<void(TUniquePtr<FHttpServerResponse>&& Response)> FHttpResponseCallback;
+
+	/**
+	 * Async HTTP responser function, the response should be delivered through Respond later
+	 */
+	typedef TFunction<void(const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)> FAsyncHttpResponser;
+
+	/**
+	 * Response data writer function, writes one value as response data directly into body (for large data)
+	 */
+	typedef TFunction<void(FBodyWriter& Writer)> FBodyDataWriter;
+
+	/**
+	 * Json operation function, executes with json params and outputs json data & message, returns if succeeded
+	 */
+	typedef TFunction<bool(const TSharedPtr<FJsonObject>& Params, TSharedPtr<FJsonObject>& OutData, FString& OutMessage)> FJsonOperation;
+
+	/**
+	 * Typed responser function, handles USTRUCT request and outputs USTRUCT response & message on game thread, returns if succeeded
+	 */
+	template <typename TRequest, typename TResponse>
+	using TTypedResponser = TFunction<bool(const TRequest& Request, TResponse& OutResponse, FString& OutMessage)>;
+
+	/**
+	 * Typed responser reading published state off game thread, outputs frame of the state it read
+	 */
+	template <typename TRequest, typename TResponse>
+	using TFramedResponser = TFunction<bool(const TRequest& Request, TResponse& OutResponse, FString& OutMessage, uint64& OutFrame)>;
+
+	/**
+	 * Coalescing key function of typed request, requests of same key are merged with last writer wins (e.g. target of a setter)
+	 */
+	template <typename TRequest>
+	using TCoalesceKey = TFunction<FString(const TRequest& Request)>;
+
+	/**
+	 * Json number field binding, used to read a number field of request body into handler variable directly
+	 */
+	struct FJsonNumberField
+	{
+		/* Field name (case insensitive) */
+		const TCHAR* Name;
+		/* Output value, untouched if field is missing */
+		double* Value;
+	};
+
+	/**
+	 * Set response body format of current thread in scope, responses created in scope are encoded in this format
+	 * Handler wrappers open the scope from Accept header, RunOnGameThread & RunOnWorkerThread carry it to tasks
+	 */
+	class FResponseFormatScope
+	{
+	public:
+		explicit FResponseFormatScope(EBodyFormat Format);
+		~FResponseFormatScope();
+
+	private:
+		EBodyFormat PreviousFormat;
+	};
+
+	/**
+	 * Collect handles of routes bound on current thread in scope (without on-screen messages), so that they can be unbound together
+	 */
+	class FRouteBindingScope
+	{
+	public:
+		explicit FRouteBindingScope(TArray<FHttpRouteHandle>& Handles);
+		~FRouteBindingScope();
+
+	private:
+		TArray<FHttpRouteHandle>* PreviousHandles;
+	};
+
 	class FWebUtil
 	{
 	public:	
@@ -25,23 +111,198 @@ namespace UnrealHttpServer
 		 */
 		static FHttpRouteHandle BindRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FHttpResponser& HttpResponser);
 
+		/**
+		 * Bind a route with async handler
+		 */
+		static FHttpRouteHandle BindAsyncRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FAsyncHttpResponser& AsyncHttpResponser);
+
+		/**
+		 * Bind a route with typed responser, request & response USTRUCTs are decoded & encoded by cached reflection codecs
+		 * Request fields are read from query params, then from body for verbs with body (decoded on worker thread)
+		 * Handlers of verbs with body are mutations, applied through the mutation queue
+		 */
+		template <typename TRequest, typename TResponse>
+		static FHttpRouteHandle BindTypedRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const TTypedResponser<TRequest, TResponse>& Responser)
+		{
+			const FStructCodec& RequestCodec = FStructCodec::Get(TRequest::StaticStruct());
+			const FStructCodec& ResponseCodec = FStructCodec::Get(TResponse::StaticStruct());
+			if (Verb == EHttpServerRequestVerbs::VERB_GET || Verb == EHttpServerRequestVerbs::VERB_DELETE)
+			{
+				return BindRoute(HttpRouter, Path, Verb, [&RequestCodec, &ResponseCodec, Responser](const FHttpServerRequest& Request)
+				{
+					TRequest RequestBody;
+					FString Message;
+					if (!RequestCodec.ReadQueryParams(Request.QueryParams, &RequestBody, Message))
+					{
+						return ErrorResponse(Message);
+					}
+					return TypedResponse(ResponseCodec, Responser, RequestBody);
+				});
+			}
+			return BindMutationRoute<TRequest, TResponse>(HttpRouter, Path, Verb, RequestCodec, ResponseCodec, Responser, nullptr);
+		}
+
+		/**
+		 * Bind a typed route served on worker thread with framed responser (no UObject access), request fields are read from query params
+		 * Frame of the state read is returned in X-UHttp-Frame header, successful responses are cached (with ETag) until next published frame
+		 */
+		template <typename TRequest, typename TResponse>
+		static FHttpRouteHandle BindWorkerRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const TFramedResponser<TRequest, TResponse>& Responser)
+		{
+			const FStructCodec& RequestCodec = FStructCodec::Get(TRequest::StaticStruct());
+			const FStructCodec& ResponseCodec = FStructCodec::Get(TResponse::StaticStruct());
+			TSharedRef<FResponseCache, ESPMode::ThreadSafe> Cache = MakeShared<FResponseCache, ESPMode::ThreadSafe>();
+			return BindAsyncRoute(HttpRouter, Path, Verb, [&RequestCodec, &ResponseCodec, Responser, Cache](const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+			{
+				RunOnWorkerThread([&RequestCodec, &ResponseCodec, Responser, Cache, Request, Respond]()
+				{
+					TUniquePtr<FHttpServerResponse> CachedResponse = Cache->Find(*Request, GetPublishedFrame());
+					if (CachedResponse != nullptr)
+					{
+						Respond(MoveTemp(CachedResponse));
+						return;
+					}
+					TRequest RequestBody;
+					FString Message;
+					if (!RequestCodec.ReadQueryParams(Request->QueryParams, &RequestBody, Message))
+					{
+						Respond(ErrorResponse(Message));
+						return;
+					}
+					uint64 Frame = 0;
+					bool bSucceeded = false;
+					TUniquePtr<FHttpServerResponse> Response = TypedResponse<TRequest, TResponse>(ResponseCodec, [&Responser, &Frame, &bSucceeded](const TRequest& InRequest, TResponse& OutResponse, FString& OutMessage)
+					{
+						bSucceeded = Responser(InRequest, OutResponse, OutMessage, Frame);
+						return bSucceeded;
+					}, RequestBody);
+					Response->Headers.Add(TEXT("x-uhttp-frame"), { FString::Printf(TEXT("%llu"), Frame) });
+					Respond(Cache->Add(*Request, Frame, MoveTemp(Response), bSucceeded));
+				});
+			});
+		}
+
+		/**
+		 * Bind a typed mutation route, writes of same coalescing key in one frame are merged (last writer wins)
+		 * Superseded requests are responded as coalesced without being applied
+		 */
+		template <typename TRequest, typename TResponse>
+		static FHttpRouteHandle BindCoalescedRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const TTypedResponser<TRequest, TResponse>& Responser, const TCoalesceKey<TRequest>& CoalesceKey)
+		{
+			const FStructCodec& RequestCodec = FStructCodec::Get(TRequest::StaticStruct());
+			const FStructCodec& ResponseCodec = FStructCodec::Get(TResponse::StaticStruct());
+			return BindMutationRoute<TRequest, TResponse>(HttpRouter, Path, Verb, RequestCodec, ResponseCodec, Responser, CoalesceKey);
+		}
+
+		/**
+		 * Create json operation (for batch) from typed responser, params & data are decoded & encoded by cached reflection codecs
+		 */
+		template <typename TRequest, typename TResponse>
+		static FJsonOperation CreateTypedOperation(const TTypedResponser<TRequest, TResponse>& Responser)
+		{
+			const FStructCodec& RequestCodec = FStructCodec::Get(TRequest::StaticStruct());
+			const FStructCodec& ResponseCodec = FStructCodec::Get(TResponse::StaticStruct());
+			return [&RequestCodec, &ResponseCodec, Responser](const TSharedPtr<FJsonObject>& Params, TSharedPtr<FJsonObject>& OutData, FString& OutMessage)
+			{
+				TRequest RequestBody;
+				if (!RequestCodec.ReadJsonObject(Params, &RequestBody, OutMessage))
+				{
+					return false;
+				}
+				TResponse ResponseBody;
+				if (!Responser(RequestBody, ResponseBody, OutMessage))
+				{
+					return false;
+				}
+				OutData = ResponseCodec.WriteJsonObject(&ResponseBody);
+				return true;
+			};
+		}
+
 		/**
 		 * Create HTTP request handler (controller)
 		 * In UE4, invoke OnComplete and return false will cause crash
 		 * CreateHandler method is used to wrap the responser, in order to avoid the crash
+		 * Requests are recorded into route metrics if given
 		 */
-		static FHttpRequestHandler CreateHandler(const FHttpResponser& HttpResponser);
+		static FHttpRequestHandler CreateHandler(const FHttpResponser& HttpResponser, const TSharedPtr<FRouteMetrics, ESPMode::ThreadSafe>& RouteMetrics = nullptr);
+
+		/**
+		 * Create HTTP request handler from async responser
+		 * The request is copied so that it can outlive the handler call, and the response is always completed on game thread
+		 * Requests are recorded into route metrics if given
+		 */
+		static FHttpRequestHandler CreateAsyncHandler(const FAsyncHttpResponser& AsyncHttpResponser, const TSharedPtr<FRouteMetrics, ESPMode::ThreadSafe>& RouteMetrics = nullptr);
+
+		/**
+		 * Run task on game thread (for UObject access in async responsers)
+		 * Response format & request metrics of current thread are carried to the task
+		 */
+		static void RunOnGameThread(TUniqueFunction<void()> Task);
+
+		/**
+		 * Run task on background worker thread (for parsing & serializing in async responsers)
+		 */
+		static void RunOnWorkerThread(TUniqueFunction<void()> Task);
+
+		/**
+		 * Enqueue mutating task into frame-budgeted mutation queue (applied on game thread), returns false if the queue is full
+		 * Response format & request metrics of current thread are carried to the task
+		 */
+		static bool EnqueueMutation(TUniqueFunction<void()> Task);
+
+		/**
+		 * Enqueue mutating task keyed by written target & property, a queued task of same key is replaced (last writer wins)
+		 * OnSuperseded is invoked on game thread if this task is replaced by a later one
+		 */
+		static bool EnqueueCoalescedMutation(const FString& Key, TUniqueFunction<void()> Task, TUniqueFunction<void()> OnSuperseded);
+
+		/**
+		 * Get response body format of current thread
+		 */
+		static EBodyFormat GetResponseFormat();
+
+		/**
+		 * Get frame of published world state, 0 if nothing is published (any thread)
+		 */
+		static uint64 GetPublishedFrame();
+
+		/**
+		 * Get response body format accepted by request (Accept header)
+		 */
+		static EBodyFormat GetAcceptedFormat(const FHttpServerRequest& Request);
 
 		/**
 		 * Get request json body, parse TArray<uint8> to TSharedPtr<FJsonObject>
+		 * MessagePack body (Content-Type: application/msgpack) is decoded into the same dom
 		 */
 		static TSharedPtr<FJsonObject> GetRequestJsonBody(const FHttpServerRequest& Request);
 
 		/**
-		 * Get Struct body (based on json body, the struct type should be UStruct)
+		 * Read top-level number fields of request json (or MessagePack) body in place
+		 * The UTF-8 body is streamed with bounded length, without copying it, widening it to TCHAR or building json dom
+		 */
+		static bool ReadRequestNumberFields(const FHttpServerRequest& Request, TArrayView<const FJsonNumberField> Fields);
+
+		/**
+		 * Read USTRUCT body of request into struct by its cached reflection codec, json body is streamed without building dom
 		 */
 		template <typename UStructType>
-		static UStructType* GetRequestUStructBody(const FHttpServerRequest& Request);
+		static bool GetRequestUStructBody(const FHttpServerRequest& Request, UStructType& OutBody)
+		{
+			FString Message;
+			if (!ReadRequestStructBody(Request, FStructCodec::Get(UStructType::StaticStruct()), &OutBody, Message))
+			{
+				UE_LOG(UHttpLog, Verbose, TEXT("failed to parse request body to ustruct: %s"), *Message);
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		 * Read request json (or MessagePack) body into struct data with codec
+		 */
+		static bool ReadRequestStructBody(const FHttpServerRequest& Request, const FStructCodec& Codec, void* Data, FString& OutMessage);
 
 		/**
 		 * Success response (data & message)
@@ -58,6 +319,16 @@ namespace UnrealHttpServer
 		 */
 		static TUniquePtr<FHttpServerResponse> SuccessResponse(FString Message);
 
+		/**
+		 * Success response (data written by data writer, with estimated data size in bytes)
+		 */
+		static TUniquePtr<FHttpServerResponse> SuccessResponse(const FBodyDataWriter& DataWriter, int32 DataSizeHint);
+
+		/**
+		 * Success response (data written by data writer & message)
+		 */
+		static TUniquePtr<FHttpServerResponse> SuccessResponse(const FBodyDataWriter& DataWriter, int32 DataSizeHint, FString Message);
+
 		/**
 		 * Error response (data & message & code)
 		 */
@@ -77,7 +348,20 @@ namespace UnrealHttpServer
 		 * Error response (message only)
 		 */
 		static TUniquePtr<FHttpServerResponse> ErrorResponse(FString Message);
+
+		/**
+		 * Error response with 429 status & Retry-After header, for requests rejected by a full mutation queue
+		 */
+		static TUniquePtr<FHttpServerResponse> TooManyRequestsResponse();
+
+		/**
+		 * Success response of a write superseded by a later write of same target in one frame (data: coalesced = true)
+		 */
+		static TUniquePtr<FHttpServerResponse> CoalescedResponse();
 	private:
+		/* Path router binds its dispatcher as a route handler */
+		friend class FPathRouter;
+
 		/* Success code in response body */
 		static const int32 SUCCESS_CODE = 0;
 		/* Default error code in response body */
@@ -88,14 +372,99 @@ namespace UnrealHttpServer
 		 */
 		static FString GetHttpVerbStringFromEnum(const EHttpServerRequestVerbs& Verb);
 
+		/**
+		 * Wrap task with response format & request metrics of current thread
+		 */
+		static TUniqueFunction<void()> WrapTaskContext(TUniqueFunction<void()> Task);
+
+		/**
+		 * Complete response on game thread, compressed on worker thread first if encoding is accepted & body is large enough
+		 * Request metrics (if any) are completed with the body to send
+		 */
+		static void CompleteResponse(const FHttpResultCallback& OnComplete, TUniquePtr<FHttpServerResponse>&& Response, FName Encoding, const TSharedPtr<FRequestMetrics, ESPMode::ThreadSafe>& Metrics);
+
+		/**
+		 * Bind a route with created request handler
+		 */
+		static FHttpRouteHandle BindRouteHandler(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FHttpRequestHandler& Handler);
+
 		/**
 		 * Create json response from data, message, success status and user defined error code
+		 * The body is encoded in response format of current thread
 		 */
 		static TUniquePtr<FHttpServerResponse> JsonResponse(TSharedPtr<FJsonObject> Data, FString Message, bool Success, int32 Code);
 
+		/**
+		 * Create response with data written by data writer, the envelope is same as json response
+		 */
+		static TUniquePtr<FHttpServerResponse> BodyResponse(const FBodyDataWriter& DataWriter, int32 DataSizeHint, const FString& Message, bool Success, int32 Code);
+
+		/**
+		 * Bind typed route with body, decoded on worker thread and applied through the mutation queue
+		 */
+		template <typename TRequest, typename TResponse>
+		static FHttpRouteHandle BindMutationRoute(const TSharedPtr<IHttpRouter>& HttpRouter, FString Path, const EHttpServerRequestVerbs& Verb, const FStructCodec& RequestCodec, const FStructCodec& ResponseCodec, const TTypedResponser<TRequest, TResponse>& Responser, const TCoalesceKey<TRequest>& CoalesceKey)
+		{
+			return BindAsyncRoute(HttpRouter, Path, Verb, [Path, &RequestCodec, &ResponseCodec, Responser, CoalesceKey](const FHttpServerRequestRef& Request, const FHttpResponseCallback& Respond)
+			{
+				RunOnWorkerThread([Path, &RequestCodec, &ResponseCodec, Responser, CoalesceKey, Request, Respond]()
+				{
+					TRequest RequestBody;
+					FString Message;
+					if (!RequestCodec.ReadQueryParams(Request->QueryParams, &RequestBody, Message)
+						|| !ReadRequestStructBody(*Request, RequestCodec, &RequestBody, Message))
+					{
+						Respond(ErrorResponse(Message));
+						return;
+					}
+					FString Key = CoalesceKey ? Path + TEXT("|") + CoalesceKey(RequestBody) : FString();
+					// mutations are applied in frame budget, reads bypass the queue
+					TUniqueFunction<void()> Apply = [&ResponseCodec, Responser, Respond, RequestBody = MoveTemp(RequestBody)]()
+					{
+						Respond(TypedResponse(ResponseCodec, Responser, RequestBody));
+					};
+					bool bQueued = Key.IsEmpty()
+						? EnqueueMutation(MoveTemp(Apply))
+						: EnqueueCoalescedMutation(Key, MoveTemp(Apply), [Respond]() { Respond(CoalescedResponse()); });
+					if (!bQueued)
+					{
+						Respond(TooManyRequestsResponse());
+					}
+				});
+			});
+		}
+
+		/**
+		 * Invoke typed responser and encode its response
+		 */
+		template <typename TRequest, typename TResponse>
+		static TUniquePtr<FHttpServerResponse> TypedResponse(const FStructCodec& ResponseCodec, const TTypedResponser<TRequest, TResponse>& Responser, const TRequest& RequestBody)
+		{
+			TResponse ResponseBody;
+			FString Message;
+			if (!Responser(RequestBody, ResponseBody, Message))
+			{
+				return ErrorResponse(Message);
+			}
+			return SuccessResponse([&ResponseCodec, &ResponseBody](FBodyWriter& Writer)
+			{
+				ResponseCodec.Write(Writer, &ResponseBody);
+			}, ResponseCodec.GetSizeHint(), Message);
+		}
+
 		/**
 		 * Check if the body content will be parsed as UTF-8 json by header
 		 */
 		static bool IsUTF8JsonRequestContent(const FHttpServerRequest& Request);
+
+		/**
+		 * Check if the body content will be parsed as MessagePack by header
+		 */
+		static bool IsMsgPackRequestContent(const FHttpServerRequest& Request);
+
+		/**
+		 * Check if a content type or accept header value is MessagePack
+		 */
+		static bool IsMsgPackMediaType(const FString& Value);
 	};
 }
\ No newline at end of file
@@ -4,27 +4,177 @@
 #include "Log.h"
 #include "Runtime/Online/HTTPServer/Public/HttpServerModule.h"
 #include "Runtime/Online/HTTPServer/Public/HttpPath.h"
+#include "Transport/SocketServer.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/FileHelper.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "IPAddress.h"
+#include "Util/StartupTiming.h"
+#include "Util/PathRouter.h"
 
 
 // Handlers
 #include "Handler/BaseHandler.h"
 #include "Handler/PlayerHandler.h"
+#include "Handler/BatchHandler.h"
+#include "Handler/ActorHandler.h"
+#include "Handler/WorldHandler.h"
+#include "Handler/TimelineHandler.h"
+#include "Handler/StaticFileHandler.h"
 
 
 namespace UnrealHttpServer
-{	
-	void FWebServer::Start(uint32 Port)
+{
+	namespace
+	{
+		TAutoConsoleVariable<FString> CVarServerTransport(
+			TEXT("UHttp.Server.Transport"),
+			TEXT("engine"),
+			TEXT("Transport of server started with module, engine: engine HTTPServer listener, socket: socket server with keep-alive & pipelining"),
+			ECVF_ReadOnly);
+
+		/* Ini section of server settings */
+		const TCHAR* CONFIG_SECTION = TEXT("UnrealHttpServer");
+	}
+
+	uint32 FWebServer::BoundPort = 0;
+
+	bool FWebServer::bHeadless = false;
+
+	TMap<uint32, FWebServer::FStandaloneListener> FWebServer::StandaloneListeners;
+
+	uint32 FWebServer::IdleEnginePort = 0;
+
+	bool FWebServer::Start(uint32 Port)
+	{
+		return Start(Port, GetConfiguredTransport());
+	}
+
+	bool FWebServer::Start(uint32 Port, EServerTransport Transport)
+	{
+		FServerConfig Config;
+		Config.Port = Port;
+		Config.Transport = Transport;
+		Config.bHeadless = bHeadless;
+		return Start(Config);
+	}
+
+	bool FWebServer::Start(const FServerConfig& Config)
 	{
-		auto HttpServerModule = &FHttpServerModule::Get();
 		UE_LOG(UHttpLog, Log, TEXT("Starting UnrealHttpServer Server..."));
-		TSharedPtr<IHttpRouter> HttpRouter = HttpServerModule->GetHttpRouter(Port);
-		BindRouters(HttpRouter);
-		// Start Listeners
-		HttpServerModule->StartAllListeners();
-		if (GEngine != nullptr)
+		bHeadless = Config.bHeadless;
+		uint32 Port = Config.Port;
+		if (Config.Transport == EServerTransport::Socket)
+		{
+			// socket server binds port 0 itself and reports the actual one
+			TSharedPtr<IHttpRouter> HttpRouter = FSocketServer::Start(Port, Config.BindAddress);
+			if (HttpRouter == nullptr)
+			{
+				UE_LOG(UHttpLog, Error, TEXT("Failed to start socket server on port %u!"), Port);
+				return false;
+			}
+			Port = FSocketServer::GetPort();
+			BindRouters(HttpRouter);
+		}
+		else
+		{
+			// engine listeners cannot report a port bound by system, so probe a free one ahead
+			if (Port == 0)
+			{
+				Port = FindFreePort();
+				if (Port == 0)
+				{
+					UE_LOG(UHttpLog, Error, TEXT("Failed to find a free port!"));
+					return false;
+				}
+			}
+			if (!Config.BindAddress.IsEmpty() && GConfig != nullptr)
+			{
+				GConfig->SetString(TEXT("HTTPServer.Listeners"), TEXT("DefaultBindAddress"), *Config.BindAddress, GEngineIni);
+			}
+			auto HttpServerModule = &FHttpServerModule::Get();
+			TSharedPtr<IHttpRouter> HttpRouter = HttpServerModule->GetHttpRouter(Port);
+			if (HttpRouter == nullptr)
+			{
+				UE_LOG(UHttpLog, Error, TEXT("Failed to get http router on port %u!"), Port);
+				return false;
+			}
+			BindRouters(HttpRouter);
+			// Start Listeners
+			HttpServerModule->StartAllListeners();
+		}
+		BoundPort = Port;
+		FStartupTiming::MarkListening();
+		UE_LOG(UHttpLog, Log, TEXT("UnrealHttpServer Server started on port %u"), Port);
+		if (GEngine != nullptr && !bHeadless)
 		{
 			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Green, TEXT("UnrealHttpServer Server Started"));
 		}
+		return true;
+	}
+
+	FServerConfig FWebServer::LoadConfig(uint32 DefaultPort, uint32 DefaultWebSocketPort)
+	{
+		FServerConfig Config;
+		Config.Port = DefaultPort;
+		Config.WebSocketPort = DefaultWebSocketPort;
+		Config.Transport = GetConfiguredTransport();
+		FString TransportName;
+
+		// ini settings
+		if (GConfig != nullptr)
+		{
+			int32 Value = 0;
+			if (GConfig->GetInt(CONFIG_SECTION, TEXT("Port"), Value, GEngineIni))
+			{
+				Config.Port = (uint32)FMath::Max(0, Value);
+			}
+			if (GConfig->GetInt(CONFIG_SECTION, TEXT("WebSocketPort"), Value, GEngineIni))
+			{
+				Config.WebSocketPort = (uint32)FMath::Max(0, Value);
+			}
+			GConfig->GetString(CONFIG_SECTION, TEXT("BindAddress"), Config.BindAddress, GEngineIni);
+			GConfig->GetString(CONFIG_SECTION, TEXT("Transport"), TransportName, GEngineIni);
+			GConfig->GetString(CONFIG_SECTION, TEXT("PortFile"), Config.PortFile, GEngineIni);
+			GConfig->GetBool(CONFIG_SECTION, TEXT("EarlyStart"), Config.bEarlyStart, GEngineIni);
+			GConfig->GetBool(CONFIG_SECTION, TEXT("Headless"), Config.bHeadless, GEngineIni);
+		}
+
+		// command line overrides
+		const TCHAR* CommandLine = FCommandLine::Get();
+		FParse::Value(CommandLine, TEXT("UHttpPort="), Config.Port);
+		FParse::Value(CommandLine, TEXT("UHttpWebSocketPort="), Config.WebSocketPort);
+		FParse::Value(CommandLine, TEXT("UHttpBind="), Config.BindAddress);
+		FParse::Value(CommandLine, TEXT("UHttpTransport="), TransportName);
+		FParse::Value(CommandLine, TEXT("UHttpPortFile="), Config.PortFile);
+		if (FParse::Param(CommandLine, TEXT("UHttpEarlyStart")))
+		{
+			Config.bEarlyStart = true;
+		}
+		if (FParse::Param(CommandLine, TEXT("UHttpHeadless")))
+		{
+			Config.bHeadless = true;
+		}
+
+		if (!TransportName.IsEmpty() && !ParseTransport(TransportName, Config.Transport))
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Unknown server transport: %s, %s is used"), *TransportName,
+				Config.Transport == EServerTransport::Socket ? TEXT("socket") : TEXT("engine"));
+		}
+		// nothing is rendered on dedicated servers or with -nullrhi
+		if (IsRunningDedicatedServer() || !FApp::CanEverRender())
+		{
+			Config.bHeadless = true;
+		}
+		if (Config.bHeadless)
+		{
+			Config.bEarlyStart = true;
+		}
+		return Config;
 	}
 
 	void FWebServer::Stop()
@@ -32,29 +182,214 @@ namespace UnrealHttpServer
 		UE_LOG(UHttpLog, Log, TEXT("Stopping UnrealHttpServer Server..."));
 		auto HttpServerModule = &FHttpServerModule::Get();
 		HttpServerModule->StopAllListeners();
+		FSocketServer::Stop();
+		BoundPort = 0;
+	}
+
+	uint32 FWebServer::GetPort()
+	{
+		return BoundPort;
+	}
+
+	bool FWebServer::IsHeadless()
+	{
+		return bHeadless;
+	}
+
+	uint32 FWebServer::FindFreePort()
+	{
+		// bind to port 0 and let the system pick one, the probe socket is closed before the server binds it
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+		if (SocketSubsystem == nullptr)
+		{
+			return 0;
+		}
+		FSocket* Socket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("UHttpPortProbe"), false);
+		if (Socket == nullptr)
+		{
+			return 0;
+		}
+		TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+		Address->SetAnyAddress();
+		Address->SetPort(0);
+		uint32 Port = Socket->Bind(*Address) ? Socket->GetPortNo() : 0;
+		Socket->Close();
+		SocketSubsystem->DestroySocket(Socket);
+		return Port;
+	}
+
+	bool FWebServer::WritePortFile(const FString& PortFile, uint32 Port, uint32 WebSocketPort)
+	{
+		if (PortFile.IsEmpty())
+		{
+			return true;
+		}
+		FString Content = FString::Printf(TEXT("{\"port\":%u,\"websocket_port\":%u}"), Port, WebSocketPort);
+		if (!FFileHelper::SaveStringToFile(Content, *PortFile))
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Failed to write port file: %s"), *PortFile);
+			return false;
+		}
+		return true;
+	}
+
+	EServerTransport FWebServer::GetConfiguredTransport()
+	{
+		EServerTransport Transport = EServerTransport::Engine;
+		if (!ParseTransport(CVarServerTransport.GetValueOnGameThread(), Transport))
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Unknown server transport: %s, engine listener is used"), *CVarServerTransport.GetValueOnGameThread());
+		}
+		return Transport;
+	}
+
+	bool FWebServer::ParseTransport(const FString& Name, EServerTransport& OutTransport)
+	{
+		if (Name == TEXT("engine"))
+		{
+			OutTransport = EServerTransport::Engine;
+			return true;
+		}
+		if (Name == TEXT("socket"))
+		{
+			OutTransport = EServerTransport::Socket;
+			return true;
+		}
+		return false;
+	}
+
+	uint32 FWebServer::StartStandalone(EServerTransport Transport)
+	{
+		FStandaloneListener Listener;
+		Listener.Transport = Transport;
+		uint32 Port = 0;
+		if (Transport == EServerTransport::Socket)
+		{
+			Listener.Router = FSocketServer::StartStandalone(0, Port);
+		}
+		else
+		{
+			Port = IdleEnginePort != 0 ? IdleEnginePort : FindFreePort();
+			IdleEnginePort = 0;
+			Listener.Router = Port != 0 ? FHttpServerModule::Get().GetHttpRouter(Port) : nullptr;
+		}
+		if (Listener.Router == nullptr)
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("Failed to start standalone listener!"));
+			return 0;
+		}
+		{
+			FRouteBindingScope BindingScope(Listener.RouteHandles);
+			BindRouters(Listener.Router);
+		}
+		if (Transport == EServerTransport::Engine)
+		{
+			FHttpServerModule::Get().StartAllListeners();
+		}
+		UE_LOG(UHttpLog, Log, TEXT("Standalone listener started on port %u"), Port);
+		StandaloneListeners.Add(Port, MoveTemp(Listener));
+		return Port;
+	}
+
+	void FWebServer::StopStandalone(uint32 Port)
+	{
+		FStandaloneListener Listener;
+		if (!StandaloneListeners.RemoveAndCopyValue(Port, Listener))
+		{
+			return;
+		}
+		if (Listener.Transport == EServerTransport::Socket)
+		{
+			FSocketServer::StopStandalone(Port);
+		}
+		else
+		{
+			for (const FHttpRouteHandle& RouteHandle : Listener.RouteHandles)
+			{
+				Listener.Router->UnbindRoute(RouteHandle);
+			}
+			IdleEnginePort = Port;
+		}
+		UE_LOG(UHttpLog, Log, TEXT("Standalone listener stopped on port %u"), Port);
 	}
 
 	void FWebServer::BindRouters(const TSharedPtr<IHttpRouter>& HttpRouter)
 	{
 		// UE4 uses Map<String, Handle> to store router bindings, so that bind different verbs to a same HTTP path is not supported
+		// FPathRouter binds one prefix and dispatches path parameters & verbs of the routes under it
 
 		/* ====================== Base Handler ==================== */
 
 		// health check
 		FWebUtil::BindRoute(HttpRouter, TEXT("/health"), EHttpServerRequestVerbs::VERB_GET, FBaseHandler::HealthCheck);
 
+		// route metrics (Prometheus text format)
+		FWebUtil::BindRoute(HttpRouter, TEXT("/metrics"), EHttpServerRequestVerbs::VERB_GET, &FBaseHandler::Metrics);
+
 		/* ====================== Player Handler ==================== */
 
-		// get player location
-		FWebUtil::BindRoute(HttpRouter, TEXT("/player/get_location"), EHttpServerRequestVerbs::VERB_GET, &FPlayerHandler::GetPlayerLocation);
+		// get player location (published world state, served on worker thread)
+		FWebUtil::BindWorkerRoute<FUHttpPlayerTarget, FUHttpPlayerLocation>(HttpRouter, TEXT("/player/get_location"), EHttpServerRequestVerbs::VERB_GET, &FPlayerHandler::GetPublishedPlayerLocation);
+
+		// set player location (same-frame writes coalesced)
+		FWebUtil::BindCoalescedRoute<FUHttpSetPlayerLocationRequest, FUHttpEmpty>(HttpRouter, TEXT("/player/set_location"), EHttpServerRequestVerbs::VERB_PUT, &FPlayerHandler::SetPlayerLocation, &FPlayerHandler::GetTargetKey);
+
+		// get player rotation (published world state, served on worker thread)
+		FWebUtil::BindWorkerRoute<FUHttpPlayerTarget, FUHttpPlayerRotation>(HttpRouter, TEXT("/player/get_rotation"), EHttpServerRequestVerbs::VERB_GET, &FPlayerHandler::GetPublishedPlayerRotation);
+
+		// set player rotation (same-frame writes coalesced)
+		FWebUtil::BindCoalescedRoute<FUHttpSetPlayerRotationRequest, FUHttpEmpty>(HttpRouter, TEXT("/player/set_rotation"), EHttpServerRequestVerbs::VERB_PUT, &FPlayerHandler::SetPlayerRotation, &FPlayerHandler::GetTargetKey);
+
+		// watch player transform changes (long-poll)
+		FWebUtil::BindAsyncRoute(HttpRouter, TEXT("/player/watch_transform"), EHttpServerRequestVerbs::VERB_GET, &FPlayerHandler::WatchPlayerTransform);
+
+		// get player transform history
+		FWebUtil::BindAsyncRoute(HttpRouter, TEXT("/player/history"), EHttpServerRequestVerbs::VERB_GET, &FPlayerHandler::GetPlayerHistory);
+
+		/* ====================== Actor Handler ==================== */
+
+		// query actors by class, tag & spatial filters
+		FWebUtil::BindAsyncRoute(HttpRouter, TEXT("/actors/query"), EHttpServerRequestVerbs::VERB_POST, &FActorHandler::QueryActors);
+
+		// per-actor routes, exact routes above take precedence over the catch-all prefix
+		TSharedRef<FPathRouter, ESPMode::ThreadSafe> ActorRouter = MakeShared<FPathRouter, ESPMode::ThreadSafe>(FActorHandler::ROUTE);
+		ActorRouter->AddRoute(FActorHandler::TRANSFORM_ROUTE, EHttpServerRequestVerbs::VERB_GET, &FActorHandler::GetActorTransform);
+		ActorRouter->AddAsyncRoute(FActorHandler::TRANSFORM_ROUTE, EHttpServerRequestVerbs::VERB_PUT, &FActorHandler::SetActorTransform);
+		ActorRouter->Bind(HttpRouter);
+
+		/* ====================== World Handler ==================== */
+
+		// capture transforms of player pawn & selected actors into a snapshot
+		FWebUtil::BindTypedRoute<FUHttpCaptureSnapshotRequest, FUHttpSnapshotInfo>(HttpRouter, TEXT("/world/capture_snapshot"), EHttpServerRequestVerbs::VERB_POST, &FWorldHandler::CaptureSnapshot);
+
+		// restore a snapshot in one pass
+		FWebUtil::BindTypedRoute<FUHttpSnapshotRequest, FUHttpRestoreSnapshotResponse>(HttpRouter, TEXT("/world/restore_snapshot"), EHttpServerRequestVerbs::VERB_POST, &FWorldHandler::RestoreSnapshot);
+
+		// delete a snapshot
+		FWebUtil::BindTypedRoute<FUHttpSnapshotRequest, FUHttpEmpty>(HttpRouter, TEXT("/world/delete_snapshot"), EHttpServerRequestVerbs::VERB_DELETE, &FWorldHandler::DeleteSnapshot);
+
+		/* ====================== Timeline Handler ==================== */
+
+		// start a scheduled timeline of batch operations
+		FWebUtil::BindAsyncRoute(HttpRouter, TEXT("/timeline/start"), EHttpServerRequestVerbs::VERB_POST, &FTimelineHandler::StartTimeline);
+
+		// get timeline progress
+		FWebUtil::BindTypedRoute<FUHttpTimelineRequest, FUHttpTimelineProgress>(HttpRouter, TEXT("/timeline/progress"), EHttpServerRequestVerbs::VERB_GET, &FTimelineHandler::GetTimelineProgress);
+
+		// pause or resume timeline
+		FWebUtil::BindTypedRoute<FUHttpPauseTimelineRequest, FUHttpTimelineProgress>(HttpRouter, TEXT("/timeline/pause"), EHttpServerRequestVerbs::VERB_POST, &FTimelineHandler::PauseTimeline);
+
+		// cancel timeline
+		FWebUtil::BindTypedRoute<FUHttpTimelineRequest, FUHttpTimelineProgress>(HttpRouter, TEXT("/timeline/cancel"), EHttpServerRequestVerbs::VERB_POST, &FTimelineHandler::CancelTimeline);
+
+		/* ====================== Static File Handler ==================== */
 
-		// set player location
-		FWebUtil::BindRoute(HttpRouter, TEXT("/player/set_location"), EHttpServerRequestVerbs::VERB_PUT, &FPlayerHandler::SetPlayerLocation);
+		// serve static files under root, child paths are matched by the route prefix
+		FWebUtil::BindAsyncRoute(HttpRouter, FStaticFileHandler::ROUTE, EHttpServerRequestVerbs::VERB_GET, &FStaticFileHandler::ServeFile);
 
-		// get player rotation
-		FWebUtil::BindRoute(HttpRouter, TEXT("/player/get_rotation"), EHttpServerRequestVerbs::VERB_GET, &FPlayerHandler::GetPlayerRotation);
+		/* ====================== Batch Handler ==================== */
 
-		// set player rotation
-		FWebUtil::BindRoute(HttpRouter, TEXT("/player/set_rotation"), EHttpServerRequestVerbs::VERB_PUT, &FPlayerHandler::SetPlayerRotation);
+		// execute batch operations
+		FWebUtil::BindAsyncRoute(HttpRouter, TEXT("/batch"), EHttpServerRequestVerbs::VERB_POST, &FBatchHandler::ExecuteBatch);
 	}
 }
\ No newline at end of file
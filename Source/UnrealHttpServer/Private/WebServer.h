@@ -4,24 +4,132 @@
 
 namespace UnrealHttpServer
 {
+	/**
+	 * Listener implementation serving bound routes
+	 */
+	enum class EServerTransport : uint8
+	{
+		/* Engine HTTPServer listener */
+		Engine,
+		/* Socket server with keep-alive, pipelining & worker pool */
+		Socket,
+	};
+
+	/**
+	 * Server settings, loaded from [UnrealHttpServer] of engine ini and overridden by command line:
+	 *   Port / -UHttpPort=, 0 for an ephemeral port reported back by log & port file
+	 *   WebSocketPort / -UHttpWebSocketPort=, 0 for an ephemeral port
+	 *   BindAddress / -UHttpBind=, any for all interfaces
+	 *   Transport / -UHttpTransport=, engine or socket, UHttp.Server.Transport if not set
+	 *   PortFile / -UHttpPortFile=, file to write bound ports into as json
+	 *   EarlyStart / -UHttpEarlyStart, start on module load instead of after engine init
+	 *   Headless / -UHttpHeadless, no on-screen messages & early start, implied by dedicated server or NullRHI
+	 */
+	struct FServerConfig
+	{
+		uint32 Port = 0;
+		uint32 WebSocketPort = 0;
+		FString BindAddress;
+		EServerTransport Transport = EServerTransport::Engine;
+		FString PortFile;
+		bool bEarlyStart = false;
+		bool bHeadless = false;
+	};
+
 	class FWebServer
 	{
 	public:
 		/**
-		 * Start server
+		 * Start server with transport configured by UHttp.Server.Transport, returns false if failed
+		 */
+		static bool Start(uint32 Port);
+
+		/**
+		 * Start server with transport, returns false if failed
+		 */
+		static bool Start(uint32 Port, EServerTransport Transport);
+
+		/**
+		 * Start server with settings, port 0 is resolved to an ephemeral one, returns false if failed
 		 */
-		static void Start(uint32 Port);
+		static bool Start(const FServerConfig& Config);
+
+		/**
+		 * Load settings from ini & command line, ports default to given ones
+		 */
+		static FServerConfig LoadConfig(uint32 DefaultPort, uint32 DefaultWebSocketPort);
+
+		/**
+		 * Get transport configured by UHttp.Server.Transport
+		 */
+		static EServerTransport GetConfiguredTransport();
+
+		/**
+		 * Parse transport name (engine or socket), returns false if unknown
+		 */
+		static bool ParseTransport(const FString& Name, EServerTransport& OutTransport);
 
 		/**
 		 * Stop server
 		 */
 		static void Stop();
 
+		/**
+		 * Get bound port of last started server, 0 if not started
+		 */
+		static uint32 GetPort();
+
+		/**
+		 * Check if on-screen messages should be suppressed
+		 */
+		static bool IsHeadless();
+
+		/**
+		 * Find a free local tcp port, 0 if failed
+		 */
+		static uint32 FindFreePort();
+
+		/**
+		 * Write bound ports into port file as json, so that launchers can find ephemeral ports
+		 */
+		static bool WritePortFile(const FString& PortFile, uint32 Port, uint32 WebSocketPort);
+
+		/**
+		 * Start a standalone listener of transport with all routes on a free local port (e.g. for benchmarks),
+		 * server state above, startup timing & on-screen messages are untouched. Returns bound port, 0 if failed
+		 */
+		static uint32 StartStandalone(EServerTransport Transport);
+
+		/**
+		 * Stop standalone listener of port. Engine listeners cannot be stopped one by one,
+		 * so routes of an engine one are unbound and its port is reused by the next standalone start
+		 */
+		static void StopStandalone(uint32 Port);
+
 	private:
 		/**
 		 * Bind routers with handlers
 		 */
 		static void BindRouters(const TSharedPtr<IHttpRouter>& HttpRouter);
+
+		/**
+		 * Standalone listener & its bound routes
+		 */
+		struct FStandaloneListener
+		{
+			EServerTransport Transport;
+			TSharedPtr<IHttpRouter> Router;
+			TArray<FHttpRouteHandle> RouteHandles;
+		};
+
+		static uint32 BoundPort;
+
+		static TMap<uint32, FStandaloneListener> StandaloneListeners;
+
+		/* Engine listener port of a stopped standalone listener, 0 if none */
+		static uint32 IdleEnginePort;
+
+		static bool bHeadless;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+#include "WebSocketServer.h"
+#include "Log.h"
+#include "Util/WebUtil.h"
+#include "Handler/PlayerHandler.h"
+#include "Containers/Ticker.h"
+#include "Modules/ModuleManager.h"
+#include "IWebSocketNetworkingModule.h"
+#include "IWebSocketServer.h"
+#include "INetworkingWebSocket.h"
+#include "WebSocketNetworkingDelegates.h"
+
+namespace UnrealHttpServer
+{
+	namespace
+	{
+		/* Header bytes of a request, op & seq */
+		const int32 REQUEST_HEADER_BYTES = 2;
+
+		/* Transform change to push to subscribers */
+		const float PUSH_LOCATION_TOLERANCE = 0.01f;
+		const float PUSH_ROTATION_TOLERANCE = 0.01f;
+
+		void AppendFloat(TArray<uint8>& Bytes, float Value)
+		{
+			Bytes.Append(reinterpret_cast<const uint8*>(&Value), sizeof(float));
+		}
+
+		float ReadFloat(const uint8* Data)
+		{
+			float Value;
+			FMemory::Memcpy(&Value, Data, sizeof(float));
+			return Value;
+		}
+	}
+
+	TUniquePtr<IWebSocketServer> FWebSocketServer::Server;
+	TMap<uint32, FWebSocketServer::FConnection> FWebSocketServer::Connections;
+	uint32 FWebSocketServer::NextConnectionId = 1;
+	FDelegateHandle FWebSocketServer::TickerHandle;
+
+	/* ================= Public Methods ==================== */
+
+	bool FWebSocketServer::Start(uint32 Port)
+	{
+		if (Server.IsValid())
+		{
+			UE_LOG(UHttpLog, Warning, TEXT("WebSocket server is already running!"));
+			return false;
+		}
+		IWebSocketNetworkingModule* WebSocketModule = FModuleManager::LoadModulePtr<IWebSocketNetworkingModule>(TEXT("WebSocketNetworking"));
+		if (WebSocketModule == nullptr)
+		{
+			UE_LOG(UHttpLog, Error, TEXT("WebSocketNetworking module is not available!"));
+			return false;
+		}
+		Server = WebSocketModule->CreateServer();
+		if (!Server.IsValid() || !Server->Init(Port, FWebSocketClientConnectedCallBack::CreateStatic(&FWebSocketServer::OnClientConnected)))
+		{
+			UE_LOG(UHttpLog, Error, TEXT("Failed to start WebSocket server on port %u!"), Port);
+			Server.Reset();
+			return false;
+		}
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FWebSocketServer::Tick));
+		UE_LOG(UHttpLog, Log, TEXT("WebSocket server listening on port %u"), Port);
+		return true;
+	}
+
+	void FWebSocketServer::Stop()
+	{
+		if (TickerHandle.IsValid())
+		{
+			FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+			TickerHandle.Reset();
+		}
+		// sockets are owned by server
+		Connections.Empty();
+		Server.Reset();
+	}
+
+	/* ================= Private Methods ==================== */
+
+	bool FWebSocketServer::Tick(float DeltaTime)
+	{
+		Server->Tick();
+
+		TArray<uint8> Message;
+		for (TPair<uint32, FConnection>& Pair : Connections)
+		{
+			FConnection& Connection = Pair.Value;
+			if (!Connection.bSubscribed)
+			{
+				continue;
+			}
+			FString ErrorMessage;
+			FUHttpPlayerLocation Location;
+			FUHttpPlayerRotation Rotation;
+			if (!FPlayerHandler::GetPlayerLocation(Connection.Target, Location, ErrorMessage)
+				|| !FPlayerHandler::GetPlayerRotation(Connection.Target, Rotation, ErrorMessage))
+			{
+				continue;
+			}
+			FVector NewLocation(Location.X, Location.Y, Location.Z);
+			FRotator NewRotation(Rotation.Pitch, Rotation.Yaw, Rotation.Roll);
+			if (Connection.bPushed && NewLocation.Equals(Connection.LastLocation, PUSH_LOCATION_TOLERANCE) && NewRotation.Equals(Connection.LastRotation, PUSH_ROTATION_TOLERANCE))
+			{
+				continue;
+			}
+			Connection.bPushed = true;
+			Connection.LastLocation = NewLocation;
+			Connection.LastRotation = NewRotation;
+
+			uint32 Frame = (uint32)GFrameCounter;
+			Message.Reset();
+			Message.Add(OP_PUSH_TRANSFORM);
+			Message.Append(reinterpret_cast<const uint8*>(&Frame), sizeof(uint32));
+			AppendFloat(Message, Location.X);
+			AppendFloat(Message, Location.Y);
+			AppendFloat(Message, Location.Z);
+			AppendFloat(Message, Rotation.Pitch);
+			AppendFloat(Message, Rotation.Yaw);
+			AppendFloat(Message, Rotation.Roll);
+			Connection.Socket->Send(Message.GetData(), Message.Num(), false);
+		}
+		return true;
+	}
+
+	void FWebSocketServer::OnClientConnected(INetworkingWebSocket* Socket)
+	{
+		uint32 ConnectionId = NextConnectionId++;
+		FConnection& Connection = Connections.Add(ConnectionId);
+		Connection.Socket = Socket;
+		Socket->SetReceiveCallBack(FWebSocketPacketRecievedCallBack::CreateStatic(&FWebSocketServer::OnMessage, ConnectionId));
+		Socket->SetSocketClosedCallBack(FWebSocketInfoCallBack::CreateStatic(&FWebSocketServer::OnClientClosed, ConnectionId));
+		UE_LOG(UHttpLog, Verbose, TEXT("WebSocket client connected: %s"), *Socket->RemoteEndPoint(true));
+	}
+
+	void FWebSocketServer::OnClientClosed(uint32 ConnectionId)
+	{
+		Connections.Remove(ConnectionId);
+	}
+
+	void FWebSocketServer::OnMessage(void* Data, int32 Size, uint32 ConnectionId)
+	{
+		FConnection* Connection = Connections.Find(ConnectionId);
+		if (Connection == nullptr || Size < REQUEST_HEADER_BYTES)
+		{
+			return;
+		}
+		const uint8* Bytes = static_cast<const uint8*>(Data);
+		uint8 OpCode = Bytes[0];
+		uint8 Sequence = Bytes[1];
+		const uint8* Payload = Bytes + REQUEST_HEADER_BYTES;
+		int32 PayloadSize = Size - REQUEST_HEADER_BYTES;
+
+		FString ErrorMessage;
+		TArray<uint8> ReplyPayload;
+		switch (OpCode)
+		{
+		case OP_GET_LOCATION:
+		{
+			FUHttpPlayerLocation Location;
+			if (!FPlayerHandler::GetPlayerLocation(Connection->Target, Location, ErrorMessage))
+			{
+				ReplyError(ConnectionId, OpCode, Sequence, ErrorMessage);
+				return;
+			}
+			AppendFloat(ReplyPayload, Location.X);
+			AppendFloat(ReplyPayload, Location.Y);
+			AppendFloat(ReplyPayload, Location.Z);
+			Reply(ConnectionId, OpCode, Sequence, STATUS_OK, ReplyPayload);
+			return;
+		}
+		case OP_GET_ROTATION:
+		{
+			FUHttpPlayerRotation Rotation;
+			if (!FPlayerHandler::GetPlayerRotation(Connection->Target, Rotation, ErrorMessage))
+			{
+				ReplyError(ConnectionId, OpCode, Sequence, ErrorMessage);
+				return;
+			}
+			AppendFloat(ReplyPayload, Rotation.Pitch);
+			AppendFloat(ReplyPayload, Rotation.Yaw);
+			AppendFloat(ReplyPayload, Rotation.Roll);
+			Reply(ConnectionId, OpCode, Sequence, STATUS_OK, ReplyPayload);
+			return;
+		}
+		case OP_SET_LOCATION:
+		{
+			if (PayloadSize != 3 * sizeof(float))
+			{
+				ReplyError(ConnectionId, OpCode, Sequence, TEXT("Invalid location payload!"));
+				return;
+			}
+			FUHttpSetPlayerLocationRequest Request;
+			static_cast<FUHttpPlayerTarget&>(Request) = Connection->Target;
+			Request.X = ReadFloat(Payload);
+			Request.Y = ReadFloat(Payload + 4);
+			Request.Z = ReadFloat(Payload + 8);
+			EnqueueSet<FUHttpSetPlayerLocationRequest>(ConnectionId, OpCode, Sequence, TEXT("/player/set_location|") + FPlayerHandler::GetTargetKey(Request), Request, &FPlayerHandler::SetPlayerLocation);
+			return;
+		}
+		case OP_SET_ROTATION:
+		{
+			if (PayloadSize != 3 * sizeof(float))
+			{
+				ReplyError(ConnectionId, OpCode, Sequence, TEXT("Invalid rotation payload!"));
+				return;
+			}
+			FUHttpSetPlayerRotationRequest Request;
+			static_cast<FUHttpPlayerTarget&>(Request) = Connection->Target;
+			Request.Pitch = ReadFloat(Payload);
+			Request.Yaw = ReadFloat(Payload + 4);
+			Request.Roll = ReadFloat(Payload + 8);
+			EnqueueSet<FUHttpSetPlayerRotationRequest>(ConnectionId, OpCode, Sequence, TEXT("/player/set_rotation|") + FPlayerHandler::GetTargetKey(Request), Request, &FPlayerHandler::SetPlayerRotation);
+			return;
+		}
+		case OP_SUBSCRIBE:
+			Connection->bSubscribed = true;
+			Connection->bPushed = false;
+			Reply(ConnectionId, OpCode, Sequence, STATUS_OK, ReplyPayload);
+			return;
+		case OP_UNSUBSCRIBE:
+			Connection->bSubscribed = false;
+			Reply(ConnectionId, OpCode, Sequence, STATUS_OK, ReplyPayload);
+			return;
+		case OP_SELECT_TARGET:
+		{
+			if (PayloadSize < 1)
+			{
+				ReplyError(ConnectionId, OpCode, Sequence, TEXT("Invalid target payload!"));
+				return;
+			}
+			FUTF8ToTCHAR WorldConverter(reinterpret_cast<const ANSICHAR*>(Payload + 1), PayloadSize - 1);
+			FUHttpPlayerTarget Target;
+			Target.Player = Payload[0];
+			Target.World = FString(WorldConverter.Length(), WorldConverter.Get());
+			FPlayerTarget PlayerTarget;
+			if (!FPlayerService::ParseTarget(Target.World, FString::FromInt(Target.Player), PlayerTarget))
+			{
+				ReplyError(ConnectionId, OpCode, Sequence, TEXT("Invalid player target!"));
+				return;
+			}
+			Connection->Target = Target;
+			Connection->bPushed = false;
+			Reply(ConnectionId, OpCode, Sequence, STATUS_OK, ReplyPayload);
+			return;
+		}
+		default:
+			ReplyError(ConnectionId, OpCode, Sequence, TEXT("Unknown op!"));
+			return;
+		}
+	}
+
+	template <typename TRequest>
+	void FWebSocketServer::EnqueueSet(uint32 ConnectionId, uint8 OpCode, uint8 Sequence, const FString& CoalesceKey, const TRequest& Request,
+		bool (*Responser)(const TRequest&, FUHttpEmpty&, FString&))
+	{
+		bool bEnqueued = FWebUtil::EnqueueCoalescedMutation(CoalesceKey, [ConnectionId, OpCode, Sequence, Request, Responser]()
+		{
+			FUHttpEmpty Response;
+			FString Message;
+			if (!Responser(Request, Response, Message))
+			{
+				ReplyError(ConnectionId, OpCode, Sequence, Message);
+				return;
+			}
+			Reply(ConnectionId, OpCode, Sequence, STATUS_OK, TArray<uint8>());
+		}, [ConnectionId, OpCode, Sequence]()
+		{
+			Reply(ConnectionId, OpCode, Sequence, STATUS_COALESCED, TArray<uint8>());
+		});
+		if (!bEnqueued)
+		{
+			Reply(ConnectionId, OpCode, Sequence, STATUS_BUSY, TArray<uint8>());
+		}
+	}
+
+	void FWebSocketServer::Reply(uint32 ConnectionId, uint8 OpCode, uint8 Sequence, uint8 Status, const TArray<uint8>& Payload)
+	{
+		FConnection* Connection = Connections.Find(ConnectionId);
+		if (Connection == nullptr)
+		{
+			return;
+		}
+		TArray<uint8> Message;
+		Message.Reserve(3 + Payload.Num());
+		Message.Add(OpCode | OP_REPLY_FLAG);
+		Message.Add(Sequence);
+		Message.Add(Status);
+		Message.Append(Payload);
+		Connection->Socket->Send(Message.GetData(), Message.Num(), false);
+	}
+
+	void FWebSocketServer::ReplyError(uint32 ConnectionId, uint8 OpCode, uint8 Sequence, const FString& Message)
+	{
+		FTCHARToUTF8 MessageConverter(*Message, Message.Len());
+		TArray<uint8> Payload;
+		Payload.Append(reinterpret_cast<const uint8*>(MessageConverter.Get()), MessageConverter.Length());
+		Reply(ConnectionId, OpCode, Sequence, STATUS_ERROR, Payload);
+	}
+}
\ No newline at end of file
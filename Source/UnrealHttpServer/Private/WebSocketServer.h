@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Model/PlayerModel.h"
+
+class IWebSocketServer;
+class INetworkingWebSocket;
+
+namespace UnrealHttpServer
+{
+	/**
+	 * WebSocket channel for high-frequency player control, hosted on engine WebSocketNetworking server
+	 * Binary messages, numbers in little endian, seq is echoed in reply:
+	 *   request: [op u8][seq u8][payload]
+	 *     0x01 get location, 0x03 get rotation
+	 *     0x02 set location: [x f32][y f32][z f32], 0x04 set rotation: [pitch f32][yaw f32][roll f32]
+	 *     0x05 subscribe transform, 0x06 unsubscribe
+	 *     0x07 select target: [player u8][world utf8...]
+	 *   reply: [op | 0x80 u8][seq u8][status u8][payload], payload of get is 3 f32, payload of error is utf8 message
+	 *   push: [0x10 u8][frame u32][x y z pitch yaw roll f32], sent on transform change to subscribers
+	 * Writes share frame coalescing & mutation queue with http routes
+	 */
+	class FWebSocketServer
+	{
+	public:
+		/**
+		 * Start listening on port & register ticker
+		 */
+		static bool Start(uint32 Port);
+
+		/**
+		 * Close connections & stop listening
+		 */
+		static void Stop();
+
+	private:
+		enum EOpCode : uint8
+		{
+			OP_GET_LOCATION = 0x01,
+			OP_SET_LOCATION = 0x02,
+			OP_GET_ROTATION = 0x03,
+			OP_SET_ROTATION = 0x04,
+			OP_SUBSCRIBE = 0x05,
+			OP_UNSUBSCRIBE = 0x06,
+			OP_SELECT_TARGET = 0x07,
+			OP_PUSH_TRANSFORM = 0x10,
+			OP_REPLY_FLAG = 0x80,
+		};
+
+		enum EStatus : uint8
+		{
+			STATUS_OK = 0,
+			STATUS_ERROR = 1,
+			/* Write was superseded by a later write in the same frame */
+			STATUS_COALESCED = 2,
+			/* Mutation queue is full */
+			STATUS_BUSY = 3,
+		};
+
+		/**
+		 * Accepted connection
+		 */
+		struct FConnection
+		{
+			INetworkingWebSocket* Socket = nullptr;
+			FUHttpPlayerTarget Target;
+			bool bSubscribed = false;
+			bool bPushed = false;
+			FVector LastLocation = FVector::ZeroVector;
+			FRotator LastRotation = FRotator::ZeroRotator;
+		};
+
+		static TUniquePtr<IWebSocketServer> Server;
+		static TMap<uint32, FConnection> Connections;
+		static uint32 NextConnectionId;
+		static FDelegateHandle TickerHandle;
+
+		/**
+		 * Tick server, then push transform changes to subscribers
+		 */
+		static bool Tick(float DeltaTime);
+
+		static void OnClientConnected(INetworkingWebSocket* Socket);
+
+		static void OnClientClosed(uint32 ConnectionId);
+
+		/**
+		 * Handle a binary message of connection (game thread)
+		 */
+		static void OnMessage(void* Data, int32 Size, uint32 ConnectionId);
+
+		/**
+		 * Apply set command through mutation queue, coalesced with same-frame writes of http routes
+		 */
+		template <typename TRequest>
+		static void EnqueueSet(uint32 ConnectionId, uint8 OpCode, uint8 Sequence, const FString& CoalesceKey, const TRequest& Request,
+			bool (*Responser)(const TRequest&, FUHttpEmpty&, FString&));
+
+		/**
+		 * Send reply to connection if it is still open
+		 */
+		static void Reply(uint32 ConnectionId, uint8 OpCode, uint8 Sequence, uint8 Status, const TArray<uint8>& Payload);
+
+		static void ReplyError(uint32 ConnectionId, uint8 OpCode, uint8 Sequence, const FString& Message);
+	};
+}
\ No newline at end of file
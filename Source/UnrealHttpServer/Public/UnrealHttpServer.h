@@ -6,6 +6,12 @@
 #include "Modules/ModuleManager.h"
 
 
+namespace UnrealHttpServer
+{
+	struct FServerConfig;
+}
+
+
 class FUnrealHttpServerModule : public IModuleInterface
 {
 public:
@@ -13,8 +19,20 @@ public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 
+	/* Bound port of http server, resolved if configured as 0 (ephemeral) */
 	uint32 Port;
 
+	/* Bound port of WebSocket server, resolved if configured as 0 (ephemeral) */
+	uint32 WebSocketPort;
+
 private:
+	/**
+	 * Start http & WebSocket servers, report bound ports into port file if configured
+	 */
+	void StartServers(const UnrealHttpServer::FServerConfig& Config);
+
+	FDelegateHandle PostEngineInitHandle;
+
 	static const uint32 DEFAULT_PORT = 26016;
+	static const uint32 DEFAULT_WEBSOCKET_PORT = 26017;
 };
@@ -41,6 +41,8 @@ public class UnrealHttpServer : ModuleRules
 				// ... add private dependencies that you statically link with here ...
 				"HTTP",
 				"HTTPServer",
+				"Sockets",
+				"WebSocketNetworking",
 				"JsonUtilities",
 				"Json",
 				"UMG",